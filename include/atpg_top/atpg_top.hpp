@@ -35,11 +35,24 @@
 #include <vector>
 #include <tuple>
 #include <array>
+#include <fstream>
+#include <algorithm>
+#include <thread>
 
 #include "../tree/Tree.hpp"
+#include "../tree/CompiledCircuit.hpp"
 #include "../tree/Fault.hpp"
 #include "../tree/FaultDecorator.hpp"
+#include "../tree/PatternSet.hpp"
+#include "../tree/Testability.hpp"
+#include "../tree/LearnedImplications.hpp"
 #include "../reader/reader.hpp"
+#include "../reader/pattern_reader.hpp"
+#include "../simulator/fault_simulator.hpp"
+#include "../simulator/random_pattern_phase.hpp"
+#include "../simulator/three_valued_simulator.hpp"
+#include "../compaction/static_compactor.hpp"
+#include "../compaction/x_fill.hpp"
 #include "../writer/writer_txt.hpp"
 #include "../writer/writer_json.hpp"
 #include "../fault_API/fault_API.hpp"
@@ -60,6 +73,21 @@ class ATPGTop {
         */
         shared_ptr<Tree> tree;
 
+        /**
+         * @brief Shared pointer to the compiled circuit, built from the tree once it has been read
+        */
+        shared_ptr<CompiledCircuit> circuit;
+
+        /**
+         * @brief Shared pointer to the SCOAP measures of the compiled circuit, guiding the deterministic generation
+        */
+        shared_ptr<Testability> testability;
+
+        /**
+         * @brief Shared pointer to the implications learned by the static learning, nullptr if it is disabled
+        */
+        shared_ptr<LearnedImplications> learned_implications;
+
         /**
          * @brief Name of the input file
         */
@@ -90,16 +118,106 @@ class ATPGTop {
         */
         string cov_output_file_ext;
 
+        /**
+         * @brief Name of the vector file to grade, empty to generate the test vectors
+        */
+        string grade_filename;
+
+        /**
+         * @brief Name of the testability report file (SCOAP measures of each net), empty to write no report
+        */
+        string testability_filename;
+
+        /**
+         * @brief Generator of the random patterns simulated before the deterministic generation ("random", "lfsr" or "none")
+        */
+        string random_source;
+
+        /**
+         * @brief Maximum number of random patterns simulated
+        */
+        size_t random_pattern_limit;
+
+        /**
+         * @brief Minimum coverage gain of the random patterns (in percent of the faults per 64 patterns) to go on with the random phase
+        */
+        double random_min_gain;
+
+        /**
+         * @brief Whether the indirect implications of the circuit are learned before the deterministic generation
+        */
+        bool static_learning;
+
+        /**
+         * @brief Depth of the recursive learning of the hard fault phase, 0 to disable the phase
+        */
+        size_t recursive_learning_depth;
+
+        /**
+         * @brief Whether the side inputs of the dominators of each fault get their non-controlling values before the deterministic generation
+        */
+        bool dominator_sensitization;
+
+        /**
+         * @brief Maximum number of decisions of the deterministic generation of a fault before it is aborted, 0 for no limit
+        */
+        size_t decision_limit;
+
+        /**
+         * @brief Maximum time (in seconds) of the deterministic generation of a fault before it is aborted, 0 for no limit
+        */
+        double time_limit;
+
+        /**
+         * @brief Maximum number of secondary faults targeted by each deterministic test vector, 0 to disable the dynamic compaction
+        */
+        size_t dynamic_compaction_limit;
+
+        /**
+         * @brief Maximum number of merged test vectors each test vector is compared to by the static compaction, 0 to disable it
+        */
+        size_t static_compaction_limit;
+
+        /**
+         * @brief Whether the test vectors detecting no new fault when they are fault simulated in reverse order are dropped
+        */
+        bool reverse_order_reduction;
+
+        /**
+         * @brief Fill of the unspecified inputs of the test vectors ("none", "0", "1", "random", "adjacent" or "best")
+        */
+        string x_fill;
+
+        /**
+         * @brief Fault simulation engine of the random pattern phase, the compaction and the grading ("ppsfp", "deductive", "concurrent" or "cpt")
+        */
+        string fault_engine;
+
+        /**
+         * @brief Number of threads of the fault simulation with the PPSFP engine (the number of cores by default)
+        */
+        size_t thread_count;
+
+        /**
+         * @brief Simulation kernel of the logic and fault simulations ("auto", "generic", "avx2", "avx512" or "compiled")
+        */
+        string sim_kernel;
+
+        /**
+         * @brief Simulation kernel of all the simulators of the run, sim_kernel resolved once by initialize() (never KernelType::Auto)
+        */
+        KernelType kernel_type;
+
         /**
          * @brief The list of fault to test in the circuit
          */
         shared_ptr<vector<pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list;
 
         /**
-         * @brief The list of vectors to test the circuit
-         * @brief it is a pair of vectors. The first elem of the pair is a vector that contains pair of input node and the value to test. The second elem of the pair is a vectpr that contains pair of the output node and the expected value
+         * @brief The vectors to test the circuit
+         * @brief The values of the inputs and the expected values of the outputs are in the order of the input and output lists of the tree
          */
-        shared_ptr<vector<pair<vector<pair<shared_ptr<Node>, int>> , vector<pair<shared_ptr<Node>, int>>>>> vectors_test;
+        shared_ptr<PatternSet> vectors_test;
 
         /**
          * @brief Path of the output directory
@@ -140,9 +258,40 @@ class ATPGTop {
         
         /**
          * @brief Method to generate the test vectors
+         * 
+         * Random patterns are fault simulated first, the ones detecting new faults being kept, until their coverage gain 
+         * drops below random_min_gain. The deterministic generation then only targets the faults they don't detect, 
+         * the hardest ones first according to their SCOAP detection cost. With static_learning, the indirect implications 
+         * of the circuit are learned first and used by the generation, and with dominator_sensitization, the side inputs 
+         * of the dominators of each fault get their non-controlling values before its generation. A fault whose generation 
+         * exceeds decision_limit or time_limit is aborted, and targeted again with ten times these limits. The faults in failure 
+         * after a conflict or aborted are then targeted again in a hard fault phase, with the necessary values found by recursive learning.
         */
         void generate_vector();
 
+        /**
+         * @brief Merge the compatible test vectors (no input specified to 0 in one and to 1 in the other)
+         * 
+         * The test vectors are fault simulated before and after the merge, their unspecified inputs set to 0, and the ones 
+         * detecting a fault that the merged vectors miss are kept as they are, so the coverage is unchanged.
+         * Their unspecified inputs are then filled as set by x_fill, and with reverse_order_reduction, the vectors are 
+         * fault simulated in reverse order and the ones detecting no new fault are dropped.
+        */
+        void compact_vector();
+
+        /**
+         * @brief Fault simulate the patterns of the vector file to grade, instead of generating the test vectors
+         * 
+         * The faults which are not detected by any pattern are set as failures, "ob" if they are not observable, "nd" otherwise.
+        */
+        void grade_vector();
+
+        /**
+         * @brief Write the SCOAP measures of each net into the testability report file
+         * 
+        */
+        void write_testability();
+
         /**
          * @brief Write the generated test vectors into the output file and format it
          * 
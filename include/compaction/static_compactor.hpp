@@ -0,0 +1,138 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file static_compactor.hpp
+ * @brief Definition of the StaticCompactor class, the compaction of a test set by merging its compatible cubes
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "../tree/PatternSet.hpp"
+#include "../simulator/fault_simulator.hpp"
+#include "../simulator/three_valued_simulator.hpp"
+
+/**
+ * @class StaticCompactor
+ * @brief Merges the pairwise compatible test cubes of a pattern set, then checks by fault simulation that the coverage is unchanged.
+ * 
+ * The cubes are the inputs of the patterns of a PatternSet, stored on two rails of 64 inputs per word: two cubes are 
+ * compatible if no input is 0 in one and 1 in the other, which is checked a word at a time. The outputs of the compacted 
+ * patterns are unspecified, they must be simulated again.
+ * 
+ * The fully specified patterns are fault simulated with the bit-parallel fault simulator. As soon as an input of the 
+ * set is unspecified, the cubes are fault simulated one at a time in three-valued logic, a fault being detected only 
+ * whatever the values of the unspecified inputs: the coverage is then kept for the cubes themselves, not for one fill.
+ */
+class StaticCompactor {
+public:
+    /**
+     * @brief Constructor of the StaticCompactor class.
+     * 
+     * @param circuit The compiled circuit
+     * @param type The instruction set of the simulation kernel of the fault simulation
+     * @param engine The fault simulation engine
+     * @param thread_count The number of threads propagating the faults with the PPSFP engine
+     */
+    StaticCompactor(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, FaultSimulationEngine engine = FaultSimulationEngine::PPSFP, size_t thread_count = 1);
+
+    /**
+     * @brief Merges the compatible cubes greedily.
+     * 
+     * The cubes are taken by decreasing number of specified inputs, and each one is merged into the first compatible cube 
+     * among the search_limit last merged cubes, or starts a new one. The cost is linear in the number of cubes, 
+     * so that millions of cubes can be merged.
+     * 
+     * @param patterns The patterns to merge
+     * @param search_limit The maximum number of merged cubes a cube is compared to
+     * @return The number of patterns after the merge
+     */
+    size_t merge(PatternSet& patterns, size_t search_limit = 1024);
+
+    /**
+     * @brief Merges the compatible cubes, keeping the coverage of the pattern set.
+     * 
+     * The original and the merged cubes are fault simulated (see detect()): the original cubes detecting a fault that 
+     * the merged ones don't detect are added back to the pattern set.
+     * 
+     * @param patterns The patterns to compact
+     * @param faults The faults detected by the patterns
+     * @param search_limit The maximum number of merged cubes a cube is compared to
+     * @return The number of patterns after the compaction
+     */
+    size_t compact(PatternSet& patterns, const std::vector<StuckAtFault>& faults, size_t search_limit = 1024);
+
+    /**
+     * @brief Drops the patterns that detect no new fault when the pattern set is fault simulated in reverse order.
+     * 
+     * The first patterns of a set are often made redundant by the later ones, which target the remaining faults. 
+     * Each fault detected by the pattern set is detected by a kept pattern (see detect()), so the coverage is unchanged.
+     * 
+     * @param patterns The patterns to reduce
+     * @param faults The faults detected by the patterns
+     * @return The number of patterns after the reduction
+     */
+    size_t reduce(PatternSet& patterns, const std::vector<StuckAtFault>& faults);
+
+    /**
+     * @brief Fault simulates the patterns of a set, in three-valued logic if one of their inputs is unspecified.
+     * 
+     * @param patterns The patterns to simulate
+     * @param faults The faults to simulate
+     * @param first_detection The index of the first pattern that detects each fault, -1 if not detected yet
+     * @return The number of faults detected
+     */
+    size_t detect(const PatternSet& patterns, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection);
+
+private:
+    /**
+     * @brief Fault simulates some patterns of a set, in three-valued logic if one of their inputs is unspecified.
+     * 
+     * @param patterns The pattern set
+     * @param order The indexes of the patterns to simulate, in the order of the simulation
+     * @param faults The faults to simulate
+     * @param first_detection The position in order of the first pattern that detects each fault, -1 if not detected yet
+     * @return The number of faults detected
+     */
+    size_t detect(const PatternSet& patterns, const std::vector<size_t>& order, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection);
+
+    /**
+     * @brief Fault simulates some cubes of a set one at a time, in three-valued logic, the detected faults being dropped.
+     * 
+     * @param patterns The pattern set
+     * @param order The indexes of the cubes to simulate, in the order of the simulation
+     * @param faults The faults to simulate
+     * @param first_detection The position in order of the first cube that detects each fault, -1 if not detected yet
+     * @return The number of faults detected
+     */
+    size_t detectCubes(const PatternSet& patterns, const std::vector<size_t>& order, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection);
+
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    FaultSimulator simulator;
+
+    ThreeValuedSimulator cubeSimulator;
+};
@@ -0,0 +1,137 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file x_fill.hpp
+ * @brief Definition of the XFill class, the filling of the unspecified inputs of a test set
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../tree/PatternSet.hpp"
+#include "../simulator/fault_simulator.hpp"
+
+/**
+ * @enum FillMode
+ * @brief Values given to the unspecified inputs of the test vectors.
+ */
+enum class FillMode {
+    None,     /**< The inputs stay unspecified (X). */
+    Zero,     /**< 0-fill. */
+    One,      /**< 1-fill. */
+    Random,   /**< Pseudo-random values, which detect more faults fortuitously. */
+    Adjacent, /**< Value of the previous specified input of the vector (minimum transition fill), for a low shift power. */
+    Best      /**< The fill (0, 1, random or adjacent) detecting the most faults, then with the fewest toggles. */
+};
+
+/**
+ * @struct FillScore
+ * @brief Score of a filled test set.
+ */
+struct FillScore {
+    /**
+     * @brief Number of faults detected by the test set.
+     */
+    size_t detected;
+
+    /**
+     * @brief Number of transitions between adjacent inputs of each vector, as shifted into a scan chain in the order of the inputs.
+     */
+    size_t toggles;
+};
+
+/**
+ * @class XFill
+ * @brief Fills the unspecified inputs of a pattern set, and scores the fills by fault simulation and toggle count.
+ * 
+ * The fills work on the rails of the inputs of each pattern, 64 inputs at a time.
+ */
+class XFill {
+public:
+    /**
+     * @brief Get the fill mode from its name ("none", "0", "1", "random", "adjacent" or "best").
+     * 
+     * @param name The name of the fill mode
+     * @param mode The fill mode, set if the name is known
+     * @return false if the name is unknown
+     */
+    static bool getMode(const std::string& name, FillMode& mode);
+
+    /**
+     * @brief Get the name of a fill mode.
+     */
+    static std::string getName(FillMode mode);
+
+    /**
+     * @brief Constructor of the XFill class.
+     * 
+     * @param circuit The compiled circuit
+     * @param type The instruction set of the simulation kernel of the fault simulation
+     * @param engine The fault simulation engine
+     * @param thread_count The number of threads propagating the faults with the PPSFP engine
+     * @param seed The seed of the random fill
+     */
+    XFill(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, FaultSimulationEngine engine = FaultSimulationEngine::PPSFP, size_t thread_count = 1, uint64_t seed = 1);
+
+    /**
+     * @brief Fills the unspecified inputs of a pattern set.
+     * 
+     * @param patterns The patterns to fill
+     * @param mode The fill mode, FillMode::Best being handled by fillBest()
+     */
+    void fill(PatternSet& patterns, FillMode mode);
+
+    /**
+     * @brief Fills the unspecified inputs of a pattern set with the best scored fill.
+     * 
+     * The 0, 1, random and adjacent fills are scored: the fill detecting the most faults is kept, the one with the fewest toggles on a tie.
+     * 
+     * @param patterns The patterns to fill
+     * @param faults The faults to simulate
+     * @return The kept fill mode
+     */
+    FillMode fillBest(PatternSet& patterns, const std::vector<StuckAtFault>& faults);
+
+    /**
+     * @brief Scores a pattern set by fault simulation, its unspecified inputs being set to 0, and by toggle count.
+     * 
+     * @param patterns The patterns to score
+     * @param faults The faults to simulate
+     * @return The score of the pattern set
+     */
+    FillScore score(const PatternSet& patterns, const std::vector<StuckAtFault>& faults);
+
+    /**
+     * @brief Counts the transitions between adjacent inputs of each pattern, the unspecified inputs being set to 0.
+     */
+    static size_t countToggles(const PatternSet& patterns);
+
+private:
+    FaultSimulator simulator;
+
+    uint64_t seed;
+};
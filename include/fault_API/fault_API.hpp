@@ -32,6 +32,12 @@
 #include <string>
 #include "../tree/Node.hpp"
 #include "../tree/Tree.hpp"
+#include "../tree/CompiledCircuit.hpp"
+#include "../tree/Testability.hpp"
+#include "../tree/LearnedImplications.hpp"
+#include "../tree/RecursiveLearning.hpp"
+#include "../simulator/fault_simulator.hpp"
+#include "../simulator/three_valued_simulator.hpp"
 #include "../tree/Yosys/BinaryCell.hpp"
 #include "../tree/Cell.hpp"
 #include "../tree/Yosys/ComplexCell.hpp"
@@ -51,6 +57,43 @@ using namespace Unarycell;
  * @brief Namespace providing functions related to fault computation and error generation.
  */
 namespace FaultAPI {
+
+    /**
+     * @struct DecisionContext
+     * @brief Analyses of the circuit guiding the generation of the test vectors, each one being optional.
+     */
+    struct DecisionContext {
+        /**
+         * @brief SCOAP measures choosing the optional assignments and the propagation branches.
+         */
+        std::shared_ptr<const Testability> testability;
+
+        /**
+         * @brief Implications learned before the generation, added to the mandatory list when a node gets its value.
+         */
+        std::shared_ptr<const LearnedImplications> implications;
+
+        /**
+         * @brief Compiled circuit whose dominators give the side input values added to the mandatory list with the fault (see CompiledCircuit::getSideInputValues()).
+         */
+        std::shared_ptr<const CompiledCircuit> dominators;
+    };
+
+    /**
+     * @struct EffortLimit
+     * @brief Limits of the effort spent to generate the test vector of one fault, 0 for no limit.
+     */
+    struct EffortLimit {
+        /**
+         * @brief Maximum number of decisions, the elements of the optional list computed.
+         */
+        size_t decisions = 0;
+
+        /**
+         * @brief Maximum wall-clock time, in seconds.
+         */
+        double seconds = 0;
+    };
     
     /**
      * @brief Computes the value of a node based on input vectors.
@@ -80,36 +123,107 @@ namespace FaultAPI {
      */
     std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>>, std::vector<std::pair<shared_ptr<Node>, int>>>> generate_vector_error(std::shared_ptr<std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list, shared_ptr<Tree> tree);
 
+    /**
+     * @brief Keeps the propagation of the fault effect on the most observable branch sent by a node to its children (D-frontier selection).
+     * 
+     * The other branches still get the value, without having to propagate it.
+     * @param node The node whose computation appended the entries.
+     * @param mandatory The mandatory list.
+     * @param first The position of the first entry appended by the node.
+     * @param testability The SCOAP measures of the circuit.
+     */
+    void selectPropagationBranch(std::shared_ptr<Node> node, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, size_t first, const Testability& testability);
+
     /**
      * @brief Computes all the mandatory list by calling the function compteMandatory for each node.
+     * 
+     * With the SCOAP measures, the propagation branch is selected (see selectPropagationBranch()), and with the learned implications, 
+     * the values they imply are added to the mandatory list each time the output of a node gets its value.
      * @param mandatory A vector that contains the node that must be compute.
      * @param optional A vector that contains the node that will be compute once the mandatory list is computed.
+     * @param context The analyses of the circuit, nullptr to use none.
      * @return True if the mandatory list is computed without creating a conflict. False otherwise : means the error can not be tested
      */
-    bool computeMandatoryList(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional);
+    bool computeMandatoryList(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional, const DecisionContext* context = nullptr);
 
     /**
-     * @brief Computes all the mandatory list by calling the function compteMandatory for each node.
+     * @brief Computes the first element of the optional list.
+     * 
+     * With the SCOAP measures, the element whose value is the easiest to set is computed first instead, and it is dropped 
+     * if the values of the inputs of its cell already imply the value of its output.
      * @param mandatory A vector that contains the node that must be compute.
      * @param optional A vector that contains the node that will be compute once the mandatory list is computed.
+     * @param context The analyses of the circuit, the optional list being computed in order without the SCOAP measures.
      * @return True if it is working. False otherwise. 
      */
-    bool computeOptionalFirstElem(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional);
+    bool computeOptionalFirstElem(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional, const DecisionContext* context = nullptr);
 
     /**
      * @brief Computes one test vector.
+     * 
+     * With the dominators of the faulty node, the side inputs of the dominators get their non-controlling values in the mandatory list 
+     * right after the fault, as every path of the fault effect to the primary outputs goes through these dominators.
      * @param fault A pair containing a fault and the node where he fault must be tested.
      * @param tree the tree representing the circuit.
      * @param success a boolean that indicates if the error has been generated or if there is a conflict.
+     * @param context the analyses of the circuit guiding the decisions, nullptr to use none.
+     * @param necessary assignments added to the mandatory list after the fault, such as the values found by recursive learning, nullptr for none.
+     * @param limit the limits of the effort, the generation being aborted (success set to false) once one is exceeded, nullptr for none.
+     * @param aborted set to true if the generation is aborted, nullptr to ignore it.
      * @return a pair of vector. One is representinf the value for the input, the other the value for the output 
      */
-    std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> generateOneVector(std::pair<shared_ptr<Fault>, shared_ptr<Node>>& fault, shared_ptr<Tree> tree, bool& success);
+    std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> generateOneVector(std::pair<shared_ptr<Fault>, shared_ptr<Node>>& fault, shared_ptr<Tree> tree, bool& success, const DecisionContext* context = nullptr, const std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>* necessary = nullptr, const EffortLimit* limit = nullptr, bool* aborted = nullptr);
+
+    /**
+     * @brief Saves the port values of all the nodes of the tree.
+     * @param tree the tree representing the circuit.
+     * @param saved set to the port values of the nodes, in the order of the node list.
+     */
+    void savePortValues(shared_ptr<Tree> tree, std::vector<std::tuple<int, int, bool>>& saved);
+
+    /**
+     * @brief Restores the port values of all the nodes of the tree saved by savePortValues().
+     * @param tree the tree representing the circuit.
+     * @param saved the port values of the nodes, in the order of the node list.
+     */
+    void restorePortValues(shared_ptr<Tree> tree, const std::vector<std::tuple<int, int, bool>>& saved);
 
     /**
      * @brief function that generate all the test vector for a fault model.
+     * 
+     * With dynamic compaction, once the vector of a fault (the primary fault) is found, the next faults of the list (the secondary faults) 
+     * are targeted under the values of this vector, as long as some inputs are unspecified, the values of the tree being restored 
+     * after a conflict. The secondary faults which don't conflict are tested by the same vector if its three-valued fault simulation 
+     * confirms that it detects them whatever the values of its unspecified inputs, and are targeted again later otherwise.
+     * 
+     * A fault whose generation exceeds the effort limit is aborted, in failure with the "ab" reason, so it can be targeted again 
+     * with another effort or another method.
+     * 
+     * @param fault_list a shared_ptr on a vector of tuple of the fault and the node where the fault must be tested
+     * @param tree the tree representing the circuit.
+     * @param circuit the compiled circuit, used to reject the faults that can't reach any output before running the generation.
+     * @param compaction_limit the maximum number of secondary faults targeted by a vector, 0 to disable the dynamic compaction.
+     * @param context the analyses of the circuit guiding the decisions (see generateOneVector()), nullptr to use none.
+     * @param limit the limits of the effort spent on each fault, nullptr for none.
+     * @return the vector contains the tests vectors. 
+     */
+    std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> generateVectorError(std::shared_ptr<std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list, shared_ptr<Tree> tree, shared_ptr<const CompiledCircuit> circuit, size_t compaction_limit = 0, const DecisionContext* context = nullptr, const EffortLimit* limit = nullptr);
+
+    /**
+     * @brief function that generate the test vectors of the hard faults: the faults in failure after a conflict ("co") or aborted ("ab").
+     * 
+     * The values necessary to the test of each fault are found by recursive learning on the compiled circuit, from the value 
+     * of the faulty node and the side input values of its dominators if they are used by the context, and added to the mandatory list before the generation. The vector is only kept if its fault 
+     * simulation (unspecified inputs set to 0) confirms that it detects the fault, whose failure is then cleared. A fault whose necessary 
+     * values conflict or whose generation fails on a conflict is set in failure with the "co" reason, and an aborted one keeps its reason.
+     * 
      * @param fault_list a shared_ptr on a vector of tuple of the fault and the node where the fault must be tested
      * @param tree the tree representing the circuit.
+     * @param circuit the compiled circuit.
+     * @param depth the depth of the recursive learning, at least 1.
+     * @param context the analyses of the circuit guiding the decisions (see generateOneVector()), nullptr to use none.
+     * @param limit the limits of the effort spent on the generation of each fault, nullptr for none.
      * @return the vector contains the tests vectors. 
      */
-    std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> generateVectorError(std::shared_ptr<std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list, shared_ptr<Tree> tree);
+    std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> generateHardFaultVectors(std::shared_ptr<std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list, shared_ptr<Tree> tree, shared_ptr<const CompiledCircuit> circuit, size_t depth, const DecisionContext* context = nullptr, const EffortLimit* limit = nullptr);
 }
@@ -59,8 +59,9 @@ public:
 
     /**
      * @brief Vector of all the gate input bits and their corresponding input port
+     * @note A bit can be connected to several ports of the gate
     */
-    std::map<uint, std::string> in;
+    std::multimap<uint, std::string> in;
 
     /**
      * @brief Gate output bit
@@ -0,0 +1,131 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file module_definition.hpp
+ * @brief Definition of the ModuleDefinition class, and of the ports and instances it is made of.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "gate.hpp"
+
+/**
+ * @class Port
+ * @brief Port of a module definition
+*/
+class Port {
+public:
+    /**
+     * @brief Name of the port
+    */
+    std::string name;
+
+    /**
+     * @brief Direction of the port ("input" or "output")
+    */
+    std::string direction;
+
+    /**
+     * @brief Bits of the port, least significant bit first
+    */
+    std::vector<uint> bits;
+};
+
+/**
+ * @class Instance
+ * @brief Instance of a module inside another module
+*/
+class Instance {
+public:
+    /**
+     * @brief Name of the instance in the netlist
+    */
+    std::string name;
+
+    /**
+     * @brief Name of the instanciated module
+    */
+    std::string module;
+
+    /**
+     * @brief Bits of the parent module connected to each port of the instance, least significant bit first
+    */
+    std::map<std::string, std::vector<uint>> connections;
+};
+
+/**
+ * @class ModuleDefinition
+ * @brief Holding the content of one module of the netlist at parse time
+ * @note A module is parsed once, whatever the number of its instances. The bits are numbered locally to the module.
+*/
+class ModuleDefinition {
+public:
+    /**
+     * @brief Name of the module
+    */
+    std::string name;
+
+    /**
+     * @brief True if the module is marked as the top-level module in the netlist
+    */
+    bool top = false;
+
+    /**
+     * @brief Ports of the module, in definition order
+    */
+    std::vector<Port> ports;
+
+    /**
+     * @brief Basic cells of the module
+    */
+    std::vector<Gate> cells;
+
+    /**
+     * @brief Instances of other modules inside this module
+    */
+    std::vector<Instance> instances;
+
+    /**
+     * @brief Name of each named net (bit) of the module
+    */
+    std::map<uint, std::string> nets;
+
+    /**
+     * @brief Default constructor of the ModuleDefinition
+     * 
+     * @param _name The name of the module
+    */
+    ModuleDefinition(const std::string& _name);
+
+    /**
+     * @brief Get the number of bit indexes used by the module
+     * 
+     * @return The largest bit index of the module plus one
+    */
+    uint getBitCount() const;
+};
@@ -0,0 +1,143 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file module_model.hpp
+ * @brief Definition of the ModuleModel class, the elaborated model of a module definition shared by all its instances.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "module_definition.hpp"
+
+class ModuleModel;
+
+/**
+ * @enum CellCategory
+ * @brief Vector of the ParsedCircuit in which a basic cell is stored.
+ */
+enum class CellCategory {
+    Memory,
+    Unary,
+    Binary,
+    Complex
+};
+
+/**
+ * @class ModelCell
+ * @brief Basic cell of a module model
+*/
+class ModelCell {
+public:
+    /**
+     * @brief The cell, with the bits of the module and its index in the module as ID
+    */
+    Gate gate;
+
+    /**
+     * @brief Input ports of the cell sorted by name, with their bit
+    */
+    std::vector<std::pair<std::string, uint>> inputs;
+
+    /**
+     * @brief Category of the cell
+    */
+    CellCategory category;
+
+    /**
+     * @brief Default constructor of the ModelCell, sorting the inputs and finding the category of the cell
+     * 
+     * @param _gate The cell of the module definition
+    */
+    ModelCell(const Gate& _gate);
+};
+
+/**
+ * @class ModelInstance
+ * @brief Instance of a module inside a module model, referring to the model of the instanciated module
+*/
+class ModelInstance {
+public:
+    /**
+     * @brief Name of the instance in the netlist
+    */
+    std::string name;
+
+    /**
+     * @brief Model of the instanciated module, shared by all its instances
+    */
+    std::shared_ptr<const ModuleModel> model;
+
+    /**
+     * @brief Bits of the instanciated module connected to a bit of the parent module, as (child bit, parent bit) pairs
+    */
+    std::vector<std::pair<uint, uint>> bits;
+};
+
+/**
+ * @class ModuleModel
+ * @brief Elaborated model of a module definition, built once and shared by all the instances of the module
+ * 
+ * The connections of the sub-instances are checked and resolved to bits, the inputs of the cells are sorted and the cells 
+ * are put in their category when the model is built, so instanciating the module only offsets the bits and the IDs of the model.
+ * Passes working per module can key their results on the model.
+*/
+class ModuleModel {
+public:
+    /**
+     * @brief Definition of the module
+    */
+    std::shared_ptr<const ModuleDefinition> definition;
+
+    /**
+     * @brief Basic cells of the module, in definition order
+    */
+    std::vector<ModelCell> cells;
+
+    /**
+     * @brief Instances of other modules inside this module, in definition order
+    */
+    std::vector<ModelInstance> instances;
+
+    /**
+     * @brief Number of bit indexes used by the module itself (see ModuleDefinition::getBitCount())
+    */
+    uint bit_count;
+
+    /**
+     * @brief Number of basic cells of an instance of the module, sub-instances included
+    */
+    size_t gate_count;
+
+    /**
+     * @brief Default constructor of the ModuleModel
+     * 
+     * @param _definition The definition of the module
+    */
+    ModuleModel(std::shared_ptr<const ModuleDefinition> _definition);
+};
@@ -35,10 +35,13 @@
 #include <regex>
 #include <cstdlib>
 #include <iostream>
+#include <memory>
 
 #include <nlohmann/json.hpp>
 
 #include "gate.hpp"
+#include "module_definition.hpp"
+#include "module_model.hpp"
 
 // For convenience
 using string = std::string;
@@ -110,6 +113,22 @@ public:
     */
     std::vector<std::tuple<size_t, size_t, uint, std::string>> direct_port_pair_mapping;
 
+    /**
+     * @brief Definition of every module of the netlist, shared by all the instances of the module
+    */
+    std::map<std::string, std::shared_ptr<const ModuleDefinition>> module_definitions;
+
+    /**
+     * @brief Model of every module of the netlist, built once and shared by all the instances of the module
+    */
+    std::map<std::string, std::shared_ptr<const ModuleModel>> module_models;
+
+    /**
+     * @brief Hierarchical name and module model of every module instance of the circuit
+     * @note The gates of an instance have their netlist name prefixed by the hierarchical name of the instance
+    */
+    std::vector<std::pair<std::string, std::shared_ptr<const ModuleModel>>> instance_vector;
+
     /**
      * @brief Default constructor of the ParsedCircuit
     */
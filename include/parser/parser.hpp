@@ -28,7 +28,11 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
+
 #include "parsed_circuit.hpp"
+#include "yosys_gate_level_cells.hpp"
 #include "../utils/ANSI.hpp"
 
 /**
@@ -47,6 +51,62 @@ class Parser {
          */
         json strings;
 
+        /**
+         * @brief Flatten the module definitions of a netlist into a single circuit.
+         *
+         * A model is built once for each module definition (see ModuleModel), and the instances of the module refer to it.
+         * The top-level module is the one marked as top, or else the module which is not instanciated by any other one.
+         * If several top-level modules are found, they are all elaborated side by side with a warning.
+         * The circuit model tree works on a flat graph, so each instance gets its own gates, stamped from the model of its module.
+         * The bits of the first top-level module keep their index, the other bits are renumbered.
+         * 
+         * @param modules The definition of every module of the netlist, by name
+         * @return ParsedCircuit object containing the flattened circuit and the module models.
+         */
+        ParsedCircuit elaborate(const std::map<std::string, std::shared_ptr<const ModuleDefinition>>& modules);
+
+    private:
+        /**
+         * @brief Add a top-level module to the flattened circuit: its ports become the inputs and outputs of the circuit
+         * 
+         * @param top The definition of the top-level module
+         * @param netlist The flattened circuit under construction, holding the module models
+         * @param next_bit The first free bit index of the flattened circuit
+         * @param gate_index The number of gates created so far, used to compute unique gate IDs
+         */
+        void addTop(const ModuleDefinition& top, ParsedCircuit& netlist, uint& next_bit, uint& gate_index);
+
+        /**
+         * @brief Connect the gates of the flattened circuit, from the bits their ports are mapped to
+         * 
+         * @param netlist The flattened circuit
+         */
+        void connect(ParsedCircuit& netlist);
+
+        /**
+         * @brief Build the model of a module definition, and recursively the models of the modules it instanciates, if not built yet
+         * 
+         * The connections of the instances are checked here, once per module definition.
+         * 
+         * @param name The name of the module
+         * @param netlist The circuit under construction, holding the module definitions and the models already built
+         * @param stack The modules whose model is being built, used to detect recursive definitions
+         * @return The model of the module
+         */
+        std::shared_ptr<const ModuleModel> buildModel(const std::string& name, ParsedCircuit& netlist, std::vector<std::string>& stack);
+
+        /**
+         * @brief Add the gates of a module instance, and recursively of its sub-instances, to the flattened circuit
+         * 
+         * @param model The model of the instanciated module
+         * @param path The hierarchical name of the instance, empty for a top-level module
+         * @param bits The bit of the flattened circuit of each bit of the module
+         * @param netlist The flattened circuit under construction
+         * @param next_bit The first free bit index of the flattened circuit
+         * @param gate_index The number of gates created so far, used to compute unique gate IDs
+         */
+        void instantiate(const ModuleModel& model, const std::string& path, const std::vector<uint>& bits, ParsedCircuit& netlist, uint& next_bit, uint& gate_index);
+
     public:
         /**
          * @brief Default constructor for Parser
@@ -62,6 +122,19 @@ class Parser {
          */
         virtual ParsedCircuit parseCircuit() = 0;
 
+        /**
+         * @brief Elaborate a module of a parsed netlist on its own, as if it was the top-level module
+         * 
+         * The passes working per module (see LearnedImplications) run once on this circuit, whatever the number of instances 
+         * of the module: the gates of each instance have the netlist name of the matching gate of this circuit, prefixed by 
+         * the hierarchical name of the instance.
+         * 
+         * @param netlist The parsed netlist, holding the module definitions and models
+         * @param name The name of the module
+         * @return ParsedCircuit object containing the flattened module
+         */
+        ParsedCircuit elaborateModule(const ParsedCircuit& netlist, const std::string& name);
+
         /**
          * @brief Pure virtual method to set the content of the input file inside the inputFileContent member
          * 
@@ -0,0 +1,204 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+/**
+ * @file verilog_parser.hpp
+ * @brief Definition of the VerilogParser class.
+ */
+
+#pragma once
+
+#include <string_view>
+#include <unordered_map>
+
+#include "parser.hpp"
+#include "yosys_gate_level_cells.hpp"
+
+using namespace YosysBasicGateLevelCells;
+
+/**
+ * @class VerilogParser
+ * @brief Concrete class representing a parser for structural gate-level Verilog, inheriting from @link Parser @endlink.
+ *
+ * The parser reads modules made of Verilog primitives (and, nand, or, nor, xor, xnor, buf, not),
+ * Yosys internal cells (\$_AND_, \$_MUX_, ...) and instances of the other modules of the file, as written by `write_verilog -noattr`.
+ * The whole file is read in a single pass, without regular expressions nor intermediate token list.
+ * Each module is read once into a @link ModuleDefinition @endlink, and the hierarchy is flattened at elaboration.
+ */
+class VerilogParser : public Parser {
+    public:
+        /**
+         * @brief Default constructor for the VerilogParser class.
+         */
+        VerilogParser(json _strings);
+
+        /**
+         * @brief Overriden method to set the content of the input file inside the inputFileContent member
+         * 
+         * @param _inputFileContent The content of the input Verilog file.
+        */
+        void setInputFileContent(std::string _inputFileContent) override;
+
+        /**
+         * @brief Overridden method to parse a structural Verilog netlist.
+         *
+         * This function parses the content of the Verilog file contained in the @link inputFileContent @endlink member and returns a ParsedCircuit object.
+         * 
+         * @return ParsedCircuit object containing parsed information about the circuit.
+         */
+        ParsedCircuit parseCircuit() override;
+
+    private:
+        /**
+         * @brief Current reading position in the input file content
+         */
+        size_t pos = 0;
+
+        /**
+         * @brief Current line number, used for error messages
+         */
+        uint line = 1;
+
+        /**
+         * @brief Definition of the module being read
+         */
+        std::shared_ptr<ModuleDefinition> module;
+
+        /**
+         * @brief Index of each net (bit) of the current module, by name
+         */
+        std::unordered_map<std::string, uint> netIndex;
+
+        /**
+         * @brief Width and lowest bit index of each declared vector net
+         */
+        std::unordered_map<std::string, std::pair<int, int>> vectorRange;
+
+        /**
+         * @brief Union-find parent of each net, used to merge nets aliased with an 'assign' statement
+         */
+        std::vector<uint> aliasParent;
+
+        /**
+         * @brief Number of primitive instances read so far, used to name unnamed primitives
+         */
+        uint primitive_index = 0;
+
+        /**
+         * @brief Number of intermediate nets created to decompose multiple input primitives
+         */
+        uint internal_net_index = 0;
+
+        /**
+         * @brief Skip blanks, comments and attributes
+         */
+        void skipBlank();
+
+        /**
+         * @brief Read the next identifier (simple or escaped)
+         * 
+         * @return A view on the identifier, empty if there is none
+         */
+        std::string_view readIdentifier();
+
+        /**
+         * @brief Consume the expected punctuation character or exit with an error
+         * 
+         * @param c The expected character
+         */
+        void expect(char c);
+
+        /**
+         * @brief Consume the punctuation character if it is the next one
+         * 
+         * @param c The character to look for
+         * @return true if the character has been consumed
+         */
+        bool accept(char c);
+
+        /**
+         * @brief Read an optional '[msb:lsb]' range
+         * 
+         * @return The pair (msb, lsb), or (-1, -1) if there is no range
+         */
+        std::pair<int, int> readRange();
+
+        /**
+         * @brief Read a net reference ('name', 'name[i]' or 'name[msb:lsb]') and return its net indexes
+         * 
+         * @return The net indexes, least significant bit first
+         */
+        std::vector<uint> readNetBits();
+
+        /**
+         * @brief Read a single bit net reference ('name' or 'name[i]') and return its net index
+         */
+        uint readNet();
+
+        /**
+         * @brief Get the index of a net from its name, creating it if needed
+         */
+        uint getNet(const std::string& name);
+
+        /**
+         * @brief Get the representative net of an aliased net
+         */
+        uint findAlias(uint net);
+
+        /**
+         * @brief Parse a port, wire or reg declaration and fill the port list of the current module
+         * 
+         * @param direction "input", "output" or "wire"
+         * @param ansi true if the declaration is part of an ANSI module header (ends with ',' or ')')
+         */
+        void parseDeclaration(std::string_view direction, bool ansi);
+
+        /**
+         * @brief Parse a Verilog primitive instance (and, or, not, ...)
+         */
+        void parsePrimitive(std::string_view type);
+
+        /**
+         * @brief Parse an instance of a Yosys cell or of a module, with named connections
+         */
+        void parseCellInstance(std::string_view type);
+
+        /**
+         * @brief Resolve the aliases of the current module once it has been read
+         */
+        void endModule();
+
+        /**
+         * @brief Check that every net of a module is driven by one and only one gate, port or instance
+         * 
+         * @param definition The module to check
+         * @param modules The definition of every module of the netlist, to know the direction of the instance ports
+         */
+        void checkDrivers(const ModuleDefinition& definition, const std::map<std::string, std::shared_ptr<const ModuleDefinition>>& modules);
+
+        /**
+         * @brief Print a parsing error with the current line number and exit
+         */
+        [[noreturn]] void error(const std::string& message);
+};
@@ -68,10 +68,24 @@ namespace YosysBasicGateLevelCells {
         "$_AOI4_",
         "$_OAI4_",
         "$_MUX_",
-        "$_NMUX",
+        "$_NMUX_",
         "$_MUX4_",
         "$_MUX8_",
         "$_MUX16_",
         "$_TBUF_"
     };
+
+    /**
+     * @brief Check if a cell type is a memory cell (flip-flop, latch ...).
+    */
+    inline bool isMemoryCell(const std::string& type) {
+        return type.rfind("$_DFF", 0) == 0 || type.rfind("$_SDFF", 0) == 0 || type.rfind("$_DLATCH", 0) == 0 || type.rfind("$_SR", 0) == 0;
+    }
+
+    /**
+     * @brief Check if a cell type is a basic cell, as opposed to an instance of a user-defined module.
+    */
+    inline bool isBasicCell(const std::string& type) {
+        return isMemoryCell(type) || unaryCells.count(type) || binaryCells.count(type) || complexCells.count(type);
+    }
 } // namespace BasicGateLevelCells
\ No newline at end of file
@@ -0,0 +1,162 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file pattern_reader.hpp
+ * @brief Definition of the PatternReader class, reading the test patterns of a vector file to grade them
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "../tree/CompiledCircuit.hpp"
+#include "../tree/PatternSet.hpp"
+
+/**
+ * @class PatternReader
+ * @brief Reads the test patterns of a vector file, as values of the primary inputs of a compiled circuit.
+ * 
+ * Three formats are supported:
+ * - the text format written by WriterTXT: each "Vector nb.<n>" line is followed by the "<name> : <value> ;" bits of the vector,
+ * - the JSON format written by WriterJSON: the "Input_bits" of each vector of "Vectors",
+ * - a bit matrix: one pattern per line, one character per primary input ('0', '1', or 'X' for an unassigned input), 
+ * in the order of the input list of the circuit. Blanks are ignored and the lines starting with '#' are comments.
+ * 
+ * The output bits of the vector files are ignored, the expected values being the ones of the simulated circuit.
+ * The unassigned inputs (-1 or 'X') are kept unspecified in the pattern set, and set to 0 in the blocks given to the simulators.
+ */
+class PatternReader {
+public:
+    /**
+     * @enum Format
+     * @brief Formats of the vector files.
+     */
+    enum class Format {
+        Text,     /**< Text format written by WriterTXT. */
+        JSON,     /**< JSON format written by WriterJSON. */
+        BitMatrix /**< One line of input values per pattern. */
+    };
+
+    /**
+     * @brief Constructor of the PatternReader class
+     * 
+     * @param circuit The compiled circuit whose primary inputs are read
+     */
+    explicit PatternReader(std::shared_ptr<const CompiledCircuit> circuit);
+
+    /**
+     * @brief Get the format of a vector file from its name and its content.
+     * 
+     * The '.json' files are in the JSON format, the other ones in the text format if they have a "Vector nb." line, 
+     * in the bit matrix format otherwise.
+     * 
+     * @param filename The name of the file, without its compression suffix
+     * @param content The content of the file
+     * @return The format of the file
+     */
+    static Format getFormat(const std::string& filename, const std::string& content);
+
+    /**
+     * @brief Reads the patterns of a vector file, decompressing it if its name ends with '.gz' or '.bz2'.
+     * 
+     * Exits with an error if the file can't be read or doesn't match the inputs of the circuit.
+     * 
+     * @param filename The name of the file
+     */
+    void read(const std::string& filename);
+
+    /**
+     * @brief Reads the patterns of the content of a vector file, appending them to the patterns already read.
+     * 
+     * @param content The content of the file
+     * @param format The format of the file
+     */
+    void parse(const std::string& content, Format format);
+
+    /**
+     * @brief Get the number of patterns read.
+     */
+    size_t getPatternCount() const {
+        return this->patterns.getPatternCount();
+    }
+
+    /**
+     * @brief Get the value of a primary input in a pattern.
+     * 
+     * @param pattern The index of the pattern
+     * @param input The position of the input in the inputs of the compiled circuit
+     */
+    bool getValue(size_t pattern, size_t input) const {
+        return this->patterns.getInput(pattern, input) == 1;
+    }
+
+    /**
+     * @brief Get the patterns read, without their outputs.
+     */
+    const PatternSet& getPatterns() const {
+        return this->patterns;
+    }
+
+    /**
+     * @brief Get a block of patterns in the layout of the simulators (see LogicSimulator): block_words words per primary input.
+     * 
+     * @param first_pattern The index of the first pattern of the block
+     * @param block_words The number of 64-bit words per input, the block holding up to 64 * block_words patterns
+     * @param patterns Set to the values of the inputs, the bits after the last pattern being 0
+     */
+    void getBlock(size_t first_pattern, size_t block_words, uint64_t* patterns) const {
+        this->patterns.getBlock(first_pattern, block_words, patterns);
+    }
+
+private:
+    /**
+     * @brief Adds a pattern from the values of the named bits of a vector file.
+     * 
+     * @param bits The value of each named bit of the vector, inputs and outputs
+     * @param vector The name of the vector in the file, for the error messages
+     */
+    void addPattern(const std::map<std::string, int>& bits, const std::string& vector);
+
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    size_t inputCount;
+
+    /**
+     * @brief Position of each primary input in the inputs of the compiled circuit, by name.
+     */
+    std::unordered_map<std::string, size_t> inputPositions;
+
+    /**
+     * @brief Names of the primary outputs, whose bits are ignored.
+     */
+    std::unordered_set<std::string> outputNames;
+
+    PatternSet patterns;
+};
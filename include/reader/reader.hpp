@@ -34,9 +34,14 @@
 #include <fstream>
 #include <memory>
 
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+
 #include "../parser/yosys_json_parser.hpp"
+#include "../parser/verilog_parser.hpp"
 #include "../builder_API/builder_API.hpp"
 #include "../utils/ANSI.hpp"
+#include "../utils/compression.hpp"
 
 using namespace BuilderAPI;
 
@@ -57,4 +62,19 @@ class Reader {
     
     private:
         shared_ptr<Parser> parser;
+
+        /**
+         * @brief Instanciate the parser matching the extension of the input file
+         * 
+         * @param extension The extension type of the input file ("json" or "v")
+         */
+        void selectParser(std::string extension);
+
+        /**
+         * @brief Create the nodes of a parsed circuit in a tree, and bind them
+         * 
+         * @param netlist The parsed circuit
+         * @param tree The circuit model tree to fill
+         */
+        void build(const ParsedCircuit& netlist, std::shared_ptr<Tree> tree);
 };
\ No newline at end of file
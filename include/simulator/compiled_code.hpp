@@ -0,0 +1,106 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file compiled_code.hpp
+ * @brief Definition of the CompiledCode class, the compiled-code simulation of a circuit
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../tree/CompiledCircuit.hpp"
+
+/**
+ * @class CompiledCode
+ * @brief Straight-line C++ code simulating a compiled circuit, built into a shared object with the local compiler and loaded at runtime.
+ * 
+ * The code has one bitwise statement per gate on 64-bit words, without any dispatch on the kind of the gates nor any load of the 
+ * circuit arrays. Building it is slow, so the shared objects are cached, named after the hash of their source: a netlist is 
+ * only built once. The cache directory is ATPGK_CACHE_DIR, or atpgk in XDG_CACHE_HOME, or ~/.cache/atpgk. The compiler is CXX, or c++.
+ */
+class CompiledCode {
+public:
+    /**
+     * @brief The generated function: computes the values of all the gates from the values of the primary inputs, one word per gate.
+     */
+    using SimulateFunction = void (*)(uint64_t* values);
+
+    /**
+     * @brief Loads the code of a circuit from the cache, building it first if needed.
+     * 
+     * Exits with an error if the code can't be built or loaded.
+     * 
+     * @param circuit The compiled circuit
+     */
+    explicit CompiledCode(const CompiledCircuit& circuit);
+
+    /**
+     * @brief Destructor of the CompiledCode class, unloading the shared object.
+     */
+    ~CompiledCode();
+
+    CompiledCode(const CompiledCode&) = delete;
+    CompiledCode& operator=(const CompiledCode&) = delete;
+
+    /**
+     * @brief Generates the C++ source simulating a circuit.
+     * 
+     * @param circuit The compiled circuit
+     * @param unit_count The number of translation units to split the source into, so that they can be compiled in parallel
+     * @return The source of each unit, the first one defining the entry point atpgk_simulate
+     */
+    static std::vector<std::string> generate(const CompiledCircuit& circuit, size_t unit_count = 1);
+
+    /**
+     * @brief Get the directory of the cached shared objects.
+     */
+    static std::string getCacheDirectory();
+
+    /**
+     * @brief Get the simulation function.
+     */
+    SimulateFunction getFunction() const;
+
+    /**
+     * @brief Get the path of the loaded shared object.
+     */
+    const std::string& getLibraryPath() const;
+
+    /**
+     * @brief Check if the shared object was found in the cache instead of being built.
+     */
+    bool isCached() const;
+
+private:
+    void* handle;
+
+    SimulateFunction function;
+
+    std::string libraryPath;
+
+    bool cached;
+};
@@ -0,0 +1,97 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file concurrent_fault_simulator.hpp
+ * @brief Definition of the ConcurrentFaultSimulator class, the concurrent fault simulation engine
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "fault_lists.hpp"
+
+/**
+ * @class ConcurrentFaultSimulator
+ * @brief Concurrent fault simulator: the good and the faulty circuits are simulated together, event by event.
+ * 
+ * Each gate keeps the faulty circuits whose value differs from the good one (its fault list), from one pattern to the next. 
+ * A gate is evaluated again only if the good value or the fault list of one of its inputs changed, 
+ * so consecutive patterns with a low activity are simulated at a low cost.
+ */
+class ConcurrentFaultSimulator {
+public:
+    /**
+     * @brief Constructor of the ConcurrentFaultSimulator class
+     * 
+     * @param circuit The compiled circuit to simulate
+     */
+    explicit ConcurrentFaultSimulator(std::shared_ptr<const CompiledCircuit> circuit);
+
+    /**
+     * @brief Simulates a block of patterns against the faults not detected yet (fault dropping).
+     * 
+     * All the gates are evaluated for the first pattern of the block, the following ones being event-driven.
+     * 
+     * @param good The logic simulator holding the values of the good circuit for the block
+     * @param pattern_count The number of patterns of the block
+     * @param faults The faults to simulate
+     * @param first_detection The index of the first pattern that detects each fault, -1 if not detected yet (see FaultSimulator::simulateBlock)
+     * @param first_pattern The index of the first pattern of the block
+     * @return The number of faults detected by the block
+     */
+    size_t simulateBlock(const LogicSimulator& good, size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern);
+
+private:
+    /**
+     * @brief Schedules the fanouts of a gate for the evaluation of the current pattern.
+     */
+    void scheduleFanouts(uint32_t gate);
+
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    FaultLists lists;
+
+    /**
+     * @brief The list of the gate being evaluated.
+     */
+    std::vector<uint32_t> scratch;
+
+    /**
+     * @brief Gates scheduled for evaluation, level l using the slots levelOffsets[l] to levelOffsets[l+1]-1.
+     */
+    std::vector<uint32_t> queue;
+
+    /**
+     * @brief Number of gates scheduled in each level.
+     */
+    std::vector<uint32_t> queueSizes;
+
+    /**
+     * @brief Whether each gate is scheduled.
+     */
+    std::vector<bool> scheduled;
+};
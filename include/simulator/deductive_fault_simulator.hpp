@@ -0,0 +1,69 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file deductive_fault_simulator.hpp
+ * @brief Definition of the DeductiveFaultSimulator class, the deductive fault simulation engine
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "fault_lists.hpp"
+
+/**
+ * @class DeductiveFaultSimulator
+ * @brief Deductive fault simulator: all the faults are simulated at once, one pattern at a time.
+ * 
+ * For each pattern, the list of the faults that change the value of each gate is deduced from the lists of its inputs, 
+ * level by level, and the faults in the lists of the primary outputs are detected by the pattern.
+ */
+class DeductiveFaultSimulator {
+public:
+    /**
+     * @brief Constructor of the DeductiveFaultSimulator class
+     * 
+     * @param circuit The compiled circuit to simulate
+     */
+    explicit DeductiveFaultSimulator(std::shared_ptr<const CompiledCircuit> circuit);
+
+    /**
+     * @brief Simulates a block of patterns against the faults not detected yet (fault dropping).
+     * 
+     * @param good The logic simulator holding the values of the good circuit for the block
+     * @param pattern_count The number of patterns of the block
+     * @param faults The faults to simulate
+     * @param first_detection The index of the first pattern that detects each fault, -1 if not detected yet (see FaultSimulator::simulateBlock)
+     * @param first_pattern The index of the first pattern of the block
+     * @return The number of faults detected by the block
+     */
+    size_t simulateBlock(const LogicSimulator& good, size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern);
+
+private:
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    FaultLists lists;
+};
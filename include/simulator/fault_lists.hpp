@@ -0,0 +1,120 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file fault_lists.hpp
+ * @brief Definition of the FaultLists class, the lists of faults changing each gate used by the deductive and concurrent engines
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "logic_simulator.hpp"
+
+struct StuckAtFault;
+
+/**
+ * @class FaultLists
+ * @brief Lists of the faults changing the value of each gate for one pattern, sorted by fault index.
+ * 
+ * A fault belongs to the list of a gate if the faulty circuit gives the opposite of the good value to the gate.
+ * The list of a gate is deduced from the lists of its inputs and from the stuck-at faults of the gate itself.
+ * The faults of the fault list must be distinct.
+ */
+class FaultLists {
+public:
+    /**
+     * @brief Constructor of the FaultLists class, all the lists being empty.
+     * 
+     * @param circuit The compiled circuit
+     */
+    explicit FaultLists(std::shared_ptr<const CompiledCircuit> circuit);
+
+    /**
+     * @brief Set the faults to simulate, only the ones not detected yet being added to the lists.
+     * 
+     * A fault appearing several times in the list (the same gate and stuck value) is added once, its copies being detected with it.
+     * 
+     * @param faults The faults to simulate
+     * @param first_detection The index of the first pattern that detects each fault, -1 if not detected yet. 
+     * It is kept by reference: the faults detected later are no longer added at their gate.
+     */
+    void setFaults(const std::vector<StuckAtFault>& faults, const std::vector<long>& first_detection);
+
+    /**
+     * @brief Computes the list of a gate for a pattern from the lists of its inputs.
+     * 
+     * @param gate The index of the gate
+     * @param good The logic simulator holding the values of the good circuit
+     * @param pattern The position of the pattern in the block
+     * @param list Set to the list of the gate (it can be the list of the gate, but not the list of one of its inputs)
+     */
+    void compute(uint32_t gate, const LogicSimulator& good, size_t pattern, std::vector<uint32_t>& list);
+
+    /**
+     * @brief Get the list of a gate.
+     */
+    std::vector<uint32_t>& operator[](uint32_t gate) {
+        return this->lists[gate];
+    }
+
+    /**
+     * @brief Records the detection of the faults not detected yet in the list of a primary output.
+     * 
+     * The lists may still hold faults detected since they were computed, they are ignored.
+     * 
+     * @param output The index of the output gate
+     * @param first_detection The first detections, set to pattern for the newly detected faults
+     * @param pattern The index of the pattern
+     * @return The number of newly detected faults
+     */
+    size_t detect(uint32_t output, std::vector<long>& first_detection, long pattern) const;
+
+private:
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    std::vector<std::vector<uint32_t>> lists;
+
+    /**
+     * @brief Index of the stuck-at-0 and stuck-at-1 faults of each gate not detected yet, -1 if none.
+     */
+    std::vector<long> localFaults;
+
+    /**
+     * @brief Index of the next copy of each fault in the fault list, -1 if none.
+     */
+    std::vector<long> copies;
+
+    /**
+     * @brief First detections of the faults, given by setFaults().
+     */
+    const std::vector<long>* firstDetection;
+
+    /**
+     * @brief Position in the list of each input of the gate being computed.
+     */
+    std::vector<size_t> cursors;
+};
@@ -0,0 +1,209 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file fault_simulator.hpp
+ * @brief Definition of the FaultSimulator class, the fault simulator of the compiled circuit
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logic_simulator.hpp"
+#include "deductive_fault_simulator.hpp"
+#include "concurrent_fault_simulator.hpp"
+#include "worker_pool.hpp"
+#include "../tree/Fault.hpp"
+
+/**
+ * @struct StuckAtFault
+ * @brief A stuck-at fault on the output of a gate of the compiled circuit.
+ */
+struct StuckAtFault {
+    /**
+     * @brief Index of the gate in the compiled circuit.
+     */
+    uint32_t gate;
+
+    /**
+     * @brief Stuck value of the output of the gate.
+     */
+    bool value;
+};
+
+/**
+ * @enum FaultSimulationEngine
+ * @brief Algorithm used to simulate the faults.
+ */
+enum class FaultSimulationEngine {
+    PPSFP,     /**< Parallel-pattern single-fault propagation. */
+    Deductive, /**< Deductive fault simulation. */
+    Concurrent, /**< Concurrent fault simulation. */
+    CriticalPathTracing /**< Critical path tracing. */
+};
+
+/**
+ * @class FaultSimulator
+ * @brief Fault simulator working on blocks of patterns.
+ * 
+ * The good circuit is simulated once per block of patterns, then the faults not detected yet are simulated by the engine:
+ * - PPSFP propagates each fault alone through the gates where it makes a difference, for all the patterns of the block at once. 
+ * It is the fastest when most faults are detected by the first patterns.
+ * - The deductive engine propagates the lists of the faults changing each gate, for all the faults at once, one pattern at a time.
+ * It is the fastest when many faults stay undetected over a long pattern set.
+ * - The concurrent engine keeps these lists from one pattern to the next, and only evaluates the gates whose inputs changed.
+ * It is the fastest for long pattern sets where consecutive patterns differ by a few inputs, such as functional patterns.
+ * - Critical path tracing finds the critical gates by a backward traversal from the primary outputs, only propagating 
+ * the fanout stems, for all the patterns of the block at once: all the faults are graded without being injected one by one. 
+ * It is the fastest on circuits with few fanouts.
+ */
+class FaultSimulator {
+public:
+    /**
+     * @brief Constructor of the FaultSimulator class
+     * 
+     * @param circuit The compiled circuit to simulate
+     * @param type The instruction set of the simulation kernel
+     * @param engine The fault simulation engine
+     * @param thread_count The number of threads propagating the faults with the PPSFP engine
+     */
+    FaultSimulator(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, FaultSimulationEngine engine = FaultSimulationEngine::PPSFP, size_t thread_count = 1);
+
+    /**
+     * @brief Get the fault simulation engine from its name ("ppsfp", "deductive", "concurrent" or "cpt").
+     * 
+     * @param name The name of the engine
+     * @param engine The engine, set if the name is known
+     * @return false if the name is unknown
+     */
+    static bool getEngine(const std::string& name, FaultSimulationEngine& engine);
+
+    /**
+     * @brief Get the stuck-at faults of the compiled circuit matching a fault list of the circuit model tree.
+     * 
+     * @param circuit The compiled circuit
+     * @param fault_list The faults and the nodes where they are applied
+     * @return The stuck-at faults, in the order of the fault list
+     */
+    static std::vector<StuckAtFault> getStuckAtFaults(const CompiledCircuit& circuit, const std::vector<std::pair<std::shared_ptr<Fault>, std::shared_ptr<Node>>>& fault_list);
+
+    /**
+     * @brief Get the number of patterns of a block.
+     */
+    size_t getBlockSize() const;
+
+    /**
+     * @brief Get the number of 64-bit words of a block for one primary input.
+     */
+    size_t getBlockWords() const;
+
+    /**
+     * @brief Get the fault simulation engine.
+     */
+    FaultSimulationEngine getEngine() const;
+
+    /**
+     * @brief Get the number of threads propagating the faults.
+     */
+    size_t getThreadCount() const;
+
+    /**
+     * @brief Simulates a block of patterns against the faults not detected yet (fault dropping).
+     * 
+     * @param patterns The values of the primary inputs, getBlockWords() words per input (see LogicSimulator)
+     * @param pattern_count The number of patterns of the block, at most getBlockSize()
+     * @param faults The faults to simulate
+     * @param first_detection The index of the first pattern that detects each fault, -1 if not detected yet. 
+     * The faults already detected are skipped, the ones detected by the block get first_pattern + their position in the block.
+     * @param first_pattern The index of the first pattern of the block
+     * @return The number of faults detected by the block
+     */
+    size_t simulateBlock(const uint64_t* patterns, size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern);
+
+    /**
+     * @brief Get the logic simulator of the good circuit, holding the values of the last simulated block.
+     */
+    const LogicSimulator& getLogicSimulator() const;
+
+private:
+    /**
+     * @brief Propagates each fault not detected yet alone, for the block simulated by the logic simulator.
+     * 
+     * With several threads, the faults are split in chunks taken in turn by the workers, which share the good circuit values 
+     * and have their own kernel. Each fault is simulated by a single worker, the only one to write its first detection.
+     */
+    size_t simulatePPSFP(size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern);
+
+    /**
+     * @brief Detects the faults not detected yet from the critical gates of the block simulated by the logic simulator.
+     */
+    size_t simulateCriticalPaths(size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern);
+
+    LogicSimulator logicSimulator;
+
+    FaultSimulationEngine engine;
+
+    /**
+     * @brief The deductive engine, if selected.
+     */
+    std::unique_ptr<DeductiveFaultSimulator> deductive;
+
+    /**
+     * @brief The concurrent engine, if selected.
+     */
+    std::unique_ptr<ConcurrentFaultSimulator> concurrent;
+
+    /**
+     * @brief Critical patterns of each gate, if critical path tracing is selected.
+     */
+    std::vector<uint64_t> critical;
+
+    /**
+     * @brief Root of the fanout-free region of each gate: the stem or the primary output whose criticality gives the one of the gate.
+     */
+    std::vector<uint32_t> regionRoots;
+
+    /**
+     * @brief Whether each stem must be analysed for the block, because its fanout-free region has faults not detected yet.
+     */
+    std::vector<uint8_t> analysedStems;
+
+    /**
+     * @brief Patterns detecting the fault being propagated, getBlockWords() words per worker.
+     */
+    std::vector<uint64_t> difference;
+
+    /**
+     * @brief The threads of the PPSFP engine, if there are several.
+     */
+    std::unique_ptr<WorkerPool> pool;
+
+    /**
+     * @brief The kernels of the workers 1 and up, the worker 0 using the kernel of the logic simulator.
+     */
+    std::vector<std::unique_ptr<SimulationKernel>> workerKernels;
+};
@@ -0,0 +1,132 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file logic_simulator.hpp
+ * @brief Definition of the LogicSimulator class, the bit-parallel simulation of the good circuit
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../tree/CompiledCircuit.hpp"
+#include "simulation_kernel.hpp"
+
+/**
+ * @class LogicSimulator
+ * @brief Simulates the compiled circuit for blocks of patterns, one bit per pattern.
+ * 
+ * The patterns of a block are given input by input: getBlockWords() 64-bit words per primary input 
+ * (in the order of CompiledCircuit::inputs), bit p of the words of an input being its value for the pattern p.
+ */
+class LogicSimulator {
+public:
+    /**
+     * @brief Constructor of the LogicSimulator class
+     * 
+     * @param circuit The compiled circuit to simulate
+     * @param type The instruction set of the simulation kernel
+     */
+    LogicSimulator(std::shared_ptr<const CompiledCircuit> circuit, KernelType type);
+
+    /**
+     * @brief Get the number of patterns of a block.
+     */
+    size_t getBlockSize() const;
+
+    /**
+     * @brief Get the number of 64-bit words of a block for one gate or one primary input.
+     */
+    size_t getBlockWords() const;
+
+    /**
+     * @brief Get the name of the instruction set of the simulation kernel.
+     */
+    std::string getKernelName() const;
+
+    /**
+     * @brief Simulates a block of patterns.
+     * 
+     * @param patterns The values of the primary inputs, getBlockWords() words per input
+     */
+    void simulate(const uint64_t* patterns);
+
+    /**
+     * @brief Changes the value of a primary input, the gates being updated by the next call to update().
+     * 
+     * @param input The position of the input in CompiledCircuit::inputs
+     * @param value The getBlockWords() words of the new value
+     */
+    void setInput(size_t input, const uint64_t* value);
+
+    /**
+     * @brief Updates the values of the gates after the changes made by setInput(), evaluating only the gates reached by a change.
+     * 
+     * The whole circuit is simulated if no block has been simulated yet.
+     * 
+     * @return The number of evaluated gates
+     */
+    size_t update();
+
+    /**
+     * @brief Get the value of a gate for the last simulated block.
+     * 
+     * @param gate The index of the gate
+     * @return Pointer to the getBlockWords() words of the value
+     */
+    const uint64_t* getValue(uint32_t gate) const;
+
+    /**
+     * @brief Get the values of all the gates for the last simulated block, getBlockWords() words per gate.
+     */
+    const uint64_t* getValues() const;
+
+    /**
+     * @brief Get the simulation kernel.
+     */
+    SimulationKernel& getKernel();
+
+private:
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    std::unique_ptr<SimulationKernel> kernel;
+
+    /**
+     * @brief Values of the gates, getBlockWords() words per gate.
+     */
+    std::vector<uint64_t> values;
+
+    /**
+     * @brief Primary inputs changed by setInput() since the last simulation.
+     */
+    std::vector<uint32_t> changedInputs;
+
+    /**
+     * @brief Whether the values of the gates are consistent with the values of the primary inputs.
+     */
+    bool simulated;
+};
@@ -0,0 +1,189 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file random_pattern_phase.hpp
+ * @brief Definition of the RandomPatternPhase class, the random pattern phase preceding the deterministic test generation
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../tree/PatternSet.hpp"
+#include "fault_simulator.hpp"
+
+/**
+ * @enum PatternSource
+ * @brief Generator of the random patterns.
+ */
+enum class PatternSource {
+    Random, /**< Pseudo-random patterns of the Mersenne Twister. */
+    LFSR    /**< Bits of a linear feedback shift register shifted into the inputs, as an on-chip pattern generator would. */
+};
+
+/**
+ * @class RandomPatternGenerator
+ * @brief Generates blocks of random patterns, in the layout of the simulators (see LogicSimulator).
+ */
+class RandomPatternGenerator {
+public:
+    /**
+     * @brief Constructor of the RandomPatternGenerator class
+     * 
+     * @param source The generator of the patterns
+     * @param seed The seed of the generator, the same seed giving the same patterns
+     */
+    explicit RandomPatternGenerator(PatternSource source, uint64_t seed = 1);
+
+    /**
+     * @brief Get the pattern source from its name ("random" or "lfsr").
+     * 
+     * @param name The name of the source
+     * @param source The source, set if the name is known
+     * @return false if the name is unknown
+     */
+    static bool getSource(const std::string& name, PatternSource& source);
+
+    /**
+     * @brief Generates the next 64 * block_words patterns.
+     * 
+     * The random words are drawn 64 patterns at a time, input by input. The LFSR is a 64-bit maximal-length Galois LFSR: each pattern
+     * takes its next input_count bits, the first one going to the first input. Both give the same sequence of patterns whatever block_words.
+     * 
+     * @param patterns Set to the values of the primary inputs, block_words words per input
+     * @param input_count The number of primary inputs
+     * @param block_words The number of 64-bit words per input
+     */
+    void generate(uint64_t* patterns, size_t input_count, size_t block_words);
+
+private:
+    PatternSource source;
+
+    std::mt19937_64 random;
+
+    /**
+     * @brief State of the LFSR, never 0.
+     */
+    uint64_t lfsr;
+};
+
+/**
+ * @class RandomPatternPhase
+ * @brief Fault simulates random patterns until they stop detecting enough new faults, and keeps the patterns detecting new faults.
+ * 
+ * Most faults are detected by a few thousand random patterns, at the cost of the bit-parallel fault simulation, 
+ * so that the deterministic test generation only has to target the remaining faults.
+ */
+class RandomPatternPhase {
+public:
+    /**
+     * @brief Constructor of the RandomPatternPhase class
+     * 
+     * @param circuit The compiled circuit
+     * @param type The instruction set of the simulation kernel
+     * @param source The generator of the patterns
+     * @param max_patterns The maximum number of simulated patterns
+     * @param min_gain The minimum number of faults, in percent of the fault list, that a block of 64 patterns must detect to go on
+     * @param engine The fault simulation engine
+     * @param thread_count The number of threads propagating the faults with the PPSFP engine
+     */
+    RandomPatternPhase(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, PatternSource source, size_t max_patterns, double min_gain, FaultSimulationEngine engine = FaultSimulationEngine::PPSFP, size_t thread_count = 1);
+
+    /**
+     * @brief Simulates the random patterns against the faults not detected yet, block by block.
+     * 
+     * The phase stops after max_patterns patterns, when all the faults are detected, or after the first window of 64 patterns 
+     * detecting less than min_gain percent of the fault list. The patterns after this window are dropped, even if the block 
+     * of the simulation kernel simulated them, so that the kept patterns and the detections don't depend on the kernel.
+     * 
+     * @param faults The faults to detect
+     * @param first_detection The index of the kept pattern that first detects each fault, -1 if not detected yet. 
+     * The faults already detected are skipped.
+     * @return The number of faults detected by the phase
+     */
+    size_t run(const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection);
+
+    /**
+     * @brief Get the number of kept patterns, the patterns detecting at least one fault first.
+     */
+    size_t getPatternCount() const {
+        return this->patterns.getPatternCount();
+    }
+
+    /**
+     * @brief Get the number of simulated patterns.
+     */
+    size_t getSimulatedCount() const {
+        return this->simulatedCount;
+    }
+
+    /**
+     * @brief Get the value of a primary input in a kept pattern.
+     * 
+     * @param pattern The index of the kept pattern
+     * @param input The position of the input in CompiledCircuit::inputs
+     */
+    bool getInput(size_t pattern, size_t input) const {
+        return this->patterns.getInput(pattern, input) == 1;
+    }
+
+    /**
+     * @brief Get the value of a primary output in a kept pattern, in the good circuit.
+     * 
+     * @param pattern The index of the kept pattern
+     * @param output The position of the output in CompiledCircuit::outputs
+     */
+    bool getOutput(size_t pattern, size_t output) const {
+        return this->patterns.getOutput(pattern, output) == 1;
+    }
+
+    /**
+     * @brief Get the kept patterns, with the values of the primary outputs in the good circuit.
+     */
+    const PatternSet& getPatterns() const {
+        return this->patterns;
+    }
+
+private:
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    FaultSimulator simulator;
+
+    RandomPatternGenerator generator;
+
+    size_t maxPatterns;
+
+    double minGain;
+
+    size_t simulatedCount;
+
+    /**
+     * @brief The kept patterns.
+     */
+    PatternSet patterns;
+};
@@ -0,0 +1,327 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file simulation_kernel.hpp
+ * @brief Definition of the SimulationKernel class, the bit-parallel evaluation of the compiled circuit used by the simulators
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../tree/CellKind.hpp"
+
+class CompiledCircuit;
+
+/**
+ * @enum KernelType
+ * @brief Instruction set used by a simulation kernel.
+ */
+enum class KernelType {
+    Auto,    /**< Widest kernel supported by the CPU among the SIMD and portable ones, see resolve(). */
+    Generic, /**< Portable kernel, 64 patterns per block. */
+    AVX2,    /**< AVX2 kernel, 256 patterns per block. */
+    AVX512,  /**< AVX-512 kernel, 512 patterns per block. */
+    Compiled /**< Portable kernel whose good circuit simulation is generated C++ code (see CompiledCode), 64 patterns per block. */
+};
+
+/**
+ * @struct ForcedValue
+ * @brief A gate forced to a value for one pattern of a block, to inject a stuck-at fault in this pattern only.
+ */
+struct ForcedValue {
+    uint32_t gate;
+    uint32_t pattern;
+    bool value;
+};
+
+/**
+ * @class SimulationKernel
+ * @brief Evaluates all the gates of a compiled circuit for a block of patterns at once, one bit per pattern.
+ * 
+ * The values of the circuit are stored gate by gate, getBlockWords() 64-bit words per gate: bit p of the 
+ * words of a gate is its value for the pattern p of the block.
+ * 
+ * The subclasses are instantiated for each instruction set in their own translation unit, compiled with the matching 
+ * compiler flags. They must only be created through create(), which checks that the CPU supports the instruction set.
+ * The kernel keeps scratch buffers for the fault propagation, so a kernel must not be shared between threads.
+ */
+class SimulationKernel {
+public:
+    /**
+     * @brief Creates a kernel for a compiled circuit.
+     * 
+     * Exits with an error if the CPU doesn't support the requested instruction set.
+     * 
+     * @param circuit The compiled circuit
+     * @param type The instruction set of the kernel, chosen by resolve() for KernelType::Auto
+     * @return The new kernel
+     */
+    static std::unique_ptr<SimulationKernel> create(std::shared_ptr<const CompiledCircuit> circuit, KernelType type);
+
+    /**
+     * @brief Get the instruction set of KernelType::Auto: AVX-512, else AVX2, else the portable kernel.
+     * 
+     * The choice only depends on the CPU and the build, so that a run uses the same kernel in all its phases.
+     * 
+     * @param type The requested instruction set
+     * @return The instruction set itself, unless it is KernelType::Auto
+     */
+    static KernelType resolve(KernelType type);
+
+    /**
+     * @brief Check if the CPU, the compiler and the build support an instruction set.
+     */
+    static bool isSupported(KernelType type);
+
+    /**
+     * @brief Get the kernel type from its name ("auto", "generic", "avx2", "avx512" or "compiled").
+     * 
+     * @param name The name of the kernel type
+     * @param type The kernel type, set if the name is known
+     * @return false if the name is unknown
+     */
+    static bool getKernelType(const std::string& name, KernelType& type);
+
+    /**
+     * @brief Get the name of a kernel type, as given to getKernelType().
+     */
+    static std::string getTypeName(KernelType type);
+
+    virtual ~SimulationKernel();
+
+    /**
+     * @brief Get the name of the instruction set of the kernel.
+     */
+    virtual std::string getName() const;
+
+    /**
+     * @brief Get the instruction set of the kernel, never KernelType::Auto.
+     */
+    KernelType getType() const {
+        return this->type;
+    }
+
+    /**
+     * @brief Get the number of patterns simulated at once.
+     */
+    size_t getBlockSize() const {
+        return this->blockWords * 64;
+    }
+
+    /**
+     * @brief Get the number of 64-bit words of the value of a gate.
+     */
+    size_t getBlockWords() const {
+        return this->blockWords;
+    }
+
+    /**
+     * @brief Get the compiled circuit simulated by the kernel.
+     */
+    const CompiledCircuit& getCircuit() const {
+        return *this->circuit;
+    }
+
+    /**
+     * @brief Computes the values of all the gates from the values of the primary inputs.
+     * 
+     * @param values The values of the gates, the values of the primary inputs being already set
+     */
+    virtual void simulate(uint64_t* values) = 0;
+
+    /**
+     * @brief Computes the three-valued (0, 1, X) values of all the gates from the values of the primary inputs.
+     *
+     * The value of a gate is stored on 2 * getBlockWords() words: the one rail, whose bit is set for the patterns where the gate is 1,
+     * followed by the zero rail, whose bit is set for the patterns where the gate is 0. A pattern is X if its bit is set in neither rail.
+     *
+     * @param values The values of the gates, the values of the primary inputs being already set
+     */
+    void simulateThreeValued(uint64_t* values) {
+        this->simulateThreeValued(values, nullptr, 0);
+    }
+
+    /**
+     * @brief Computes the three-valued values of all the gates, some gates being forced to a value for some patterns.
+     *
+     * Each forced value replaces the computed value of its gate for its pattern, so that a block can hold the good circuit 
+     * and faulty circuits side by side. The forced values of the primary inputs are written into their values.
+     *
+     * @param values The values of the gates, the values of the primary inputs being already set
+     * @param forced The forced values, sorted by gate
+     * @param forced_count The number of forced values
+     */
+    virtual void simulateThreeValued(uint64_t* values, const ForcedValue* forced, size_t forced_count) = 0;
+
+    /**
+     * @brief Updates the values of the gates after a change of the values of some of them, evaluating only the gates with a changed input.
+     * 
+     * The gates are scheduled in the buckets of their level, and the levels are processed in increasing order, 
+     * so the cost is proportional to the number of gates reached by the change.
+     * 
+     * @param values The values of the gates, consistent except for the fanouts of the changed gates
+     * @param changed The gates whose values have been changed by the caller (usually primary inputs)
+     * @param count The number of changed gates
+     * @return The number of evaluated gates
+     */
+    virtual size_t simulateEvents(uint64_t* values, const uint32_t* changed, size_t count) = 0;
+
+    /**
+     * @brief Propagates a stuck-at fault from its gate to the primary outputs.
+     * 
+     * Only the gates whose value differs from the good circuit are evaluated, level by level.
+     * 
+     * @param good The values of the gates in the good circuit, computed by simulate()
+     * @param gate The index of the gate whose output is stuck
+     * @param value The stuck value
+     * @param difference Set to the patterns for which at least one primary output differs from the good circuit (getBlockWords() words)
+     */
+    virtual void propagateFault(const uint64_t* good, uint32_t gate, bool value, uint64_t* difference) = 0;
+
+    /**
+     * @brief Critical path tracing: finds, for each gate, the patterns for which flipping its value changes a primary output.
+     * 
+     * The gates are traced backward from the primary outputs. A gate with a single child is critical where its child is critical 
+     * and sensitive to it. The paths from a stem with several children may reconverge: the flip of the stem is propagated 
+     * to the primary outputs (stem analysis).
+     * 
+     * @param good The values of the gates in the good circuit, computed by simulate()
+     * @param stems Whether each stem must be analysed, the stems which are not are set as never critical (nullptr to analyse all of them)
+     * @param critical Set to the critical patterns of each gate, getBlockWords() words per gate
+     */
+    virtual void traceCritical(const uint64_t* good, const uint8_t* stems, uint64_t* critical) = 0;
+
+protected:
+    /**
+     * @brief Constructor of the SimulationKernel class, allocating the scratch buffers.
+     * 
+     * The name is kept as a C string, so that the kernels compiled with an instruction set don't build any std::string.
+     * 
+     * @param circuit The compiled circuit
+     * @param block_words The number of 64-bit words of the value of a gate
+     * @param name The name of the instruction set of the kernel
+     */
+    SimulationKernel(const std::shared_ptr<const CompiledCircuit>& circuit, size_t block_words, const char* name);
+
+    /**
+     * @brief Start a new propagation (of a fault or of events), invalidating the faulty values and the scheduled gates of the previous one.
+     * 
+     * @return The stamp of the new propagation
+     */
+    uint32_t nextStamp();
+
+    /**
+     * @brief Name of the instruction set of the kernel.
+     */
+    const char* name;
+
+    /**
+     * @brief Number of 64-bit words of the value of a gate.
+     */
+    size_t blockWords;
+
+    /**
+     * @brief Number of gates of the circuit.
+     */
+    size_t gateCount;
+
+    /**
+     * @brief Index of the first gate which is not a primary input.
+     */
+    uint32_t firstGate;
+
+    /**
+     * @brief The compiled circuit arrays, accessed through raw pointers by the kernels.
+     */
+    const CellKind* kinds;
+    const int* levels;
+    const uint32_t* levelOffsets;
+    const uint32_t* faninOffsets;
+    const uint32_t* fanins;
+    const uint32_t* fanoutOffsets;
+    const uint32_t* fanouts;
+
+    /**
+     * @brief Whether each gate reaches a primary output (see CompiledCircuit::isObservable()).
+     */
+    const uint8_t* observable;
+
+    /**
+     * @brief Values of the gates in the faulty circuit, valid if faultyStamps matches the current stamp.
+     */
+    uint64_t* faultyValues;
+
+    /**
+     * @brief Stamp of the propagation that set the faulty value of each gate.
+     */
+    uint32_t* faultyStamps;
+
+    /**
+     * @brief Stamp of the propagation that scheduled each gate.
+     */
+    uint32_t* scheduledStamps;
+
+    /**
+     * @brief Gates scheduled for evaluation, level l using the slots levelOffsets[l] to levelOffsets[l+1]-1.
+     */
+    uint32_t* queue;
+
+    /**
+     * @brief Number of gates scheduled in each level.
+     */
+    uint32_t* queueSizes;
+
+private:
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    /**
+     * @brief Instruction set of the kernel, set by create().
+     */
+    KernelType type;
+
+    /**
+     * @brief Storage of the scratch buffers.
+     * 
+     * The subclasses only use the raw pointers above: they are compiled with other instruction sets, and must not 
+     * instantiate the standard templates shared with the rest of the program.
+     */
+    std::vector<uint64_t> faultyStorage;
+    std::vector<uint32_t> stampStorage;
+    std::vector<uint32_t> queueStorage;
+    std::vector<uint8_t> observableStorage;
+
+    uint32_t stamp;
+};
+
+/**
+ * @brief Factories of the kernels of each instruction set, defined in their own translation unit.
+ */
+SimulationKernel* createGenericKernel(const std::shared_ptr<const CompiledCircuit>& circuit);
+SimulationKernel* createAVX2Kernel(const std::shared_ptr<const CompiledCircuit>& circuit);
+SimulationKernel* createAVX512Kernel(const std::shared_ptr<const CompiledCircuit>& circuit);
+SimulationKernel* createCompiledCodeKernel(const std::shared_ptr<const CompiledCircuit>& circuit);
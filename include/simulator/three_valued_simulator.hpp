@@ -0,0 +1,141 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file three_valued_simulator.hpp
+ * @brief Definition of the ThreeValuedSimulator class, the bit-parallel simulation of the good circuit with unknown values
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../tree/CompiledCircuit.hpp"
+#include "simulation_kernel.hpp"
+#include "fault_simulator.hpp"
+
+/**
+ * @class ThreeValuedSimulator
+ * @brief Simulates the compiled circuit for blocks of cubes, whose inputs can be 0, 1 or X (unknown).
+ * 
+ * Each value is stored on two rails of getBlockWords() 64-bit words: bit p of the one rail is set if the value is 1 for the cube p, 
+ * bit p of the zero rail is set if it is 0, and none of them is set if it is unknown.
+ * A value computed as 0 or 1 holds for all the ways of replacing the unknown inputs by 0 or 1.
+ */
+class ThreeValuedSimulator {
+public:
+    /**
+     * @brief Constructor of the ThreeValuedSimulator class, all the inputs are unknown.
+     * 
+     * @param circuit The compiled circuit to simulate
+     * @param type The instruction set of the simulation kernel
+     */
+    ThreeValuedSimulator(std::shared_ptr<const CompiledCircuit> circuit, KernelType type);
+
+    /**
+     * @brief Get the number of cubes of a block.
+     */
+    size_t getBlockSize() const;
+
+    /**
+     * @brief Get the number of 64-bit words of a rail.
+     */
+    size_t getBlockWords() const;
+
+    /**
+     * @brief Get the name of the instruction set of the simulation kernel.
+     */
+    std::string getKernelName() const;
+
+    /**
+     * @brief Set all the primary inputs to X for all the cubes of the block.
+     */
+    void clearInputs();
+
+    /**
+     * @brief Set the value of a primary input for a cube of the block.
+     * 
+     * @param input The position of the input in CompiledCircuit::inputs
+     * @param cube The position of the cube in the block
+     * @param value 0, 1 or -1 (X)
+     */
+    void setInputValue(size_t input, size_t cube, int value);
+
+    /**
+     * @brief Simulates the block of cubes set with setInputValue().
+     */
+    void simulate();
+
+    /**
+     * @brief Simulates a block of cubes given by the rails of the primary inputs.
+     * 
+     * @param ones The one rails of the primary inputs, getBlockWords() words per input
+     * @param zeros The zero rails of the primary inputs, getBlockWords() words per input
+     */
+    void simulate(const uint64_t* ones, const uint64_t* zeros);
+
+    /**
+     * @brief Get the value of a gate for a cube of the last simulated block.
+     * 
+     * @param gate The index of the gate
+     * @param cube The position of the cube in the block
+     * @return 0, 1 or -1 (X)
+     */
+    int getValue(uint32_t gate, size_t cube) const;
+
+    /**
+     * @brief Finds the stuck-at faults detected by a cube whatever the values of its unknown inputs.
+     * 
+     * The good circuit and getBlockSize() - 1 faulty circuits are simulated in the same block, each faulty circuit forcing 
+     * the gate of its fault. A fault is detected if a primary output is 0 or 1 in both the good and the faulty circuit, 
+     * with different values. The values set with setInputValue() are replaced.
+     * 
+     * @param cube The value of each primary input, in the order of CompiledCircuit::inputs: 0, 1 or -1 (X)
+     * @param faults The faults
+     * @param detected Set to whether each fault is detected
+     */
+    void detect(const std::vector<int>& cube, const std::vector<StuckAtFault>& faults, std::vector<bool>& detected);
+
+    /**
+     * @brief Get the one rail of a gate for the last simulated block (getBlockWords() words).
+     */
+    const uint64_t* getOnes(uint32_t gate) const;
+
+    /**
+     * @brief Get the zero rail of a gate for the last simulated block (getBlockWords() words).
+     */
+    const uint64_t* getZeros(uint32_t gate) const;
+
+private:
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    std::unique_ptr<SimulationKernel> kernel;
+
+    /**
+     * @brief Values of the gates, the one rail then the zero rail of each gate.
+     */
+    std::vector<uint64_t> values;
+};
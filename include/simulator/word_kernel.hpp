@@ -0,0 +1,361 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file word_kernel.hpp
+ * @brief Definition of the WordKernel template, the simulation kernel for a given word type
+ * 
+ * This file must only be included by the translation units of the kernels (kernel_*.cpp). Everything is declared in 
+ * an anonymous namespace, so that the code compiled with an instruction set never leaks into the rest of the program.
+ * For the same reason, it must not include the circuit model tree: its inline functions would be emitted with the 
+ * instruction set of the kernel and could be picked by the linker for the whole program.
+ */
+
+#pragma once
+
+#include "simulation_kernel.hpp"
+
+namespace {
+
+/**
+ * @brief Two-valued logic on the words of Ops, one bit per pattern.
+ */
+template <typename Ops>
+struct TwoValuedLogic : Ops {
+    using Value = typename Ops::Word;
+
+    // The high impedance state is not a two-valued logic value: the enable of $_TBUF_ is ignored
+    static Value tristate(Value a, Value) { return a; }
+};
+
+/**
+ * @brief Three-valued logic (0, 1, X) on pairs of words of Ops, with a two-rail encoding.
+ * 
+ * The bit of a pattern is set in the one rail if the value is 1, in the zero rail if the value is 0, and in none of them if the value is unknown.
+ * Each gate is evaluated exactly: its output is known if it has the same value for all the values of the unknown inputs.
+ */
+template <typename Ops>
+struct ThreeValuedLogic {
+    using Word = typename Ops::Word;
+
+    struct Value {
+        Word one;
+        Word zero;
+    };
+
+    static Value zero() { return {Ops::zero(), Ops::ones()}; }
+    static Value bitNot(Value a) { return {a.zero, a.one}; }
+    static Value bitAnd(Value a, Value b) { return {Ops::bitAnd(a.one, b.one), Ops::bitOr(a.zero, b.zero)}; }
+    static Value bitOr(Value a, Value b) { return {Ops::bitOr(a.one, b.one), Ops::bitAnd(a.zero, b.zero)}; }
+    static Value andNot(Value a, Value b) { return bitAnd(a, bitNot(b)); }
+
+    static Value bitXor(Value a, Value b) {
+        return {Ops::bitOr(Ops::bitAnd(a.one, b.zero), Ops::bitAnd(a.zero, b.one)), Ops::bitOr(Ops::bitAnd(a.one, b.one), Ops::bitAnd(a.zero, b.zero))};
+    }
+
+    // s ? b : a, known if the select is known or if both data inputs have the same known value
+    static Value select(Value s, Value a, Value b) {
+        return {
+            Ops::bitOr(Ops::bitOr(Ops::bitAnd(s.zero, a.one), Ops::bitAnd(s.one, b.one)), Ops::bitAnd(a.one, b.one)),
+            Ops::bitOr(Ops::bitOr(Ops::bitAnd(s.zero, a.zero), Ops::bitAnd(s.one, b.zero)), Ops::bitAnd(a.zero, b.zero))
+        };
+    }
+
+    // The output of a disabled (or maybe disabled) $_TBUF_ is unknown
+    static Value tristate(Value a, Value enable) { return {Ops::bitAnd(enable.one, a.one), Ops::bitAnd(enable.one, a.zero)}; }
+};
+
+/**
+ * @class WordKernel
+ * @brief Simulation kernel working on words of the type Ops::Word.
+ * 
+ * Ops provides the word type, its width in 64-bit words (Ops::words), its name and the bitwise operations 
+ * (load, store, zero, ones, bitAnd, bitOr, bitXor, bitNot, andNot, select and any). The gates are evaluated 
+ * with the two-valued or the three-valued logic built on these operations.
+ */
+template <typename Ops>
+class WordKernel : public SimulationKernel {
+public:
+    using Word = typename Ops::Word;
+
+    WordKernel(const std::shared_ptr<const CompiledCircuit>& circuit) : SimulationKernel(circuit, Ops::words, Ops::name) {}
+
+    void simulate(uint64_t* values) override {
+        auto get = [values](uint32_t gate) { return Ops::load(values + gate * Ops::words); };
+        for (uint32_t gate = this->firstGate; gate < this->gateCount; ++gate) {
+            Ops::store(values + gate * Ops::words, evaluate<TwoValued>(this->kinds[gate], this->fanins + this->faninOffsets[gate], get));
+        }
+    }
+
+    void simulateThreeValued(uint64_t* values, const ForcedValue* forced, size_t forced_count) override {
+        // The forced values are written in the rails after the evaluation of their gate, before its fanouts load it
+        auto force = [values](const ForcedValue& value) {
+            const uint64_t bit = uint64_t(1) << (value.pattern % 64);
+            uint64_t* one = values + 2 * value.gate * Ops::words + value.pattern / 64;
+            uint64_t* zero = one + Ops::words;
+            *one = value.value ? *one | bit : *one & ~bit;
+            *zero = value.value ? *zero & ~bit : *zero | bit;
+        };
+        size_t next = 0;
+        for (; next < forced_count && forced[next].gate < this->firstGate; ++next) {
+            force(forced[next]);
+        }
+
+        auto get = [values](uint32_t gate) {
+            return typename ThreeValued::Value{Ops::load(values + 2 * gate * Ops::words), Ops::load(values + (2 * gate + 1) * Ops::words)};
+        };
+        for (uint32_t gate = this->firstGate; gate < this->gateCount; ++gate) {
+            const typename ThreeValued::Value value = evaluate<ThreeValued>(this->kinds[gate], this->fanins + this->faninOffsets[gate], get);
+            Ops::store(values + 2 * gate * Ops::words, value.one);
+            Ops::store(values + (2 * gate + 1) * Ops::words, value.zero);
+            for (; next < forced_count && forced[next].gate == gate; ++next) {
+                force(forced[next]);
+            }
+        }
+    }
+
+    size_t simulateEvents(uint64_t* values, const uint32_t* changed, size_t count) override {
+        const uint32_t stamp = this->nextStamp();
+        auto get = [values](uint32_t g) { return Ops::load(values + g * Ops::words); };
+
+        int first_level = static_cast<int>(this->gateCount);
+        int last_level = -1;
+        auto schedule = [&](uint32_t g) {
+            for (uint32_t fanout = this->fanoutOffsets[g]; fanout < this->fanoutOffsets[g + 1]; ++fanout) {
+                const uint32_t child = this->fanouts[fanout];
+                if (this->scheduledStamps[child] != stamp) {
+                    this->scheduledStamps[child] = stamp;
+                    const int level = this->levels[child];
+                    this->queue[this->levelOffsets[level] + this->queueSizes[level]++] = child;
+                    if (level < first_level) first_level = level;
+                    if (level > last_level) last_level = level;
+                }
+            }
+        };
+
+        for (size_t i = 0; i < count; ++i) {
+            schedule(changed[i]);
+        }
+
+        // A gate is scheduled by its inputs, which all have a lower level: it is evaluated once, after all of them
+        size_t evaluated = 0;
+        for (int level = first_level; level <= last_level; ++level) {
+            const uint32_t* scheduled = this->queue + this->levelOffsets[level];
+            for (uint32_t i = 0; i < this->queueSizes[level]; ++i) {
+                const uint32_t g = scheduled[i];
+                const Word value_g = evaluate<TwoValued>(this->kinds[g], this->fanins + this->faninOffsets[g], get);
+                if (Ops::any(Ops::bitXor(value_g, get(g)))) {
+                    Ops::store(values + g * Ops::words, value_g);
+                    schedule(g);
+                }
+            }
+            evaluated += this->queueSizes[level];
+            this->queueSizes[level] = 0;
+        }
+        return evaluated;
+    }
+
+    void propagateFault(const uint64_t* good, uint32_t gate, bool value, uint64_t* difference) override {
+        Ops::store(difference, propagate(good, gate, value ? Ops::ones() : Ops::zero()));
+    }
+
+    void traceCritical(const uint64_t* good, const uint8_t* stems, uint64_t* critical) override {
+        // The fanouts of a gate have a higher level: they are traced before it
+        for (uint32_t gate = static_cast<uint32_t>(this->gateCount); gate-- > 0;) {
+            const uint32_t first_fanout = this->fanoutOffsets[gate];
+            const uint32_t last_fanout = this->fanoutOffsets[gate + 1];
+
+            bool single_child = true;
+            for (uint32_t fanout = first_fanout + 1; fanout < last_fanout; ++fanout) {
+                single_child = single_child && this->fanouts[fanout] == this->fanouts[first_fanout];
+            }
+
+            Word value;
+            if (this->kinds[gate] == CellKind::Output) {
+                value = Ops::ones();
+            } else if (first_fanout == last_fanout || !this->observable[gate] || (!single_child && stems != nullptr && !stems[gate])) {
+                value = Ops::zero();
+            } else if (single_child) {
+                // Fanout-free: the gate is critical if its child is critical and sensitive to it
+                const uint32_t child = this->fanouts[first_fanout];
+                auto get = [good, gate](uint32_t g) {
+                    const Word good_g = Ops::load(good + g * Ops::words);
+                    return g == gate ? Ops::bitNot(good_g) : good_g;
+                };
+                const Word flipped = evaluate<TwoValued>(this->kinds[child], this->fanins + this->faninOffsets[child], get);
+                const Word sensitive = Ops::bitXor(flipped, Ops::load(good + child * Ops::words));
+                value = Ops::bitAnd(Ops::load(critical + child * Ops::words), sensitive);
+            } else {
+                // Stem analysis: the paths from a stem may reconverge, the effect of its flip is propagated to the outputs
+                value = propagate(good, gate, Ops::bitNot(Ops::load(good + gate * Ops::words)));
+            }
+            Ops::store(critical + gate * Ops::words, value);
+        }
+    }
+
+private:
+    using TwoValued = TwoValuedLogic<Ops>;
+    using ThreeValued = ThreeValuedLogic<Ops>;
+
+    /**
+     * @brief Propagates a faulty value of a gate to the primary outputs, only evaluating the gates whose value differs from the good circuit.
+     * 
+     * @param good The values of the gates in the good circuit
+     * @param gate The index of the faulty gate
+     * @param value The value of the gate in the faulty circuit
+     * @return The patterns for which at least one primary output differs from the good circuit
+     */
+    Word propagate(const uint64_t* good, uint32_t gate, Word value) {
+        const uint32_t stamp = this->nextStamp();
+        Word detected = Ops::zero();
+
+        // Value of a gate in the faulty circuit
+        auto get = [this, good, stamp](uint32_t g) {
+            return this->faultyStamps[g] == stamp ? Ops::load(this->faultyValues + g * Ops::words) : Ops::load(good + g * Ops::words);
+        };
+
+        int last_level = this->levels[gate];
+        auto setFaulty = [&](uint32_t g, Word faulty, Word diff) {
+            Ops::store(this->faultyValues + g * Ops::words, faulty);
+            this->faultyStamps[g] = stamp;
+            if (this->kinds[g] == CellKind::Output) {
+                detected = Ops::bitOr(detected, diff);
+            }
+            for (uint32_t fanout = this->fanoutOffsets[g]; fanout < this->fanoutOffsets[g + 1]; ++fanout) {
+                const uint32_t child = this->fanouts[fanout];
+                if (this->scheduledStamps[child] != stamp) {
+                    this->scheduledStamps[child] = stamp;
+                    const int level = this->levels[child];
+                    this->queue[this->levelOffsets[level] + this->queueSizes[level]++] = child;
+                    if (level > last_level) last_level = level;
+                }
+            }
+        };
+
+        const Word diff = Ops::bitXor(value, Ops::load(good + gate * Ops::words));
+        if (Ops::any(diff)) {
+            setFaulty(gate, value, diff);
+        }
+
+        // The fanouts of a gate have a higher level, so the gates are evaluated after all their faulty inputs
+        for (int level = this->levels[gate] + 1; level <= last_level; ++level) {
+            const uint32_t* scheduled = this->queue + this->levelOffsets[level];
+            for (uint32_t i = 0; i < this->queueSizes[level]; ++i) {
+                const uint32_t g = scheduled[i];
+                const Word value_g = evaluate<TwoValued>(this->kinds[g], this->fanins + this->faninOffsets[g], get);
+                const Word diff_g = Ops::bitXor(value_g, Ops::load(good + g * Ops::words));
+                if (Ops::any(diff_g)) {
+                    setFaulty(g, value_g, diff_g);
+                }
+            }
+            this->queueSizes[level] = 0;
+        }
+
+        return detected;
+    }
+
+
+    /**
+     * @brief 2-to-1 multiplexer of the values of the gates in[0] (S = 0) and in[1] (S = 1), selected by s.
+     */
+    template <typename L, typename Get>
+    static typename L::Value mux2(const uint32_t* in, typename L::Value s, Get& get) {
+        return L::select(s, get(in[0]), get(in[1]));
+    }
+
+    /**
+     * @brief 4-to-1 multiplexer of the values of the gates in[0] to in[3], selected by s (low bit) and t.
+     */
+    template <typename L, typename Get>
+    static typename L::Value mux4(const uint32_t* in, typename L::Value s, typename L::Value t, Get& get) {
+        return L::select(t, mux2<L>(in, s, get), mux2<L>(in + 2, s, get));
+    }
+
+    /**
+     * @brief 8-to-1 multiplexer of the values of the gates in[0] to in[7], selected by s (low bit), t and u.
+     */
+    template <typename L, typename Get>
+    static typename L::Value mux8(const uint32_t* in, typename L::Value s, typename L::Value t, typename L::Value u, Get& get) {
+        return L::select(u, mux4<L>(in, s, t, get), mux4<L>(in + 4, s, t, get));
+    }
+
+    /**
+     * @brief Computes the value of a gate from the values of its inputs.
+     * 
+     * @tparam L The logic of the values (TwoValued or ThreeValued)
+     * @param kind The kind of the gate
+     * @param in The inputs of the gate, sorted by port
+     * @param get Function returning the value of a gate
+     */
+    template <typename L, typename Get>
+    static typename L::Value evaluate(CellKind kind, const uint32_t* in, Get& get) {
+        switch (kind) {
+            case CellKind::Input:
+                break;  // The primary inputs are never evaluated
+            case CellKind::Output:
+            case CellKind::Buf:
+                return get(in[0]);
+            case CellKind::Tbuf:
+                return L::tristate(get(in[0]), get(in[1]));
+            case CellKind::Not:
+                return L::bitNot(get(in[0]));
+            case CellKind::And:
+                return L::bitAnd(get(in[0]), get(in[1]));
+            case CellKind::Nand:
+                return L::bitNot(L::bitAnd(get(in[0]), get(in[1])));
+            case CellKind::Andnot:
+                return L::andNot(get(in[0]), get(in[1]));
+            case CellKind::Or:
+                return L::bitOr(get(in[0]), get(in[1]));
+            case CellKind::Nor:
+                return L::bitNot(L::bitOr(get(in[0]), get(in[1])));
+            case CellKind::Ornot:
+                return L::bitOr(get(in[0]), L::bitNot(get(in[1])));
+            case CellKind::Xor:
+                return L::bitXor(get(in[0]), get(in[1]));
+            case CellKind::Xnor:
+                return L::bitNot(L::bitXor(get(in[0]), get(in[1])));
+            case CellKind::Aoi3:
+                return L::bitNot(L::bitOr(L::bitAnd(get(in[0]), get(in[1])), get(in[2])));
+            case CellKind::Oai3:
+                return L::bitNot(L::bitAnd(L::bitOr(get(in[0]), get(in[1])), get(in[2])));
+            case CellKind::Aoi4:
+                return L::bitNot(L::bitOr(L::bitAnd(get(in[0]), get(in[1])), L::bitAnd(get(in[2]), get(in[3]))));
+            case CellKind::Oai4:
+                return L::bitNot(L::bitAnd(L::bitOr(get(in[0]), get(in[1])), L::bitOr(get(in[2]), get(in[3]))));
+            case CellKind::Mux:
+                return mux2<L>(in, get(in[2]), get);
+            case CellKind::Nmux:
+                return L::bitNot(mux2<L>(in, get(in[2]), get));
+            case CellKind::Mux4:
+                return mux4<L>(in, get(in[4]), get(in[5]), get);
+            case CellKind::Mux8:
+                return mux8<L>(in, get(in[8]), get(in[9]), get(in[10]), get);
+            case CellKind::Mux16:
+                return L::select(get(in[19]), mux8<L>(in, get(in[16]), get(in[17]), get(in[18]), get), mux8<L>(in + 8, get(in[16]), get(in[17]), get(in[18]), get));
+        }
+        return L::zero();
+    }
+};
+
+} // namespace
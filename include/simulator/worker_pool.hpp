@@ -0,0 +1,98 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file worker_pool.hpp
+ * @brief Definition of the WorkerPool class, the threads shared by the parallel simulations
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief A fixed set of threads running the same job, the calling thread being the worker 0.
+ * 
+ * The threads are created once and wait for the next job, so that a job can be as short as the simulation of one block of patterns.
+ */
+class WorkerPool {
+public:
+    /**
+     * @brief Constructor of the WorkerPool class, starting worker_count - 1 threads.
+     * 
+     * @param worker_count The number of workers, including the calling thread
+     */
+    explicit WorkerPool(size_t worker_count);
+
+    /**
+     * @brief Destructor of the WorkerPool class, stopping the threads.
+     */
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Get the number of workers, including the calling thread.
+     */
+    size_t getSize() const;
+
+    /**
+     * @brief Runs a job on all the workers and waits until all of them are done.
+     * 
+     * @param job The job, called with the index of the worker
+     */
+    void run(const std::function<void(size_t)>& job);
+
+private:
+    /**
+     * @brief Loop of a thread, running each new job.
+     */
+    void work(size_t worker);
+
+    std::vector<std::thread> threads;
+
+    std::mutex mutex;
+    std::condition_variable started;
+    std::condition_variable finished;
+
+    const std::function<void(size_t)>* job;
+
+    /**
+     * @brief Incremented for each new job.
+     */
+    size_t generation;
+
+    /**
+     * @brief Number of threads which haven't finished the current job.
+     */
+    size_t running;
+
+    bool stopping;
+};
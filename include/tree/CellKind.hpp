@@ -0,0 +1,62 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file CellKind.hpp
+ * @brief Definition of the CellKind enum, the function of a gate of the compiled circuit
+ * 
+ * This header has no dependency, so that the simulation kernels compiled with an instruction set don't include the circuit model tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @enum CellKind
+ * @brief Function of a gate of the compiled circuit, one value per Yosys basic cell type.
+ */
+enum class CellKind : uint8_t {
+    Input,
+    Output,
+    Buf,
+    Not,
+    And,
+    Nand,
+    Andnot,
+    Or,
+    Nor,
+    Ornot,
+    Xor,
+    Xnor,
+    Aoi3,
+    Oai3,
+    Aoi4,
+    Oai4,
+    Mux,
+    Nmux,
+    Mux4,
+    Mux8,
+    Mux16,
+    Tbuf
+};
@@ -0,0 +1,304 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file CompiledCircuit.hpp
+ * @brief Definition of the CompiledCircuit class, a flat and index-based view of the circuit model tree
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+#include "CellKind.hpp"
+#include "Tree.hpp"
+
+/**
+ * @brief Get the kind of a gate from the type of its node.
+ * 
+ * @param type Type of the node ("Input", "Output" or a Yosys cell type such as "$_AND_")
+ * @param kind The kind of the gate, set if the type is known
+ * @return false if the type is not supported
+ */
+bool getCellKind(const std::string& type, CellKind& kind);
+
+/**
+ * @brief Get the number of inputs of a kind of gate.
+ * 
+ * @param kind The kind of the gate
+ * @return The number of inputs (0 for the primary inputs)
+ */
+size_t getCellArity(CellKind kind);
+
+/**
+ * @brief Computes the output of a gate for one pattern.
+ * 
+ * The high impedance state is not a two-valued logic value: a $_TBUF_ outputs its input A.
+ * 
+ * @param kind The kind of the gate
+ * @param inputs The values of the inputs of the gate, bit i being the value of the i-th input sorted by port
+ * @return The value of the output
+ */
+bool evaluateCell(CellKind kind, uint32_t inputs);
+
+/**
+ * @brief Get the controlling value of an input of a kind of gate: the value of the input which sets the output 
+ * whatever the values of the other inputs.
+ * 
+ * @param kind The kind of the gate
+ * @param input The position of the input, sorted by port
+ * @return The controlling value, -1 if the input has none (XOR and multiplexer data inputs for instance)
+ */
+int getControllingValue(CellKind kind, size_t input);
+
+/**
+ * @class CompiledCircuit
+ * @brief Flat representation of the circuit model tree, made for the algorithms that run on the whole circuit many times.
+ * 
+ * The gates are numbered in level order, so that the inputs of a gate always have a lower index than the gate itself.
+ * The connections are stored in compressed arrays of indexes: the inputs of the gate g are 
+ * fanins[faninOffsets[g]] to fanins[faninOffsets[g+1]-1], sorted by port (A, B, ..., S, T, U, V, EN), and its outputs 
+ * are stored the same way in fanouts.
+ * 
+ * The circuit also precomputes the cones of the primary outputs: for each gate, a bitset of the primary outputs 
+ * it can reach, and for each primary output, a bitset of the primary inputs of its fanin cone, and the fault 
+ * propagation dominators of each gate.
+ * 
+ * The tree must be levelized (see Tree::levelize()) before being compiled, and compiled again if it is modified.
+ */
+class CompiledCircuit {
+public:
+    /**
+     * @brief Kind of each gate.
+     */
+    std::vector<CellKind> kinds;
+
+    /**
+     * @brief Logic level of each gate.
+     */
+    std::vector<int> levels;
+
+    /**
+     * @brief Index of the first gate of each level, the gates of level l being levelOffsets[l] to levelOffsets[l+1]-1.
+     */
+    std::vector<uint32_t> levelOffsets;
+
+    /**
+     * @brief Position of the first input of each gate in fanins, with one more element at the end.
+     */
+    std::vector<uint32_t> faninOffsets;
+
+    /**
+     * @brief Inputs of all the gates, sorted by port for each gate.
+     */
+    std::vector<uint32_t> fanins;
+
+    /**
+     * @brief Position of the first output of each gate in fanouts, with one more element at the end.
+     */
+    std::vector<uint32_t> fanoutOffsets;
+
+    /**
+     * @brief Outputs of all the gates.
+     */
+    std::vector<uint32_t> fanouts;
+
+    /**
+     * @brief Index of each primary input, in the order of Tree::InputList.
+     */
+    std::vector<uint32_t> inputs;
+
+    /**
+     * @brief Index of each primary output, in the order of Tree::OutputList.
+     */
+    std::vector<uint32_t> outputs;
+
+    /**
+     * @brief Node of the circuit model tree of each gate.
+     */
+    std::vector<std::shared_ptr<Node>> nodes;
+
+    /**
+     * @brief Compiles a levelized circuit model tree.
+     * 
+     * Exits with an error if a node has an unsupported type or a wrong number of inputs.
+     * 
+     * @param tree The levelized circuit model tree
+     */
+    CompiledCircuit(std::shared_ptr<Tree> tree);
+
+    /**
+     * @brief Get the number of gates of the circuit, primary inputs and outputs included.
+     */
+    size_t getGateCount() const;
+
+    /**
+     * @brief Get the index of the gate of a node.
+     * 
+     * @param identifier The unique identifier of the node
+     * @return The index of the gate
+     */
+    uint32_t getIndex(size_t identifier) const;
+
+    /**
+     * @brief Check in constant time if a gate has a path to at least one primary output.
+     * 
+     * A fault on a gate without such a path can't be observed, so it can be rejected without running the ATPG.
+     */
+    bool isObservable(uint32_t gate) const {
+        return this->observable[gate];
+    }
+
+    /**
+     * @brief Check if a gate has a path to a primary output.
+     * 
+     * @param gate The index of the gate
+     * @param output The position of the primary output in outputs
+     */
+    bool reachesOutput(uint32_t gate, uint32_t output) const {
+        return (this->outputReach[gate * this->outputWords + output / 64] >> (output % 64)) & 1;
+    }
+
+    /**
+     * @brief Check if a primary input is in the fanin cone of a primary output.
+     * 
+     * @param input The position of the primary input in inputs
+     * @param output The position of the primary output in outputs
+     */
+    bool isInCone(uint32_t input, uint32_t output) const {
+        return (this->inputCones[output * this->inputWords + input / 64] >> (input % 64)) & 1;
+    }
+
+    /**
+     * @brief Get the bitset of the primary outputs reached by a gate, bit i standing for outputs[i].
+     * 
+     * @return Pointer to the getOutputWords() words of the bitset
+     */
+    const uint64_t* getOutputReach(uint32_t gate) const {
+        return &this->outputReach[gate * this->outputWords];
+    }
+
+    /**
+     * @brief Get the bitset of the primary inputs in the fanin cone of a primary output, bit i standing for inputs[i].
+     * 
+     * @return Pointer to the getInputWords() words of the bitset
+     */
+    const uint64_t* getInputCone(uint32_t output) const {
+        return &this->inputCones[output * this->inputWords];
+    }
+
+    /**
+     * @brief Get the immediate dominator of a gate: the closest gate through which all the paths from the gate to the primary outputs go.
+     * 
+     * The dominators of a gate are its immediate dominator, the immediate dominator of this one, and so on: the effect of 
+     * a fault on the gate goes through all of them to be observed.
+     * 
+     * @param gate The index of the gate
+     * @return The index of the immediate dominator, NoDominator if the gate is a primary output, can't reach any primary output, 
+     * or only meets its other paths at the primary outputs
+     */
+    uint32_t getDominator(uint32_t gate) const {
+        return this->dominators[gate];
+    }
+
+    /**
+     * @brief Get the values of the side inputs of the dominators of a gate needed to propagate a fault on the gate.
+     * 
+     * The side inputs of a dominator are its inputs outside the fanout cone of the gate. A side input with a controlling value 
+     * (see getControllingValue()) would block the fault effect at the dominator, so it must be set to the other value 
+     * in all the test vectors of the fault.
+     * 
+     * @param gate The index of the faulty gate
+     * @param values Set to the side inputs and their value, a gate appearing with both values if the fault can't be propagated
+     */
+    void getSideInputValues(uint32_t gate, std::vector<std::pair<uint32_t, bool>>& values) const;
+
+    /**
+     * @brief Value returned by getDominator() when a gate has no dominator.
+     */
+    static constexpr uint32_t NoDominator = UINT32_MAX;
+
+    /**
+     * @brief Get the number of 64-bit words of an output reach bitset.
+     */
+    size_t getOutputWords() const {
+        return this->outputWords;
+    }
+
+    /**
+     * @brief Get the number of 64-bit words of an input cone bitset.
+     */
+    size_t getInputWords() const {
+        return this->inputWords;
+    }
+
+private:
+    /**
+     * @brief Index of the gates by identifier of their node.
+     */
+    std::unordered_map<size_t, uint32_t> index;
+
+    /**
+     * @brief Number of 64-bit words of a bitset of primary outputs.
+     */
+    size_t outputWords;
+
+    /**
+     * @brief Number of 64-bit words of a bitset of primary inputs.
+     */
+    size_t inputWords;
+
+    /**
+     * @brief Bitsets of the primary outputs reached by each gate, outputWords words per gate.
+     */
+    std::vector<uint64_t> outputReach;
+
+    /**
+     * @brief Bitsets of the primary inputs in the cone of each primary output, inputWords words per output.
+     */
+    std::vector<uint64_t> inputCones;
+
+    /**
+     * @brief Whether each gate reaches at least one primary output.
+     */
+    std::vector<bool> observable;
+
+    /**
+     * @brief Immediate dominator of each gate, NoDominator if it has none.
+     */
+    std::vector<uint32_t> dominators;
+
+    /**
+     * @brief Computes the bitsets of the cones of the primary outputs.
+     */
+    void computeCones();
+
+    /**
+     * @brief Computes the immediate dominators of the gates, from the primary outputs back to the inputs.
+     */
+    void computeDominators();
+};
@@ -141,11 +141,30 @@ public:
         return this->failure;
     }
 
+    /**
+     * @brief Get the reason of the failure
+     * 
+     * @return std::string - "co" for controllability, "ob" for observability, "ab" for a generation aborted after exceeding its effort limit, "nd" for a fault not detected by graded patterns
+     */
+    std::string getFailureReason() {
+        return this->failureReason;
+    }
+
     /**
      * @brief Set the failure boolean flag to True 
+     * @param reason The reason of the failure ("co" for controllability, "ob" for observability, "ab" for a generation aborted after exceeding its effort limit, "nd" for a fault not detected by graded patterns)
      */
-    void setFailure() {
+    void setFailure(std::string reason = "co") {
         this->failure = true;
+        this->failureReason = reason;
+    }
+
+    /**
+     * @brief Set the failure boolean flag to False, for a fault detected by a test vector which was not generated for it
+     */
+    void clearFailure() {
+        this->failure = false;
+        this->failureReason = "";
     }
 
     /**
@@ -184,6 +203,11 @@ private:
      */
     bool failure = false;
 
+    /**
+     * @brief The reason why the Fault can't be tested
+     */
+    std::string failureReason;
+
     /**
      * @brief The port of the gate concerned by the fault.
      */
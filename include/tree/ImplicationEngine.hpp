@@ -0,0 +1,126 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file ImplicationEngine.hpp
+ * @brief Definition of the ImplicationEngine class, the three-valued direct implications on the compiled circuit
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "CompiledCircuit.hpp"
+
+class LearnedImplications;
+
+/**
+ * @class ImplicationEngine
+ * @brief Assigns values (0, 1 or X) to the gates of a compiled circuit and derives their direct implications.
+ * 
+ * Each assignment is implied forward (the output of a gate whose inputs give a single possible value) and backward 
+ * (the inputs of a gate having a single possible value for its output), gate by gate until no new value is found, 
+ * and through the learned implications if any. The assigned gates are recorded on a trail, so that the engine can 
+ * backtrack to a previous state.
+ * 
+ * The gates are evaluated by enumerating the values of their unassigned inputs: the gates with more than 8 unassigned 
+ * inputs are not implied, which only loses implications.
+ */
+class ImplicationEngine {
+public:
+    /**
+     * @brief Constructor of the ImplicationEngine class, all the gates being unassigned.
+     * 
+     * @param circuit The compiled circuit
+     * @param learned The learned implications used along with the direct ones, nullptr for none
+     */
+    ImplicationEngine(std::shared_ptr<const CompiledCircuit> circuit, const LearnedImplications* learned = nullptr);
+
+    /**
+     * @brief Get the value of a gate: 0, 1, or -1 if it is unassigned.
+     */
+    int getValue(uint32_t gate) const {
+        return this->values[gate];
+    }
+
+    /**
+     * @brief Assign a value to a gate and derive its implications.
+     * 
+     * After a conflict, the values are left as they were when it was found: the caller backtracks.
+     * 
+     * @param gate The index of the gate
+     * @param value The value of the gate
+     * @return false if the value conflicts with the assigned ones
+     */
+    bool assign(uint32_t gate, bool value);
+
+    /**
+     * @brief Get the gates assigned since the creation of the engine or the last backtrack, in assignment order.
+     */
+    const std::vector<uint32_t>& getTrail() const {
+        return this->trail;
+    }
+
+    /**
+     * @brief Unassign the gates assigned after a point of the trail.
+     * 
+     * @param trail_size The size of the trail to go back to, 0 to unassign all the gates
+     */
+    void backtrack(size_t trail_size);
+
+    /**
+     * @brief Check if the value of a gate is implied by the values of its inputs (always true for an unassigned gate or a primary input).
+     */
+    bool isJustified(uint32_t gate) const;
+
+    /**
+     * @brief Check if a value of a kind of gate forces the value of one of its inputs, such as a 1 on the output of an AND.
+     * 
+     * A value which doesn't force any input has several justifications, so that the backward implications stop at the gate.
+     */
+    static bool forcesInput(CellKind kind, bool value);
+
+private:
+    std::shared_ptr<const CompiledCircuit> circuit;
+    const LearnedImplications* learned;
+
+    std::vector<int8_t> values;
+    std::vector<uint32_t> trail;
+
+    /**
+     * @brief Position in the trail of the next assigned gate whose implications are not derived yet.
+     */
+    size_t next;
+
+    /**
+     * @brief Set the value of a gate, false if it has the opposite value.
+     */
+    bool set(uint32_t gate, bool value);
+
+    /**
+     * @brief Derive the forward and backward implications of a gate.
+     */
+    bool evaluate(uint32_t gate);
+};
@@ -0,0 +1,117 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file LearnedImplications.hpp
+ * @brief Definition of the LearnedImplications class, the indirect implications found by static learning
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <utility>
+
+#include "CompiledCircuit.hpp"
+
+/**
+ * @class LearnedImplications
+ * @brief Indirect implications between the values of the gates of a compiled circuit, found by static learning.
+ * 
+ * Each gate is assigned 0 and 1 in turn, and the values implied by the assignment are derived (see ImplicationEngine). 
+ * If g = v implies h = w, then h = !w implies g = !v: this contrapositive is learned when the direct implications 
+ * can't find it, i.e. when h is a cell whose value !w doesn't force any of its inputs (such as a 0 on the output of an 
+ * AND), h being reached from g through reconvergent paths. A value of g which leads to a conflict can't be set: 
+ * it is learned as implying the opposite value.
+ * 
+ * The implications are stored by value of a gate (a literal, 2 * gate + value) in compressed arrays.
+ */
+class LearnedImplications {
+public:
+    /**
+     * @brief Constructor of the LearnedImplications class, running the static learning.
+     * 
+     * @param circuit The compiled circuit
+     */
+    LearnedImplications(std::shared_ptr<const CompiledCircuit> circuit);
+
+    /**
+     * @brief Constructor of the LearnedImplications class, running the static learning once per module of a hierarchical netlist.
+     * 
+     * The implications between the cells of a module hold whatever the values of its ports: they are learned once on the 
+     * tree of the module (see Tree::ModuleTrees), and copied to each of its instances (see Tree::InstanceList). Only the 
+     * gates outside the instances are learned on the whole circuit, so the implications which a value of a gate of an instance 
+     * only has through the gates around the instance are not learned. Without instances, the learning is the one of the circuit.
+     * 
+     * @param circuit The compiled circuit
+     * @param tree The circuit model tree the circuit was compiled from
+     */
+    LearnedImplications(std::shared_ptr<const CompiledCircuit> circuit, const Tree& tree);
+
+    /**
+     * @brief Get the compiled circuit of the implications.
+     */
+    const CompiledCircuit& getCircuit() const {
+        return *this->circuit;
+    }
+
+    /**
+     * @brief Get the number of learned implications.
+     */
+    size_t getCount() const {
+        return this->implied.size();
+    }
+
+    /**
+     * @brief Get the first of the values implied by a value of a gate, as literals (2 * gate + value).
+     */
+    const uint32_t* begin(uint32_t gate, bool value) const {
+        return this->implied.data() + this->offsets[2 * gate + value];
+    }
+
+    /**
+     * @brief Get the end of the values implied by a value of a gate.
+     */
+    const uint32_t* end(uint32_t gate, bool value) const {
+        return this->implied.data() + this->offsets[2 * gate + value + 1];
+    }
+
+private:
+    /**
+     * @brief Store the learned implications, as (literal, implied literal) pairs, in the compressed arrays.
+     */
+    void store(std::vector<std::pair<uint32_t, uint32_t>>& implications);
+
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    /**
+     * @brief Position of the first implied value of each literal in implied, with one more element at the end.
+     */
+    std::vector<uint32_t> offsets;
+
+    /**
+     * @brief Implied values of all the literals.
+     */
+    std::vector<uint32_t> implied;
+};
@@ -46,7 +46,7 @@ class NodeVisitor;
  * This class serves as the base class for all types of nodes within a circuit. It contains common properties
  * and methods relevant to all nodes, such as identification, connections, and fault coverage.
  */
-class Node {
+class Node : public std::enable_shared_from_this<Node> {
 public:
     /**
      * @brief Unique identifier for each node.
@@ -79,6 +79,13 @@ public:
      */
     int value;
 
+    /**
+     * @brief Logic level of the node, computed by Tree::levelize().
+     * 
+     * 0 for the nodes without parent (inputs), 1 + the highest level of the parents otherwise. -1 if not computed yet.
+     */
+    int level = -1;
+
     /**
      * @brief Type of the node, typically indicating its functionality.
      */
@@ -119,7 +126,8 @@ public:
     void addParent(std::shared_ptr<Node> parent, int number);
 
     /**
-     * @brief Retrieves a node by its unique identifier within the tree structure.
+     * @brief Retrieves a node by its unique identifier among this node and its descendants.
+     * @note The search is iterative, so that it doesn't overflow the call stack on deep circuits.
      * @param identifier The unique identifier of the desired node.
      * @return A pointer to the `Node` with the corresponding identifier.
      */
@@ -0,0 +1,202 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file PatternSet.hpp
+ * @brief Definition of the PatternSet class, the bit-packed storage of a set of test patterns
+ */
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @class PatternSet
+ * @brief Set of test patterns over the primary inputs and outputs of a circuit, two bits per value.
+ * 
+ * Each value is stored on two rails: the one rail, whose bit is set if the value is 1, and the zero rail, 
+ * whose bit is set if the value is 0. A value is unspecified (X) if its bit is set in neither rail.
+ * 
+ * The inputs are stored in two layouts:
+ * - pattern by pattern, getInputWords() words per rail and pattern, bit i being the input i (see getOnes()),
+ * - input by input for each group of 64 patterns, bit p being the pattern p of the group: the layout of the simulators 
+ * (see getBlock()).
+ * 
+ * The outputs are only stored pattern by pattern. A pattern is appended in constant time, all its values unspecified.
+ */
+class PatternSet {
+public:
+    /**
+     * @brief Constructor of the PatternSet class, without any pattern.
+     * 
+     * @param input_count The number of primary inputs
+     * @param output_count The number of primary outputs
+     */
+    PatternSet(size_t input_count = 0, size_t output_count = 0);
+
+    size_t getInputCount() const {
+        return this->inputCount;
+    }
+
+    size_t getOutputCount() const {
+        return this->outputCount;
+    }
+
+    size_t getPatternCount() const {
+        return this->patternCount;
+    }
+
+    /**
+     * @brief Get the number of 64-bit words of a rail of the inputs of a pattern.
+     */
+    size_t getInputWords() const {
+        return this->inputWords;
+    }
+
+    /**
+     * @brief Appends a pattern whose values are all unspecified.
+     * 
+     * @return The index of the new pattern
+     */
+    size_t addPattern();
+
+    /**
+     * @brief Appends a pattern from the rails of its inputs, its outputs being unspecified.
+     * 
+     * @param ones The one rail of the inputs (getInputWords() words)
+     * @param zeros The zero rail of the inputs (getInputWords() words)
+     * @return The index of the new pattern
+     */
+    size_t addPattern(const uint64_t* ones, const uint64_t* zeros);
+
+    /**
+     * @brief Set the values of all the primary inputs of a pattern from their rails.
+     * 
+     * @param pattern The index of the pattern
+     * @param ones The one rail of the inputs (getInputWords() words)
+     * @param zeros The zero rail of the inputs (getInputWords() words)
+     */
+    void setPattern(size_t pattern, const uint64_t* ones, const uint64_t* zeros);
+
+    /**
+     * @brief Removes all the patterns.
+     */
+    void clear();
+
+    /**
+     * @brief Set the value of a primary input in a pattern.
+     * 
+     * @param pattern The index of the pattern
+     * @param input The position of the input in the input list
+     * @param value 0, 1 or -1 for an unspecified value
+     */
+    void setInput(size_t pattern, size_t input, int value);
+
+    /**
+     * @brief Get the value of a primary input in a pattern: 0, 1 or -1 if unspecified.
+     */
+    int getInput(size_t pattern, size_t input) const {
+        const size_t word = pattern * this->inputWords + input / 64;
+        if ((this->inputOnes[word] >> (input % 64)) & 1) return 1;
+        return ((this->inputZeros[word] >> (input % 64)) & 1) ? 0 : -1;
+    }
+
+    /**
+     * @brief Set the value of a primary output in a pattern.
+     * 
+     * @param pattern The index of the pattern
+     * @param output The position of the output in the output list
+     * @param value 0, 1 or -1 for an unspecified value
+     */
+    void setOutput(size_t pattern, size_t output, int value);
+
+    /**
+     * @brief Get the value of a primary output in a pattern: 0, 1 or -1 if unspecified.
+     */
+    int getOutput(size_t pattern, size_t output) const {
+        const size_t word = pattern * this->outputWords + output / 64;
+        if ((this->outputOnes[word] >> (output % 64)) & 1) return 1;
+        return ((this->outputZeros[word] >> (output % 64)) & 1) ? 0 : -1;
+    }
+
+    /**
+     * @brief Get the one rail of the inputs of a pattern (getInputWords() words).
+     */
+    const uint64_t* getOnes(size_t pattern) const {
+        return this->inputOnes.data() + pattern * this->inputWords;
+    }
+
+    /**
+     * @brief Get the zero rail of the inputs of a pattern (getInputWords() words).
+     */
+    const uint64_t* getZeros(size_t pattern) const {
+        return this->inputZeros.data() + pattern * this->inputWords;
+    }
+
+    /**
+     * @brief Get a block of patterns in the layout of the simulators (see LogicSimulator), the unspecified inputs being 0.
+     * 
+     * @param first_pattern The index of the first pattern of the block
+     * @param block_words The number of 64-bit words per input, the block holding up to 64 * block_words patterns
+     * @param patterns Set to the values of the inputs, the bits after the last pattern being 0
+     */
+    void getBlock(size_t first_pattern, size_t block_words, uint64_t* patterns) const;
+
+    /**
+     * @brief Get a block of patterns in the layout of the three-valued simulator (see ThreeValuedSimulator::simulate()).
+     * 
+     * @param first_pattern The index of the first pattern of the block
+     * @param block_words The number of 64-bit words per input, the block holding up to 64 * block_words patterns
+     * @param ones Set to the one rails of the inputs, the bits after the last pattern being 0
+     * @param zeros Set to the zero rails of the inputs, the bits after the last pattern being 0
+     */
+    void getBlock(size_t first_pattern, size_t block_words, uint64_t* ones, uint64_t* zeros) const;
+
+private:
+    /**
+     * @brief Copies a rail of the groups of 64 patterns into the layout of the simulators.
+     */
+    void copyBlock(const std::vector<uint64_t>& groups, size_t first_pattern, size_t block_words, uint64_t* rail) const;
+
+    size_t inputCount;
+    size_t outputCount;
+    size_t patternCount;
+    size_t inputWords;
+    size_t outputWords;
+
+    /**
+     * @brief Rails of the inputs and outputs, pattern by pattern.
+     */
+    std::vector<uint64_t> inputOnes;
+    std::vector<uint64_t> inputZeros;
+    std::vector<uint64_t> outputOnes;
+    std::vector<uint64_t> outputZeros;
+
+    /**
+     * @brief Rails of the inputs, input by input for each group of 64 patterns: the word of the input i for the group g is at g * inputCount + i.
+     */
+    std::vector<uint64_t> groupOnes;
+    std::vector<uint64_t> groupZeros;
+};
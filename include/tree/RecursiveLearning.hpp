@@ -0,0 +1,106 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file RecursiveLearning.hpp
+ * @brief Definition of the RecursiveLearning class, the derivation of the necessary assignments of a partial assignment
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "CompiledCircuit.hpp"
+#include "ImplicationEngine.hpp"
+
+/**
+ * @class RecursiveLearning
+ * @brief Finds the values necessary to the values assigned to the gates of a compiled circuit, by recursive learning.
+ * 
+ * The value of a gate which is not implied by the values of its inputs (an unjustified gate) needs one of its 
+ * justifications: the minimal assignments of its inputs giving the value. Each justification is assigned in turn and 
+ * implied, the unjustified gates it creates being learned recursively up to the depth. The values implied by all 
+ * the consistent justifications are necessary, and a gate without any consistent justification is a conflict.
+ * 
+ * The cost grows exponentially with the depth: a depth of 1 only implies the justifications directly.
+ */
+class RecursiveLearning {
+public:
+    /**
+     * @brief Constructor of the RecursiveLearning class, all the gates being unassigned.
+     * 
+     * @param circuit The compiled circuit
+     * @param depth The maximum recursion depth, at least 1
+     * @param learned The learned implications used by the implications, nullptr for none
+     */
+    RecursiveLearning(std::shared_ptr<const CompiledCircuit> circuit, size_t depth, const LearnedImplications* learned = nullptr);
+
+    /**
+     * @brief Get the implication engine holding the values, to assign them before learning and to read the result.
+     */
+    ImplicationEngine& getEngine() {
+        return this->engine;
+    }
+
+    size_t getDepth() const {
+        return this->depth;
+    }
+
+    /**
+     * @brief Assign the values necessary to the values of the engine, until no new one is found.
+     * 
+     * @return false if the values of the engine can't be justified
+     */
+    bool learn();
+
+private:
+    /**
+     * @brief Minimal assignment of the inputs of a cell: bit i of mask is set if the input i is assigned, to bit i of values.
+     */
+    struct Cube {
+        uint32_t mask;
+        uint32_t values;
+    };
+
+    std::shared_ptr<const CompiledCircuit> circuit;
+    ImplicationEngine engine;
+    size_t depth;
+
+    /**
+     * @brief Justifications of the values of each kind of cell, indexed by 2 * CellKind + value, and whether they are built.
+     */
+    std::vector<std::vector<Cube>> justifications;
+    std::vector<bool> built;
+
+    /**
+     * @brief Get the justifications of a value of a kind of cell, none for the cells with more than 8 inputs.
+     */
+    const std::vector<Cube>& getJustifications(CellKind kind, bool value);
+
+    /**
+     * @brief Learn from the unjustified gates assigned from a position of the trail.
+     */
+    bool learn(size_t depth, size_t first);
+};
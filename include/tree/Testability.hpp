@@ -0,0 +1,164 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+/**
+ * @file Testability.hpp
+ * @brief Definition of the Testability class, the SCOAP controllability and observability of the gates of the compiled circuit
+ */
+
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstdint>
+#include <limits>
+
+#include "CompiledCircuit.hpp"
+
+/**
+ * @class Testability
+ * @brief SCOAP combinational testability measures of each gate of a compiled circuit.
+ * 
+ * The controllability CC0 (CC1) of a gate is the number of gates to set to get a 0 (1) on its output: 1 for 
+ * a primary input, and for a cell, the cheapest input assignment giving the value plus one. The observability CO 
+ * of a gate is the number of gates to set to propagate a change of its output to a primary output: 0 for a primary 
+ * output, and the cheapest of its fanout branches otherwise. A branch is observed through a cell by assigning the 
+ * other inputs of the cell so that its output depends on the branch.
+ * 
+ * The input assignments of each kind of cell are found once by enumerating its cubes, the multiplexers with more than 
+ * 6 inputs being handled by their select inputs. The controllabilities are computed in one pass in level order, 
+ * the observabilities in one pass in reverse level order. The gates which can't be set or observed get Infinity.
+ */
+class Testability {
+public:
+    /**
+     * @brief Cost of a value which can't be set, or of a gate which can't be observed.
+     */
+    static constexpr uint32_t Infinity = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Constructor of the Testability class, computing the measures of all the gates.
+     * 
+     * @param circuit The compiled circuit
+     */
+    Testability(std::shared_ptr<const CompiledCircuit> circuit);
+
+    /**
+     * @brief Get the compiled circuit of the measures.
+     */
+    const CompiledCircuit& getCircuit() const {
+        return *this->circuit;
+    }
+
+    /**
+     * @brief Get the controllability of a value on the output of a gate (CC0 or CC1).
+     */
+    uint32_t getControllability(uint32_t gate, bool value) const {
+        return value ? this->cc1[gate] : this->cc0[gate];
+    }
+
+    /**
+     * @brief Get the observability of the output of a gate (CO).
+     */
+    uint32_t getObservability(uint32_t gate) const {
+        return this->co[gate];
+    }
+
+    /**
+     * @brief Get the observability of an input of a gate, the fanout branch of its fanin gate.
+     * 
+     * @param gate The index of the gate
+     * @param position The position of the input in the inputs of the gate, sorted by port
+     */
+    uint32_t getInputObservability(uint32_t gate, size_t position) const {
+        return this->inputCo[this->circuit->faninOffsets[gate] + position];
+    }
+
+    /**
+     * @brief Get the cost of a test of a stuck-at fault: the controllability of the opposite of the stuck value plus the observability.
+     * 
+     * @param gate The index of the faulty gate
+     * @param value The value the output of the gate must have in the good circuit
+     */
+    uint32_t getDetectionCost(uint32_t gate, bool value) const;
+
+    /**
+     * @brief Write the measures of all the gates, one line per gate with its netlist name, CC0, CC1 and CO ("-" for Infinity).
+     * 
+     * @param stream The stream to write to
+     */
+    void write(std::ostream& stream) const;
+
+private:
+    /**
+     * @brief Partial assignment of the inputs of a cell: bit i of mask is set if the input i is assigned, to bit i of values.
+     */
+    struct Cube {
+        uint32_t mask;
+        uint32_t values;
+    };
+
+    /**
+     * @brief Minimal cubes of a kind of cell, setting its output to 0 and to 1, and making its output depend on each input.
+     */
+    struct CellCubes {
+        bool built = false;
+        std::vector<Cube> implicants[2];
+        std::vector<std::vector<Cube>> sensitizing;
+    };
+
+    std::shared_ptr<const CompiledCircuit> circuit;
+
+    std::vector<uint32_t> cc0;
+    std::vector<uint32_t> cc1;
+    std::vector<uint32_t> co;
+
+    /**
+     * @brief Observability of each input of each gate, in the layout of CompiledCircuit::fanins.
+     */
+    std::vector<uint32_t> inputCo;
+
+    /**
+     * @brief Cubes of each kind of cell, indexed by CellKind.
+     */
+    std::vector<CellCubes> cubes;
+
+    /**
+     * @brief Enumerate the minimal cubes of a kind of cell with at most 6 inputs.
+     */
+    static void buildCubes(CellKind kind, CellCubes& cell_cubes);
+
+    /**
+     * @brief Cost of the assignment of the inputs of a gate to a cube, the sum of the controllabilities of the assigned values.
+     */
+    uint32_t getCubeCost(uint32_t gate, const Cube& cube) const;
+
+    /**
+     * @brief Cost of the select inputs of a multiplexer to route the data input data, except the select input skipped.
+     */
+    uint32_t getSelectCost(uint32_t gate, size_t data_count, size_t select_count, size_t data, size_t skipped) const;
+
+    void computeControllability(uint32_t gate);
+    void computeInputObservability(uint32_t gate);
+};
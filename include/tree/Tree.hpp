@@ -29,7 +29,10 @@
 #pragma once
 
 #include <vector>
+#include <map>
+#include <string>
 #include <memory>
+#include <unordered_map>
 #include "Node.hpp"
 
 /**
@@ -68,6 +71,32 @@ public:
      */
     std::vector<std::shared_ptr<Node>> OutputList;
 
+    /**
+     * @brief List of all nodes in topological order (each node comes after all its parents), computed by levelize().
+     */
+    std::vector<std::shared_ptr<Node>> OrderedNodeList;
+
+    /**
+     * @brief Nodes of the circuit grouped by logic level, computed by levelize().
+     * 
+     * LevelList[i] contains the nodes of level i, in topological order.
+     */
+    std::vector<std::vector<std::shared_ptr<Node>>> LevelList;
+
+    /**
+     * @brief Circuit model tree of each module instanciated by the top-level module, built once and shared by its instances.
+     * 
+     * The trees are levelized, with the ports of the module as inputs and outputs.
+     */
+    std::map<std::string, std::shared_ptr<Tree>> ModuleTrees;
+
+    /**
+     * @brief Hierarchical name and module of each instance of the top-level module.
+     * 
+     * The nodes of an instance have the netlist name of the matching node of the module tree, prefixed by the hierarchical name of the instance.
+     */
+    std::vector<std::pair<std::string, std::string>> InstanceList;
+
     /**
      * @brief Constructor for Tree.
      * @param name Name of the tree/circuit
@@ -104,6 +133,7 @@ public:
 
     /**
      * @brief Retrieves a node in the tree by its unique identifier.
+     * @note Constant time lookup, the nodes are indexed when they are added to the tree.
      * @param identifier Unique identifier of the node to be retrieved.
      * @return Shared pointer to the requested Node.
      */
@@ -119,4 +149,20 @@ public:
     void resetPortValue();
 
     void printPortValues();
+
+    /**
+     * @brief Computes the logic level of each node, the topological order and the level buckets of the circuit.
+     * 
+     * Kahn's algorithm is used, without recursion. The result is cached in the @link Node::level @endlink member of each node, 
+     * and in the @link OrderedNodeList @endlink and @link LevelList @endlink members. It must be called again if the circuit is modified.
+     * 
+     * @return false if the circuit contains a combinational loop (the nodes of the loop are then left out of the order).
+     */
+    bool levelize();
+
+private:
+    /**
+     * @brief Index of the nodes by identifier, used by getNodeByIdentifier().
+     */
+    std::unordered_map<size_t, std::shared_ptr<Node>> NodeIndex;
 };
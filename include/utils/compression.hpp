@@ -0,0 +1,119 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+/**
+ * @file compression.hpp
+ * @brief Selection of the compression format of input and output files from their suffix.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+
+/**
+ * @namespace Compression
+ * @brief Transparent gzip and bzip2 (de)compression of the streamed files
+ */
+namespace Compression {
+    /**
+     * @brief Compression formats of the input and output files
+     */
+    enum class Format {
+        None,
+        Gzip,
+        Bzip2
+    };
+
+    /**
+     * @brief Get the compression format of a file from its suffix ('.gz' or '.bz2')
+     * 
+     * @param filename The name of the file
+     * @return The compression format, Format::None if the file is not compressed
+     */
+    inline Format getFormat(const std::string& filename) {
+        auto endsWith = [&filename](const std::string& suffix) {
+            return filename.size() > suffix.size() && filename.compare(filename.size()-suffix.size(), suffix.size(), suffix) == 0;
+        };
+
+        if (endsWith(".gz")) return Format::Gzip;
+        if (endsWith(".bz2")) return Format::Bzip2;
+        return Format::None;
+    }
+
+    /**
+     * @brief Get the file suffix of a compression format
+     * 
+     * @param format The compression format
+     * @return The suffix, with its leading dot ("" for Format::None)
+     */
+    inline std::string getSuffix(Format format) {
+        switch (format) {
+            case Format::Gzip: return ".gz";
+            case Format::Bzip2: return ".bz2";
+            default: return "";
+        }
+    }
+
+    /**
+     * @brief Remove the compression suffix of a file name, if any
+     * 
+     * @param filename The name of the file
+     * @return The name of the file without its compression suffix
+     */
+    inline std::string removeSuffix(const std::string& filename) {
+        return filename.substr(0, filename.size() - getSuffix(getFormat(filename)).size());
+    }
+
+    /**
+     * @brief Add the decompressor of a format to an input stream chain (nothing for Format::None)
+     * 
+     * @param stream The input stream chain, to which the file source is pushed afterwards
+     * @param format The compression format of the file
+     */
+    inline void pushDecompressor(boost::iostreams::filtering_istream& stream, Format format) {
+        if (format == Format::Gzip) {
+            stream.push(boost::iostreams::gzip_decompressor());
+        } else if (format == Format::Bzip2) {
+            stream.push(boost::iostreams::bzip2_decompressor());
+        }
+    }
+
+    /**
+     * @brief Add the compressor of a format to an output stream chain (nothing for Format::None)
+     * 
+     * @param stream The output stream chain, to which the file sink is pushed afterwards
+     * @param format The compression format of the file
+     */
+    inline void pushCompressor(boost::iostreams::filtering_ostream& stream, Format format) {
+        if (format == Format::Gzip) {
+            stream.push(boost::iostreams::gzip_compressor());
+        } else if (format == Format::Bzip2) {
+            stream.push(boost::iostreams::bzip2_compressor());
+        }
+    }
+} // namespace Compression
@@ -35,8 +35,14 @@
 #include <chrono>
 #include <ctime>
 #include <map>
+#include <array>
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/file.hpp>
 
 #include "../tree/Tree.hpp"
+#include "../tree/PatternSet.hpp"
+#include "../utils/compression.hpp"
 
 using namespace std;
 
@@ -57,9 +63,9 @@ class Writer {
          std::string fileName;
 
          /**
-         * @brief Output file stream
+         * @brief Output file stream, compressing the content if the file is compressed
          */
-         std::ofstream file;
+         boost::iostreams::filtering_ostream file;
       
 
     public:
@@ -68,8 +74,9 @@ class Writer {
          * 
          * @param _filename the name of the file
          * @param _filetype the extension type of the output file
+         * @param _compression the compression format of the output file, its suffix is added to the file name
          */
-        Writer(std::string _filename, std::string _filetype);
+        Writer(std::string _filename, std::string _filetype, Compression::Format _compression = Compression::Format::None);
 
         /**
          * @brief Destroy the Writer object
@@ -103,9 +110,10 @@ class Writer {
         /**
          * @brief Pure virtual method to write the vectors in the output file
          * 
-         * @param vectors_test A shared pointer to the vector containing all the pair of input/output vectors
+         * @param tree The circuit model tree, whose input and output lists are in the order of the patterns
+         * @param vectors_test A shared pointer to the pattern set of the test vectors
          */
-        virtual void writeVectors(std::shared_ptr<std::vector<std::pair<std::vector<std::pair<std::shared_ptr<Node>, int>> , std::vector<std::pair<std::shared_ptr<Node>, int>>>>> vectors_test) = 0;
+        virtual void writeVectors(std::shared_ptr<Tree> tree, std::shared_ptr<PatternSet> vectors_test) = 0;
 
         /**
          * @brief Write the coverage statistics in the dedicated file
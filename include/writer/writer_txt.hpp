@@ -39,7 +39,7 @@ class WriterTXT : public Writer {
         /**
          * @brief Default constructor for the WriterTXT class.
          */
-        WriterTXT(std::string _filename, std::string _filetype);
+        WriterTXT(std::string _filename, std::string _filetype, Compression::Format _compression = Compression::Format::None);
 
         /**
          * @brief Format the output file
@@ -60,9 +60,10 @@ class WriterTXT : public Writer {
         /**
          * @brief Write the vectors in the output file
          * 
-         * @param vectors_test A shared pointer to the vector containing all the pair of input/output vectors
+         * @param tree The circuit model tree, whose input and output lists are in the order of the patterns
+         * @param vectors_test A shared pointer to the pattern set of the test vectors
          */
-        void writeVectors(std::shared_ptr<std::vector<std::pair<std::vector<std::pair<std::shared_ptr<Node>, int>> , std::vector<std::pair<std::shared_ptr<Node>, int>>>>> vectors_test) override;
+        void writeVectors(std::shared_ptr<Tree> tree, std::shared_ptr<PatternSet> vectors_test) override;
 
         /**
          * @brief Write the coverage statistics in the dedicated file
@@ -25,7 +25,7 @@
 
 ATPGTop::ATPGTop() : reader(this->filename, this->extension_type), fault_decorator() {
     this->fault_list = make_shared<vector<pair<shared_ptr<Fault>, shared_ptr<Node>>>>();
-    this->vectors_test = make_shared<vector<pair<vector<pair<shared_ptr<Node>, int>> , vector<pair<shared_ptr<Node>, int>>>>>();
+    this->vectors_test = make_shared<PatternSet>();
     this->tree = make_shared<Tree>("tree");
     this->faultCount = make_shared<vector<array<int, 2>>>();
     for (int j = 0; j < static_cast<int>(FaultModelType::Count); ++j) {
@@ -34,18 +34,71 @@ ATPGTop::ATPGTop() : reader(this->filename, this->extension_type), fault_decorat
     }
 
     this->failureFault = make_shared<vector<tuple<shared_ptr<Fault>, string, string>>>();
+
+    this->random_source = "random";
+    this->random_pattern_limit = 8192;
+    this->random_min_gain = 0.1;
+    this->static_learning = false;
+    this->recursive_learning_depth = 1;
+    this->dominator_sensitization = true;
+    this->decision_limit = 1000;
+    this->time_limit = 1;
+    this->dynamic_compaction_limit = 0;
+    this->static_compaction_limit = 1024;
+    this->reverse_order_reduction = false;
+    this->x_fill = "none";
+    this->fault_engine = "ppsfp";
+    this->thread_count = max(1u, thread::hardware_concurrency());
+    this->sim_kernel = "auto";
+    this->kernel_type = KernelType::Generic;
 };
 
 void ATPGTop::initialize() {
 
-    // Check if the specified extension match the current filename
-    if (this->filename.substr(this->filename.length()-(this->extension_type.length()+1)) != ("."+this->extension_type)) {
+    // Check if the specified extension match the current filename (compressed files end with '.gz' or '.bz2')
+    const string netlist_filename = Compression::removeSuffix(this->filename);
+    if (netlist_filename.substr(netlist_filename.length()-(this->extension_type.length()+1)) != ("."+this->extension_type)) {
         cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": specified file extension '" + this->extension_type + "' does not match the current input file extension '" + this->filename + "'" << endl;
         exit(1);
     }
 
     this->tree->srcName = this->filename.substr(this->filename.find_last_of('/')+1);
 
+    // Check the generator of the random patterns
+    PatternSource source;
+    if (this->random_source != "none" && !RandomPatternGenerator::getSource(this->random_source, source)) {
+        cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": unknown random pattern generator '" + this->random_source + "' (expected 'random', 'lfsr' or 'none')" << endl;
+        exit(1);
+    }
+
+    // Check the fill of the unspecified inputs
+    FillMode fill_mode;
+    if (!XFill::getMode(this->x_fill, fill_mode)) {
+        cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": unknown X-fill '" + this->x_fill + "' (expected 'none', '0', '1', 'random', 'adjacent' or 'best')" << endl;
+        exit(1);
+    }
+
+    // Check the fault simulation engine
+    FaultSimulationEngine engine;
+    if (!FaultSimulator::getEngine(this->fault_engine, engine)) {
+        cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": unknown fault simulation engine '" + this->fault_engine + "' (expected 'ppsfp', 'deductive', 'concurrent' or 'cpt')" << endl;
+        exit(1);
+    }
+
+    // Check the simulation kernel
+    KernelType kernel_type;
+    if (!SimulationKernel::getKernelType(this->sim_kernel, kernel_type)) {
+        cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": unknown simulation kernel '" + this->sim_kernel + "' (expected 'auto', 'generic', 'avx2', 'avx512' or 'compiled')" << endl;
+        exit(1);
+    }
+    if (!SimulationKernel::isSupported(kernel_type)) {
+        cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": simulation kernel '" + this->sim_kernel + "' not supported by this CPU or this build" << endl;
+        exit(1);
+    }
+    // The same kernel is used by all the phases, so that the results don't depend on when the choice is made
+    this->kernel_type = SimulationKernel::resolve(kernel_type);
+    cout << "\t" << strings["progress"]["sim_kernel"].get<string>() << SimulationKernel::getTypeName(this->kernel_type) << endl;
+
     // Creating the output directory if it doesn't already exist
     try {
         if(!filesystem::exists(this->output_dir_path)) {
@@ -55,6 +108,12 @@ void ATPGTop::initialize() {
         cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": problem occurs when creating output directory: " << ex.what() << "\n";
     }
 
+    // The output files are compressed if their name ends with '.gz' or '.bz2'
+    const Compression::Format cov_compression = Compression::getFormat(this->cov_output_filename);
+    this->cov_output_filename = Compression::removeSuffix(this->cov_output_filename);
+    const Compression::Format vect_compression = Compression::getFormat(this->vect_output_filename);
+    this->vect_output_filename = Compression::removeSuffix(this->vect_output_filename);
+
     // Find the last occurrence of the dot (.)
     size_t dotPos = this->cov_output_filename.find_last_of('.');
 
@@ -115,39 +174,243 @@ void ATPGTop::initialize() {
 
     // Instanciate the coverage output file writer
     if (this->cov_output_file_ext == "txt") {
-        this->covOutputFileWriter = make_shared<WriterTXT>(this->cov_output_filename, this->cov_output_file_ext);
+        this->covOutputFileWriter = make_shared<WriterTXT>(this->cov_output_filename, this->cov_output_file_ext, cov_compression);
     } else if (this->cov_output_file_ext == "json") {
-        this->covOutputFileWriter = make_shared<WriterJSON>(this->cov_output_filename, this->cov_output_file_ext);
+        this->covOutputFileWriter = make_shared<WriterJSON>(this->cov_output_filename, this->cov_output_file_ext, cov_compression);
     } else { // Default coverage output file if the extension is unknown or unsupported is .txt
         cout << ORANGE_TEXT << BOLD_TEXT << "Warning" << RESET_TEXT  << ": output format '" + this->cov_output_file_ext + "' is not supported for coverage output file\n\t Using default '.txt' extension format instead" << endl;
         this->cov_output_file_ext = "txt";
-        this->covOutputFileWriter = make_shared<WriterTXT>(this->cov_output_filename, this->cov_output_file_ext);
+        this->covOutputFileWriter = make_shared<WriterTXT>(this->cov_output_filename, this->cov_output_file_ext, cov_compression);
     }
 
-    // Instanciate the vectors output file writer
-    if (this->vect_output_file_ext == "txt") {
-        this->vectOutputFileWriter = make_shared<WriterTXT>(this->vect_output_filename, this->vect_output_file_ext);
-    } else if (this->vect_output_file_ext == "json") {
-        this->vectOutputFileWriter = make_shared<WriterJSON>(this->vect_output_filename, this->vect_output_file_ext);
-    } else { // Default vector output file if the extension is unknown or unsupported is .txt
-        cout << ORANGE_TEXT << BOLD_TEXT << "Warning" << RESET_TEXT << ": output format '" + this->vect_output_file_ext + "' is not supported for test vectors output file\n\t Using default '.txt' extension format instead" << endl;
-        this->vect_output_file_ext = "txt";
-        this->vectOutputFileWriter = make_shared<WriterTXT>(this->vect_output_filename, this->vect_output_file_ext);
+    // Instanciate the vectors output file writer, no vector file being written when grading vectors
+    if (this->grade_filename.empty()) {
+        if (this->vect_output_file_ext == "txt") {
+            this->vectOutputFileWriter = make_shared<WriterTXT>(this->vect_output_filename, this->vect_output_file_ext, vect_compression);
+        } else if (this->vect_output_file_ext == "json") {
+            this->vectOutputFileWriter = make_shared<WriterJSON>(this->vect_output_filename, this->vect_output_file_ext, vect_compression);
+        } else { // Default vector output file if the extension is unknown or unsupported is .txt
+            cout << ORANGE_TEXT << BOLD_TEXT << "Warning" << RESET_TEXT << ": output format '" + this->vect_output_file_ext + "' is not supported for test vectors output file\n\t Using default '.txt' extension format instead" << endl;
+            this->vect_output_file_ext = "txt";
+            this->vectOutputFileWriter = make_shared<WriterTXT>(this->vect_output_filename, this->vect_output_file_ext, vect_compression);
+        }
     }
 };
 
 void ATPGTop::read() {
     this->reader.read(this->filename, this->extension_type, this->tree);
+    this->circuit = make_shared<CompiledCircuit>(this->tree);
+    this->testability = make_shared<Testability>(this->circuit);
+};
+
+void ATPGTop::write_testability() {
+    const string filename = this->output_dir_path + this->testability_filename;
+    ofstream file(filename);
+    if (!file.is_open()) {
+        cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": file '" + filename + "' can't be opened" << endl;
+        exit(1);
+    }
+    this->testability->write(file);
 };
 
 void ATPGTop::generate_vector(){
-    *(this->vectors_test) = FaultAPI::generateVectorError(this -> fault_list, this -> tree);
+    // Faults targeted by the deterministic generation
+    shared_ptr<vector<pair<shared_ptr<Fault>, shared_ptr<Node>>>> hard_faults = this->fault_list;
+    *this->vectors_test = PatternSet(this->tree->InputList.size(), this->tree->OutputList.size());
+
+    FaultSimulationEngine engine;
+    FaultSimulator::getEngine(this->fault_engine, engine);
+
+    PatternSource source;
+    if (RandomPatternGenerator::getSource(this->random_source, source)) {
+        RandomPatternPhase phase(this->circuit, this->kernel_type, source, this->random_pattern_limit, this->random_min_gain, engine, this->thread_count);
+        const vector<StuckAtFault> faults = FaultSimulator::getStuckAtFaults(*this->circuit, *this->fault_list);
+        vector<long> first_detection(faults.size(), -1);
+        phase.run(faults, first_detection);
+
+        // The kept random patterns come first
+        *this->vectors_test = phase.getPatterns();
+
+        hard_faults = make_shared<vector<pair<shared_ptr<Fault>, shared_ptr<Node>>>>();
+        for (size_t i = 0; i < faults.size(); ++i) {
+            if (first_detection[i] >= 0) {
+                (*this->fault_list)[i].first->setCovered();
+            } else {
+                hard_faults->push_back((*this->fault_list)[i]);
+            }
+        }
+    }
+
+    // The hardest faults are targeted first, the easier ones being likely to be tested by their vectors as secondary faults
+    hard_faults = make_shared<vector<pair<shared_ptr<Fault>, shared_ptr<Node>>>>(*hard_faults);
+    vector<uint32_t> costs;
+    for (const pair<shared_ptr<Fault>, shared_ptr<Node>>& fault : *hard_faults) {
+        costs.push_back(this->testability->getDetectionCost(this->circuit->getIndex(fault.second->getIdentifier()), fault.first->getValue()));
+    }
+    vector<size_t> order(hard_faults->size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&costs](size_t a, size_t b) { return costs[a] > costs[b]; });
+    vector<pair<shared_ptr<Fault>, shared_ptr<Node>>> ordered_faults;
+    for (size_t i : order) ordered_faults.push_back((*hard_faults)[i]);
+    *hard_faults = ordered_faults;
+
+    FaultAPI::DecisionContext context;
+    context.testability = this->testability;
+    if (this->dominator_sensitization) context.dominators = this->circuit;
+    if (this->static_learning && !hard_faults->empty()) {
+        this->learned_implications = make_shared<LearnedImplications>(this->circuit, *this->tree);
+        context.implications = this->learned_implications;
+        cout << "\t" << strings["progress"]["static_learning"].get<string>() << this->learned_implications->getCount() << strings["progress"]["implications_learned"].get<string>() << endl;
+    }
+
+    // The deterministic vectors have the values of all the inputs and outputs, in the order of the input and output lists
+    FaultAPI::EffortLimit limit;
+    limit.decisions = this->decision_limit;
+    limit.seconds = this->time_limit;
+    vector<pair<vector<pair<shared_ptr<Node>, int>> , vector<pair<shared_ptr<Node>, int>>>> deterministic_vectors = FaultAPI::generateVectorError(hard_faults, this -> tree, this -> circuit, this->dynamic_compaction_limit, &context, &limit);
+
+    // Retry queue: the aborted faults are targeted again with ten times the effort, then by the hard fault phase
+    FaultAPI::EffortLimit retry_limit;
+    retry_limit.decisions = limit.decisions * 10;
+    retry_limit.seconds = limit.seconds * 10;
+    shared_ptr<vector<pair<shared_ptr<Fault>, shared_ptr<Node>>>> aborted_faults = make_shared<vector<pair<shared_ptr<Fault>, shared_ptr<Node>>>>();
+    for (const pair<shared_ptr<Fault>, shared_ptr<Node>>& fault : *hard_faults) {
+        if (fault.first->getFailure() && fault.first->getFailureReason() == "ab") {
+            fault.first->clearFailure();
+            aborted_faults->push_back(fault);
+        }
+    }
+    if (!aborted_faults->empty()) {
+        vector<pair<vector<pair<shared_ptr<Node>, int>> , vector<pair<shared_ptr<Node>, int>>>> retry_vectors = FaultAPI::generateVectorError(aborted_faults, this->tree, this->circuit, this->dynamic_compaction_limit, &context, &retry_limit);
+        size_t tested_count = 0;
+        for (const pair<shared_ptr<Fault>, shared_ptr<Node>>& fault : *aborted_faults) {
+            tested_count += !fault.first->getFailure();
+        }
+        cout << "\t" << strings["progress"]["retry"].get<string>() << tested_count << "/" << aborted_faults->size() << strings["progress"]["retry_tested"].get<string>() << endl;
+        deterministic_vectors.insert(deterministic_vectors.end(), retry_vectors.begin(), retry_vectors.end());
+    }
+
+    // Hard fault phase: the conflicts and the aborted faults are targeted again with the values found by recursive learning
+    if (this->recursive_learning_depth > 0) {
+        size_t hard_fault_count = 0;
+        for (const pair<shared_ptr<Fault>, shared_ptr<Node>>& fault : *hard_faults) {
+            hard_fault_count += fault.first->getFailure() && (fault.first->getFailureReason() == "co" || fault.first->getFailureReason() == "ab");
+        }
+        if (hard_fault_count > 0) {
+            vector<pair<vector<pair<shared_ptr<Node>, int>> , vector<pair<shared_ptr<Node>, int>>>> hard_fault_vectors = FaultAPI::generateHardFaultVectors(hard_faults, this->tree, this->circuit, this->recursive_learning_depth, &context, &retry_limit);
+            cout << "\t" << strings["progress"]["hard_fault_phase"].get<string>() << hard_fault_vectors.size() << "/" << hard_fault_count << strings["progress"]["hard_fault_tested"].get<string>() << endl;
+            deterministic_vectors.insert(deterministic_vectors.end(), hard_fault_vectors.begin(), hard_fault_vectors.end());
+        }
+    }
+
+    size_t aborted_count = 0;
+    for (const pair<shared_ptr<Fault>, shared_ptr<Node>>& fault : *hard_faults) {
+        aborted_count += fault.first->getFailure() && fault.first->getFailureReason() == "ab";
+    }
+    if (aborted_count > 0) {
+        cout << "\t" << aborted_count << strings["progress"]["faults_aborted"].get<string>() << endl;
+    }
+
+    for (const auto& vector_test : deterministic_vectors) {
+        const size_t pattern = this->vectors_test->addPattern();
+        for (size_t input = 0; input < vector_test.first.size(); ++input) {
+            this->vectors_test->setInput(pattern, input, vector_test.first[input].second);
+        }
+        for (size_t output = 0; output < vector_test.second.size(); ++output) {
+            this->vectors_test->setOutput(pattern, output, vector_test.second[output].second);
+        }
+    }
+};
+
+void ATPGTop::compact_vector() {
+    FillMode fill_mode;
+    XFill::getMode(this->x_fill, fill_mode);
+    if ((this->static_compaction_limit == 0 && !this->reverse_order_reduction && fill_mode == FillMode::None) || this->vectors_test->getPatternCount() == 0) return;
+
+    FaultSimulationEngine engine;
+    FaultSimulator::getEngine(this->fault_engine, engine);
+
+    StaticCompactor compactor(this->circuit, this->kernel_type, engine, this->thread_count);
+    const vector<StuckAtFault> faults = FaultSimulator::getStuckAtFaults(*this->circuit, *this->fault_list);
+    if (this->static_compaction_limit > 0) {
+        compactor.compact(*this->vectors_test, faults, this->static_compaction_limit);
+    }
+
+    // The fill comes after the merge, which needs the unspecified inputs, and before the reverse order reduction, which benefits from its fortuitous detections
+    if (fill_mode != FillMode::None) {
+        XFill filler(this->circuit, this->kernel_type, engine, this->thread_count);
+        if (fill_mode == FillMode::Best) {
+            fill_mode = filler.fillBest(*this->vectors_test, faults);
+        } else {
+            filler.fill(*this->vectors_test, fill_mode);
+        }
+        const FillScore score = filler.score(*this->vectors_test, faults);
+        cout << "\t" << strings["progress"]["x_fill"].get<string>() << " '" << XFill::getName(fill_mode) << "': " << score.detected << strings["progress"]["faults_detected"].get<string>() << score.toggles << strings["progress"]["input_toggles"].get<string>() << endl;
+    }
+    if (this->reverse_order_reduction) {
+        compactor.reduce(*this->vectors_test, faults);
+    }
+
+    // The faults detected fortuitously are covered: by the filled vectors, or by the cubes whatever their unspecified inputs (three-valued fault simulation)
+    vector<long> first_detection(faults.size(), -1);
+    compactor.detect(*this->vectors_test, faults, first_detection);
+    for (size_t i = 0; i < faults.size(); ++i) {
+        if (first_detection[i] >= 0) {
+            (*this->fault_list)[i].first->setCovered();
+            (*this->fault_list)[i].first->clearFailure();
+        }
+    }
+
+    // The expected outputs of the compacted vectors, -1 where they depend on an unspecified input
+    ThreeValuedSimulator simulator(this->circuit, this->kernel_type);
+    const size_t block_words = simulator.getBlockWords();
+    vector<uint64_t> ones(this->circuit->inputs.size() * block_words);
+    vector<uint64_t> zeros(this->circuit->inputs.size() * block_words);
+    for (size_t first = 0; first < this->vectors_test->getPatternCount(); first += simulator.getBlockSize()) {
+        this->vectors_test->getBlock(first, block_words, ones.data(), zeros.data());
+        simulator.simulate(ones.data(), zeros.data());
+
+        const size_t count = min(simulator.getBlockSize(), this->vectors_test->getPatternCount() - first);
+        for (size_t pattern = 0; pattern < count; ++pattern) {
+            for (size_t output = 0; output < this->circuit->outputs.size(); ++output) {
+                this->vectors_test->setOutput(first + pattern, output, simulator.getValue(this->circuit->outputs[output], pattern));
+            }
+        }
+    }
+};
+
+void ATPGTop::grade_vector() {
+    PatternReader reader(this->circuit);
+    reader.read(this->grade_filename);
+
+    FaultSimulationEngine engine;
+    FaultSimulator::getEngine(this->fault_engine, engine);
+
+    FaultSimulator simulator(this->circuit, this->kernel_type, engine, this->thread_count);
+    const vector<StuckAtFault> faults = FaultSimulator::getStuckAtFaults(*this->circuit, *this->fault_list);
+    vector<long> first_detection(faults.size(), -1);
+
+    // The patterns are simulated block by block, the detected faults being dropped
+    vector<uint64_t> block(this->circuit->inputs.size() * simulator.getBlockWords());
+    for (size_t first = 0; first < reader.getPatternCount(); first += simulator.getBlockSize()) {
+        reader.getBlock(first, simulator.getBlockWords(), block.data());
+        simulator.simulateBlock(block.data(), min(simulator.getBlockSize(), reader.getPatternCount() - first), faults, first_detection, first);
+    }
+
+    for (size_t i = 0; i < faults.size(); ++i) {
+        if (first_detection[i] >= 0) {
+            (*this->fault_list)[i].first->setCovered();
+        } else {
+            // Reason of the failure -> "ob" for observability, "nd" for a fault not detected by the patterns
+            (*this->fault_list)[i].first->setFailure(this->circuit->isObservable(faults[i].gate) ? "nd" : "ob");
+        }
+    }
 };
 
 void ATPGTop::write_vector() {
     this->vectOutputFileWriter->formatFile(this->tree);
     this->vectOutputFileWriter->writeIOPort(this->tree);
-    this->vectOutputFileWriter->writeVectors(this->vectors_test);
+    this->vectOutputFileWriter->writeVectors(this->tree, this->vectors_test);
 };
 
 void ATPGTop::write_coverage() {
@@ -163,9 +426,8 @@ void ATPGTop::generate_cov_stats() {
     for (pair<shared_ptr<Fault>, shared_ptr<Node>> pair : *(this->fault_list)) {
         (*faultCount)[static_cast<int>(pair.first->getType())][0]++;
         if (pair.first->getFailure()) {
-            // FIXME: replace "co" dynamically (it represents the reason of the failure -> "co" for controlability, "ob" for observability)
-            // By now, only "co" is possible as we just manage combinatory circuits
-            tuple<shared_ptr<Fault>, string, string> tuple = {pair.first, pair.second->netlistName, "co"};
+            // Reason of the failure -> "co" for controlability, "ob" for observability, "ab" for an aborted generation
+            tuple<shared_ptr<Fault>, string, string> tuple = {pair.first, pair.second->netlistName, pair.first->getFailureReason()};
             this->failureFault->push_back(tuple);
         }
     }
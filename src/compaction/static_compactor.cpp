@@ -0,0 +1,236 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/compaction/static_compactor.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// Whether all the inputs of all the patterns of a set are specified
+bool isSpecified(const PatternSet& patterns) {
+    const size_t words = patterns.getInputWords();
+    const size_t last_bits = patterns.getInputCount() % 64;
+    for (size_t pattern = 0; pattern < patterns.getPatternCount(); ++pattern) {
+        const uint64_t* ones = patterns.getOnes(pattern);
+        const uint64_t* zeros = patterns.getZeros(pattern);
+        for (size_t word = 0; word < words; ++word) {
+            const uint64_t mask = word + 1 == words && last_bits != 0 ? (uint64_t(1) << last_bits) - 1 : ~uint64_t(0);
+            if ((ones[word] | zeros[word]) != mask) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+StaticCompactor::StaticCompactor(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, FaultSimulationEngine engine, size_t thread_count) 
+    : circuit(circuit), simulator(circuit, type, engine, thread_count), cubeSimulator(circuit, type) {}
+
+size_t StaticCompactor::merge(PatternSet& patterns, size_t search_limit) {
+    const size_t words = patterns.getInputWords();
+    const size_t pattern_count = patterns.getPatternCount();
+
+    // The most specified cubes first, as they are the hardest to merge
+    std::vector<size_t> specified(pattern_count, 0);
+    for (size_t pattern = 0; pattern < pattern_count; ++pattern) {
+        const uint64_t* ones = patterns.getOnes(pattern);
+        const uint64_t* zeros = patterns.getZeros(pattern);
+        for (size_t word = 0; word < words; ++word) {
+            specified[pattern] += __builtin_popcountll(ones[word] | zeros[word]);
+        }
+    }
+    std::vector<size_t> order(pattern_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&specified](size_t a, size_t b) { return specified[a] > specified[b]; });
+
+    std::vector<uint64_t> merged_ones;
+    std::vector<uint64_t> merged_zeros;
+    size_t merged_count = 0;
+
+    for (size_t pattern : order) {
+        const uint64_t* ones = patterns.getOnes(pattern);
+        const uint64_t* zeros = patterns.getZeros(pattern);
+
+        // The last merged cubes are the least specified ones, the most likely to be compatible
+        size_t target = merged_count;
+        for (size_t candidate = merged_count; candidate-- > 0 && merged_count - candidate <= search_limit;) {
+            const uint64_t* candidate_ones = merged_ones.data() + candidate * words;
+            const uint64_t* candidate_zeros = merged_zeros.data() + candidate * words;
+            bool compatible = true;
+            for (size_t word = 0; word < words && compatible; ++word) {
+                compatible = ((ones[word] & candidate_zeros[word]) | (zeros[word] & candidate_ones[word])) == 0;
+            }
+            if (compatible) {
+                target = candidate;
+                break;
+            }
+        }
+
+        if (target == merged_count) {
+            merged_ones.insert(merged_ones.end(), ones, ones + words);
+            merged_zeros.insert(merged_zeros.end(), zeros, zeros + words);
+            merged_count++;
+        } else {
+            for (size_t word = 0; word < words; ++word) {
+                merged_ones[target * words + word] |= ones[word];
+                merged_zeros[target * words + word] |= zeros[word];
+            }
+        }
+    }
+
+    PatternSet merged(patterns.getInputCount(), patterns.getOutputCount());
+    for (size_t pattern = 0; pattern < merged_count; ++pattern) {
+        merged.addPattern(merged_ones.data() + pattern * words, merged_zeros.data() + pattern * words);
+    }
+    patterns = std::move(merged);
+    return merged_count;
+}
+
+size_t StaticCompactor::compact(PatternSet& patterns, const std::vector<StuckAtFault>& faults, size_t search_limit) {
+    std::vector<long> original_detection(faults.size(), -1);
+    this->detect(patterns, faults, original_detection);
+    const PatternSet original = patterns;
+
+    this->merge(patterns, search_limit);
+    std::vector<long> merged_detection(faults.size(), -1);
+    this->detect(patterns, faults, merged_detection);
+
+    // A merged cube is more specified than its cubes, so it detects their faults in three-valued logic: the restored cubes only guard the coverage
+    std::vector<long> restored;
+    for (size_t fault = 0; fault < faults.size(); ++fault) {
+        if (original_detection[fault] >= 0 && merged_detection[fault] < 0) {
+            restored.push_back(original_detection[fault]);
+        }
+    }
+    std::sort(restored.begin(), restored.end());
+    restored.erase(std::unique(restored.begin(), restored.end()), restored.end());
+    for (long pattern : restored) {
+        patterns.addPattern(original.getOnes(pattern), original.getZeros(pattern));
+    }
+    return patterns.getPatternCount();
+}
+
+size_t StaticCompactor::reduce(PatternSet& patterns, const std::vector<StuckAtFault>& faults) {
+    const size_t pattern_count = patterns.getPatternCount();
+    std::vector<size_t> order(pattern_count);
+    for (size_t pattern = 0; pattern < pattern_count; ++pattern) {
+        order[pattern] = pattern_count - 1 - pattern;
+    }
+    std::vector<long> first_detection(faults.size(), -1);
+    this->detect(patterns, order, faults, first_detection);
+
+    std::vector<bool> kept(pattern_count, false);
+    for (long position : first_detection) {
+        if (position >= 0) kept[order[position]] = true;
+    }
+
+    // The kept patterns stay in their original order
+    PatternSet reduced(patterns.getInputCount(), patterns.getOutputCount());
+    for (size_t pattern = 0; pattern < pattern_count; ++pattern) {
+        if (!kept[pattern]) continue;
+        const size_t index = reduced.addPattern(patterns.getOnes(pattern), patterns.getZeros(pattern));
+        for (size_t output = 0; output < patterns.getOutputCount(); ++output) {
+            reduced.setOutput(index, output, patterns.getOutput(pattern, output));
+        }
+    }
+    patterns = std::move(reduced);
+    return patterns.getPatternCount();
+}
+
+size_t StaticCompactor::detect(const PatternSet& patterns, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection) {
+    if (!isSpecified(patterns)) {
+        std::vector<size_t> order(patterns.getPatternCount());
+        std::iota(order.begin(), order.end(), 0);
+        return this->detectCubes(patterns, order, faults, first_detection);
+    }
+
+    const size_t block_size = this->simulator.getBlockSize();
+    const size_t block_words = this->simulator.getBlockWords();
+    std::vector<uint64_t> block(patterns.getInputCount() * block_words);
+
+    size_t detected = 0;
+    for (size_t first = 0; first < patterns.getPatternCount(); first += block_size) {
+        patterns.getBlock(first, block_words, block.data());
+        detected += this->simulator.simulateBlock(block.data(), std::min(block_size, patterns.getPatternCount() - first), faults, first_detection, first);
+    }
+    return detected;
+}
+
+size_t StaticCompactor::detect(const PatternSet& patterns, const std::vector<size_t>& order, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection) {
+    if (!isSpecified(patterns)) {
+        return this->detectCubes(patterns, order, faults, first_detection);
+    }
+
+    const size_t input_count = patterns.getInputCount();
+    const size_t block_size = this->simulator.getBlockSize();
+    const size_t block_words = this->simulator.getBlockWords();
+    std::vector<uint64_t> block(input_count * block_words);
+
+    size_t detected = 0;
+    for (size_t first = 0; first < order.size(); first += block_size) {
+        const size_t pattern_count = std::min(block_size, order.size() - first);
+        std::fill(block.begin(), block.end(), 0);
+        for (size_t bit = 0; bit < pattern_count; ++bit) {
+            const uint64_t* ones = patterns.getOnes(order[first + bit]);
+            for (size_t input = 0; input < input_count; ++input) {
+                block[input * block_words + bit / 64] |= ((ones[input / 64] >> (input % 64)) & 1) << (bit % 64);
+            }
+        }
+        detected += this->simulator.simulateBlock(block.data(), pattern_count, faults, first_detection, first);
+    }
+    return detected;
+}
+
+size_t StaticCompactor::detectCubes(const PatternSet& patterns, const std::vector<size_t>& order, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection) {
+    std::vector<int> cube(patterns.getInputCount());
+    std::vector<size_t> undetected;
+    for (size_t fault = 0; fault < faults.size(); ++fault) {
+        if (first_detection[fault] < 0) undetected.push_back(fault);
+    }
+
+    size_t detected = 0;
+    std::vector<StuckAtFault> cube_faults;
+    std::vector<bool> cube_detected;
+    for (size_t position = 0; position < order.size() && !undetected.empty(); ++position) {
+        for (size_t input = 0; input < cube.size(); ++input) {
+            cube[input] = patterns.getInput(order[position], input);
+        }
+        cube_faults.clear();
+        for (size_t fault : undetected) cube_faults.push_back(faults[fault]);
+        this->cubeSimulator.detect(cube, cube_faults, cube_detected);
+
+        size_t still_undetected = 0;
+        for (size_t i = 0; i < undetected.size(); ++i) {
+            if (cube_detected[i]) {
+                first_detection[undetected[i]] = position;
+                detected++;
+            } else {
+                undetected[still_undetected++] = undetected[i];
+            }
+        }
+        undetected.resize(still_undetected);
+    }
+    return detected;
+}
@@ -0,0 +1,165 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/compaction/x_fill.hpp"
+
+#include <algorithm>
+#include <random>
+
+bool XFill::getMode(const std::string& name, FillMode& mode) {
+    static const std::vector<std::pair<std::string, FillMode>> modes = {
+        {"none", FillMode::None}, {"0", FillMode::Zero}, {"1", FillMode::One}, 
+        {"random", FillMode::Random}, {"adjacent", FillMode::Adjacent}, {"best", FillMode::Best}
+    };
+    for (const auto& known : modes) {
+        if (known.first == name) {
+            mode = known.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string XFill::getName(FillMode mode) {
+    switch (mode) {
+        case FillMode::Zero: return "0";
+        case FillMode::One: return "1";
+        case FillMode::Random: return "random";
+        case FillMode::Adjacent: return "adjacent";
+        case FillMode::Best: return "best";
+        default: return "none";
+    }
+}
+
+XFill::XFill(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, FaultSimulationEngine engine, size_t thread_count, uint64_t seed) : simulator(circuit, type, engine, thread_count), seed(seed) {}
+
+void XFill::fill(PatternSet& patterns, FillMode mode) {
+    if (mode == FillMode::None || mode == FillMode::Best) return;
+
+    const size_t words = patterns.getInputWords();
+    const size_t input_count = patterns.getInputCount();
+    std::mt19937_64 generator(this->seed);
+    std::vector<uint64_t> ones(words);
+    std::vector<uint64_t> zeros(words);
+
+    for (size_t pattern = 0; pattern < patterns.getPatternCount(); ++pattern) {
+        std::copy(patterns.getOnes(pattern), patterns.getOnes(pattern) + words, ones.begin());
+        std::copy(patterns.getZeros(pattern), patterns.getZeros(pattern) + words, zeros.begin());
+
+        if (mode == FillMode::Adjacent) {
+            // Each unspecified input takes the value of the previous specified one, the leading ones the value of the first specified one
+            int previous = -1;
+            for (size_t input = 0; input < input_count && previous < 0; ++input) {
+                if ((ones[input / 64] >> (input % 64)) & 1) previous = 1;
+                else if ((zeros[input / 64] >> (input % 64)) & 1) previous = 0;
+            }
+            if (previous < 0) previous = 0;
+            for (size_t word = 0; word < words; ++word) {
+                uint64_t care = ones[word] | zeros[word];
+                // Whole words are filled at once when they are unspecified
+                if (care == 0) {
+                    if (previous) ones[word] = ~uint64_t(0);
+                    else zeros[word] = ~uint64_t(0);
+                    continue;
+                }
+                for (size_t bit = 0; bit < 64; ++bit) {
+                    const uint64_t mask = uint64_t(1) << bit;
+                    if (care & mask) {
+                        previous = (ones[word] & mask) != 0;
+                    } else if (previous) {
+                        ones[word] |= mask;
+                    } else {
+                        zeros[word] |= mask;
+                    }
+                }
+            }
+        } else {
+            for (size_t word = 0; word < words; ++word) {
+                const uint64_t unspecified = ~(ones[word] | zeros[word]);
+                const uint64_t value = mode == FillMode::One ? ~uint64_t(0) : mode == FillMode::Zero ? 0 : generator();
+                ones[word] |= unspecified & value;
+                zeros[word] |= unspecified & ~value;
+            }
+        }
+
+        // The bits after the last input stay unspecified
+        if (input_count % 64) {
+            const uint64_t valid = (uint64_t(1) << (input_count % 64)) - 1;
+            ones[words - 1] &= valid;
+            zeros[words - 1] &= valid;
+        }
+        patterns.setPattern(pattern, ones.data(), zeros.data());
+    }
+}
+
+FillMode XFill::fillBest(PatternSet& patterns, const std::vector<StuckAtFault>& faults) {
+    FillMode best = FillMode::Zero;
+    FillScore best_score = {0, 0};
+    PatternSet best_patterns;
+    for (FillMode mode : {FillMode::Zero, FillMode::One, FillMode::Random, FillMode::Adjacent}) {
+        PatternSet filled = patterns;
+        this->fill(filled, mode);
+        const FillScore filled_score = this->score(filled, faults);
+        if (mode == FillMode::Zero || filled_score.detected > best_score.detected || 
+            (filled_score.detected == best_score.detected && filled_score.toggles < best_score.toggles)) {
+            best = mode;
+            best_score = filled_score;
+            best_patterns = std::move(filled);
+        }
+    }
+    patterns = std::move(best_patterns);
+    return best;
+}
+
+FillScore XFill::score(const PatternSet& patterns, const std::vector<StuckAtFault>& faults) {
+    const size_t block_size = this->simulator.getBlockSize();
+    const size_t block_words = this->simulator.getBlockWords();
+    std::vector<uint64_t> block(patterns.getInputCount() * block_words);
+    std::vector<long> first_detection(faults.size(), -1);
+
+    FillScore result = {0, countToggles(patterns)};
+    for (size_t first = 0; first < patterns.getPatternCount(); first += block_size) {
+        patterns.getBlock(first, block_words, block.data());
+        result.detected += this->simulator.simulateBlock(block.data(), std::min(block_size, patterns.getPatternCount() - first), faults, first_detection, first);
+    }
+    return result;
+}
+
+size_t XFill::countToggles(const PatternSet& patterns) {
+    const size_t words = patterns.getInputWords();
+    const size_t input_count = patterns.getInputCount();
+    size_t toggles = 0;
+    for (size_t pattern = 0; pattern < patterns.getPatternCount(); ++pattern) {
+        const uint64_t* ones = patterns.getOnes(pattern);
+        for (size_t word = 0; word < words; ++word) {
+            // Input i is compared to input i-1, the first input of the word to the last one of the previous word
+            const uint64_t previous = (ones[word] << 1) | (word > 0 ? ones[word - 1] >> 63 : ones[0] & 1);
+            uint64_t transitions = ones[word] ^ previous;
+            if (word == words - 1 && input_count % 64) {
+                transitions &= (uint64_t(1) << (input_count % 64)) - 1;
+            }
+            toggles += __builtin_popcountll(transitions);
+        }
+    }
+    return toggles;
+}
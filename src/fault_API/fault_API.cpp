@@ -23,6 +23,9 @@
 
 #include "../../include/fault_API/fault_API.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 namespace FaultAPI {
 
 std::pair< std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> get_vector_error(int value, shared_ptr<Tree> tree, shared_ptr<Node> node, int port_number){
@@ -80,31 +83,39 @@ std::pair< std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair
 }
 
 void computeValue(std::vector<std::pair<shared_ptr<Node>, int>> &input_vector, std::vector<std::pair<shared_ptr<Node>, int>> &output_vector, shared_ptr<Node> node, int value, int input_number){
-    //check if the node is an input or an output
-    if (node -> type == "Input") {
-        //if it is an input : add it to the return list 
-        input_vector.push_back(std::make_pair(node, value));
-    }
-    else if (node -> type == "Output"){
-        output_vector.push_back(std::make_pair(node, value));
-    }
-    
-    else {
-        //not output or input, so we have to compute it 
-        if (input_number == -1){
-            //case it is an output, so we have to compute the input value 
-            std::vector<std::pair<std::shared_ptr<Node>, int>> result_ComputeInputFromOutput = node -> computeInputFromOutput(value); 
-            //propagate the value
-            for (std::pair<std::shared_ptr<Node>, int> pair : result_ComputeInputFromOutput){ //for each input
-                computeValue(input_vector, output_vector, pair.first, pair.second, -1); //-1 because we need to say it is will be an output
-            }
+    //explicit stack instead of recursion, deep circuits would overflow the call stack
+    //the results are pushed in reverse order so the nodes are visited in the same depth-first order
+    std::vector<std::tuple<std::shared_ptr<Node>, int, int>> stack;
+    stack.push_back(std::make_tuple(node, value, input_number));
+
+    while (!stack.empty()){
+        std::tie(node, value, input_number) = stack.back();
+        stack.pop_back();
+
+        //check if the node is an input or an output
+        if (node -> type == "Input") {
+            //if it is an input : add it to the return list 
+            input_vector.push_back(std::make_pair(node, value));
+        }
+        else if (node -> type == "Output"){
+            output_vector.push_back(std::make_pair(node, value));
         }
+        
         else {
-            //case it is an input
-            std::vector<std::tuple<std::shared_ptr<Node>, int, int>> result_ComputeExpectedValue = node -> computeExpectedValue(value, input_number);
-            //propagate the compute
-            for (std::tuple<std::shared_ptr<Node>, int, int> tuple : result_ComputeExpectedValue){
-                computeValue(input_vector, output_vector, std::get<0>(tuple), std::get<1>(tuple), std::get<2>(tuple)); //I need to make get2 beiing the input_number
+            //not output or input, so we have to compute it 
+            if (input_number == -1){
+                //case it is an output, so we have to compute the input value 
+                std::vector<std::pair<std::shared_ptr<Node>, int>> result_ComputeInputFromOutput = node -> computeInputFromOutput(value); 
+                //propagate the value
+                for (auto pair = result_ComputeInputFromOutput.rbegin(); pair != result_ComputeInputFromOutput.rend(); ++pair){ //for each input
+                    stack.push_back(std::make_tuple(pair -> first, pair -> second, -1)); //-1 because we need to say it is will be an output
+                }
+            }
+            else {
+                //case it is an input
+                std::vector<std::tuple<std::shared_ptr<Node>, int, int>> result_ComputeExpectedValue = node -> computeExpectedValue(value, input_number);
+                //propagate the compute
+                stack.insert(stack.end(), result_ComputeExpectedValue.rbegin(), result_ComputeExpectedValue.rend());
             }
         }
     }
@@ -123,51 +134,172 @@ std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vecto
 }
 
 
+//position of the input of a port among the inputs of a cell sorted by port, as in the compiled circuit
+static size_t getInputPosition(const std::shared_ptr<Node>& node, int port_number){
+    size_t position = 0;
+    for (const std::pair<std::shared_ptr<Node>, int>& pair : node -> parents) position += pair.second < port_number;
+    return position;
+}
+
+void selectPropagationBranch(std::shared_ptr<Node> node, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, size_t first, const Testability& testability){
+    const CompiledCircuit& circuit = testability.getCircuit();
+    //the fault effect sent by the node to its children
+    std::vector<size_t> branches;
+    for (size_t i = first; i < mandatory.size(); ++i) {
+        std::tuple<std::shared_ptr<Node>, int, int, bool>& tuple = mandatory[i];
+        if (std::get<3>(tuple) && std::get<1>(tuple) != -1 && std::get<0>(tuple) -> getNodeFromPort(std::get<1>(tuple)) -> getIdentifier() == node -> getIdentifier()) branches.push_back(i);
+    }
+    if (branches.size() < 2) return;
+
+    //only the most observable branch propagates it, the others only get the value
+    size_t best = branches[0];
+    uint32_t best_cost = Testability::Infinity;
+    for (size_t i : branches) {
+        const std::shared_ptr<Node>& child = std::get<0>(mandatory[i]);
+        uint32_t cost = testability.getInputObservability(circuit.getIndex(child -> getIdentifier()), getInputPosition(child, std::get<1>(mandatory[i])));
+        if (cost < best_cost) {
+            best = i;
+            best_cost = cost;
+        }
+    }
+    for (size_t i : branches) {
+        if (i != best) std::get<3>(mandatory[i]) = false;
+    }
+}
+
+//values implied by the value of the output of a node according to the learned implications
+static void addLearnedImplications(const std::shared_ptr<Node>& node, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, const LearnedImplications& implications){
+    const CompiledCircuit& circuit = implications.getCircuit();
+    if (node -> getValueFromPort(-1) == -1) return;
+    const uint32_t gate = circuit.getIndex(node -> getIdentifier());
+    const bool value = node -> getValueFromPort(-1) == 1;
+    for (const uint32_t* literal = implications.begin(gate, value); literal != implications.end(gate, value); ++literal) {
+        mandatory.emplace_back(circuit.nodes[*literal / 2], -1, *literal & 1, false);
+    }
+}
+
 //for computeMandatory
-bool computeMandatoryList(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional) {
+bool computeMandatoryList(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional, const DecisionContext* context) {
     bool result;
     while(!mandatory.empty()){
         std::tuple<std::shared_ptr<Node>, int, int, bool> first_tuple = mandatory[0];
+        size_t first = mandatory.size();
+        bool assigned = std::get<1>(first_tuple) == -1 && std::get<0>(first_tuple) -> getValueFromPort(-1) == -1;
         
         result = std::get<0>(first_tuple) -> computeMandatory(std::get<0>(first_tuple), std::get<1>(first_tuple), std::get<2>(first_tuple), std::get<3>(first_tuple), mandatory, optional);
         if (result == false) return false;
+        if (context && context -> testability) selectPropagationBranch(std::get<0>(first_tuple), mandatory, first, *context -> testability);
+        if (context && context -> implications && assigned) addLearnedImplications(std::get<0>(first_tuple), mandatory, *context -> implications);
         mandatory.erase(mandatory.begin());
     }
     return true;
 }
 
-bool computeOptionalFirstElem(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional){
+//check if the value of the output of a cell is implied by the values already set on its inputs
+static bool isJustified(const CompiledCircuit& circuit, const std::shared_ptr<Node>& node){
+    int output = node -> getValueFromPort(-1);
+    if (output == -1 || node -> type == "Input" || node -> type == "Output") return false;
+
+    std::vector<std::pair<int, int>> ports;
+    for (const std::pair<std::shared_ptr<Node>, int>& pair : node -> parents) ports.emplace_back(pair.second, node -> getValueFromPort(pair.second));
+    std::sort(ports.begin(), ports.end());
+
+    uint32_t known = 0;
+    std::vector<size_t> unknown;
+    for (size_t i = 0; i < ports.size(); ++i) {
+        if (ports[i].second == -1) unknown.push_back(i);
+        else if (ports[i].second == 1) known |= 1u << i;
+    }
+    if (unknown.size() > 8) return false;
+
+    const CellKind kind = circuit.kinds[circuit.getIndex(node -> getIdentifier())];
+    for (uint32_t completion = 0; completion < (1u << unknown.size()); ++completion) {
+        uint32_t inputs = known;
+        for (size_t k = 0; k < unknown.size(); ++k) {
+            if ((completion >> k) & 1) inputs |= 1u << unknown[k];
+        }
+        if (evaluateCell(kind, inputs) != (output == 1)) return false;
+    }
+    return true;
+}
+
+bool computeOptionalFirstElem(std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& mandatory, std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>& optional, const DecisionContext* context){
     bool result;
     if (!optional.empty()){
-        std::tuple<std::shared_ptr<Node>, int, int, bool> first_tuple = optional[0];
+        size_t chosen = 0;
+        if (context && context -> testability) {
+            const Testability* testability = context -> testability.get();
+            //backtrace through the easiest value to set
+            const CompiledCircuit& circuit = testability -> getCircuit();
+            uint32_t best_cost = Testability::Infinity;
+            for (size_t i = 0; i < optional.size(); ++i) {
+                std::shared_ptr<Node> node = std::get<0>(optional[i]);
+                if (std::get<1>(optional[i]) != -1) node = node -> getNodeFromPort(std::get<1>(optional[i]));
+                uint32_t cost = testability -> getControllability(circuit.getIndex(node -> getIdentifier()), std::get<2>(optional[i]) == 1);
+                if (cost < best_cost || i == 0) {
+                    chosen = i;
+                    best_cost = cost;
+                }
+            }
+
+            //the other choices of a cell are dropped once one of them has set its output
+            std::shared_ptr<Node> node = std::get<0>(optional[chosen]);
+            if (std::get<1>(optional[chosen]) != -1 && isJustified(circuit, node)) {
+                optional.erase(optional.begin() + chosen);
+                return true;
+            }
+        }
+        std::tuple<std::shared_ptr<Node>, int, int, bool> first_tuple = optional[chosen];
         result  = std::get<0>(first_tuple) -> computeOptional(std::get<0>(first_tuple), std::get<1>(first_tuple), std::get<2>(first_tuple), std::get<3>(first_tuple), mandatory, optional);
-        optional.erase(optional.begin());
+        optional.erase(optional.begin() + chosen);
         if (result == false) return false;
        
     }
     return true;
 }
 
-std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> generateOneVector(std::pair<shared_ptr<Fault>, shared_ptr<Node>>& fault, shared_ptr<Tree> tree, bool& success){
+//check if the generation of a fault exceeds its effort limit
+static bool exceedsLimit(const EffortLimit& limit, size_t decisions, std::chrono::steady_clock::time_point start){
+    if (limit.decisions > 0 && decisions > limit.decisions) return true;
+    return limit.seconds > 0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > limit.seconds;
+}
+
+std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> generateOneVector(std::pair<shared_ptr<Fault>, shared_ptr<Node>>& fault, shared_ptr<Tree> tree, bool& success, const DecisionContext* context, const std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>>* necessary, const EffortLimit* limit, bool* aborted){
 
     //variable used for the function
     std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>> mandatory;
     std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>> optional; 
     bool result; 
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t decisions = 0;
 
     std::shared_ptr<Node> nodeToWorkOn = tree -> getNodeByIdentifier(fault.second -> getIdentifier());
 
     //make the first compute
     result = nodeToWorkOn -> computeMandatory(nodeToWorkOn, fault.first -> getPort(), fault.first -> getValue(), true, mandatory, optional);
     if (result == false) success = false;
+    if (context && context -> testability) selectPropagationBranch(nodeToWorkOn, mandatory, 0, *context -> testability);
+    if (context && context -> implications && fault.first -> getPort() == -1) addLearnedImplications(nodeToWorkOn, mandatory, *context -> implications);
+    if (context && context -> dominators && fault.first -> getPort() == -1) {
+        std::vector<std::pair<uint32_t, bool>> side_inputs;
+        context -> dominators -> getSideInputValues(context -> dominators -> getIndex(nodeToWorkOn -> getIdentifier()), side_inputs);
+        for (const std::pair<uint32_t, bool>& side_input : side_inputs) {
+            mandatory.emplace_back(context -> dominators -> nodes[side_input.first], -1, side_input.second, false);
+        }
+    }
+    if (necessary) mandatory.insert(mandatory.end(), necessary -> begin(), necessary -> end());
     //make the other compute
-    result = computeMandatoryList(mandatory, optional);
+    result = computeMandatoryList(mandatory, optional, context);
     if (result == false) success = false;
     while (!optional.empty()){
-        
-        result = computeOptionalFirstElem(mandatory, optional);
+        if (limit && exceedsLimit(*limit, ++decisions, start)) {
+            success = false;
+            if (aborted) *aborted = true;
+            break;
+        }
+        result = computeOptionalFirstElem(mandatory, optional, context);
         if (result == false) success = false;
-        result = computeMandatoryList(mandatory, optional);
+        result = computeMandatoryList(mandatory, optional, context);
         if (result == false) success = false;
     }
 
@@ -183,27 +315,170 @@ std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<
 
 }
 
-std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> generateVectorError(std::shared_ptr<std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list, shared_ptr<Tree> tree){
+void savePortValues(shared_ptr<Tree> tree, std::vector<std::tuple<int, int, bool>>& saved){
+    saved.clear();
+    for (const std::shared_ptr<Node>& node : tree -> NodeList){
+        saved.insert(saved.end(), node -> portValues.begin(), node -> portValues.end());
+    }
+}
+
+void restorePortValues(shared_ptr<Tree> tree, const std::vector<std::tuple<int, int, bool>>& saved){
+    auto value = saved.begin();
+    for (std::shared_ptr<Node>& node : tree -> NodeList){
+        std::copy(value, value + node -> portValues.size(), node -> portValues.begin());
+        value += node -> portValues.size();
+    }
+}
+
+std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> generateVectorError(std::shared_ptr<std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list, shared_ptr<Tree> tree, shared_ptr<const CompiledCircuit> circuit, size_t compaction_limit, const DecisionContext* context, const EffortLimit* limit){
 
     //this is a vector with the value for the inputs and the value for the outputs for these value of the inputs
     std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> list_error_vect;
     bool success = true;
+    bool aborted = false;
+
+    //faults already tested by a vector (as primary or secondary fault) or in failure
+    std::vector<bool> done(fault_list -> size(), false);
+    std::vector<std::tuple<int, int, bool>> saved;
+
+    //the secondary faults are only kept if the vector detects them whatever the values of its unspecified inputs
+    //the portable kernel is the fastest for a single vector
+    std::unique_ptr<ThreeValuedSimulator> simulator;
+    if (compaction_limit > 0) simulator = std::make_unique<ThreeValuedSimulator>(circuit, KernelType::Generic);
+
+    for (size_t i = 0; i < fault_list -> size(); ++i) {
+        std::pair<shared_ptr<Fault>, shared_ptr<Node>>& pair = (*fault_list)[i];
+        if (done[i]) continue;
+        done[i] = true;
+
+        //a fault on a node without any path to an output can't be observed
+        if (!circuit -> isObservable(circuit -> getIndex(pair.second -> getIdentifier()))) {
+            pair.first -> setFailure("ob");
+            continue;
+        }
 
-    for (std::pair<shared_ptr<Fault>, shared_ptr<Node>>& pair : *fault_list) {
+        std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> vector_error = generateOneVector(pair, tree, success, context, nullptr, limit, &aborted);
+        if (success) {
+            //dynamic compaction: the next faults are targeted under the values of the vector, while some inputs are unspecified
+            std::vector<size_t> secondary_faults;
+            size_t attempts = 0;
+            for (size_t j = i + 1; j < fault_list -> size() && attempts < compaction_limit; ++j) {
+                if (done[j] || !circuit -> isObservable(circuit -> getIndex((*fault_list)[j].second -> getIdentifier()))) continue;
+                bool unspecified = false;
+                for (const std::pair<shared_ptr<Node>, int>& input : vector_error.first) {
+                    unspecified = unspecified || input.second == -1;
+                }
+                if (!unspecified) break;
+
+                attempts++;
+                success = true;
+                savePortValues(tree, saved);
+                std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> secondary_vector = generateOneVector((*fault_list)[j], tree, success, context, nullptr, limit);
+                if (success) {
+                    vector_error = secondary_vector;
+                    secondary_faults.push_back(j);
+                    done[j] = true;
+                } else {
+                    //the secondary fault conflicts with the vector (or is aborted), it will be targeted by another one
+                    restorePortValues(tree, saved);
+                }
+            }
 
-        std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> vector_error = generateOneVector(pair, tree, success);
-        if (success) list_error_vect.push_back(vector_error);
+            if (!secondary_faults.empty()) {
+                std::vector<int> cube;
+                for (const std::pair<shared_ptr<Node>, int>& input : vector_error.first) cube.push_back(input.second);
+                std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>> secondary_list;
+                for (size_t j : secondary_faults) secondary_list.push_back((*fault_list)[j]);
+                std::vector<bool> detected;
+                simulator -> detect(cube, FaultSimulator::getStuckAtFaults(*circuit, secondary_list), detected);
+                for (size_t k = 0; k < secondary_faults.size(); ++k) {
+                    if (!detected[k]) done[secondary_faults[k]] = false;
+                }
+            }
+            list_error_vect.push_back(vector_error);
+        }
         else {
-            pair.first -> setFailure();
+            pair.first -> setFailure(aborted ? "ab" : "co");
         }
         success = true;
+        aborted = false;
         tree -> resetPortValue();
-        
-
-        
     }
     
     return list_error_vect;
 }
 
+std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> generateHardFaultVectors(std::shared_ptr<std::vector<std::pair<shared_ptr<Fault>, shared_ptr<Node>>>> fault_list, shared_ptr<Tree> tree, shared_ptr<const CompiledCircuit> circuit, size_t depth, const DecisionContext* context, const EffortLimit* limit){
+
+    std::vector<std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>>> list_error_vect;
+
+    RecursiveLearning learning(circuit, depth, context ? context -> implications.get() : nullptr);
+    ImplicationEngine& engine = learning.getEngine();
+    //the vectors are simulated one by one, the portable kernel being the fastest for a single pattern
+    FaultSimulator simulator(circuit, KernelType::Generic);
+    std::vector<uint64_t> pattern(circuit -> inputs.size() * simulator.getBlockWords());
+    std::vector<std::tuple<std::shared_ptr<Node>, int, int, bool>> necessary;
+    std::vector<std::pair<uint32_t, bool>> side_inputs;
+
+    for (std::pair<shared_ptr<Fault>, shared_ptr<Node>>& pair : *fault_list) {
+        if (!pair.first -> getFailure() || (pair.first -> getFailureReason() != "co" && pair.first -> getFailureReason() != "ab")) continue;
+
+        //values necessary to set the faulty node to the value to test, a conflict proving that the fault can't be tested
+        engine.backtrack(0);
+        const uint32_t gate = circuit -> getIndex(pair.second -> getIdentifier());
+        if (!engine.assign(gate, pair.first -> getValue())) {
+            pair.first -> setFailure("co");
+            continue;
+        }
+        if (context && context -> dominators) circuit -> getSideInputValues(gate, side_inputs);
+        else side_inputs.clear();
+        bool consistent = true;
+        for (const std::pair<uint32_t, bool>& side_input : side_inputs) {
+            if (!engine.assign(side_input.first, side_input.second)) {
+                consistent = false;
+                break;
+            }
+        }
+        if (!consistent || !learning.learn()) {
+            pair.first -> setFailure("co");
+            continue;
+        }
+        necessary.clear();
+        for (uint32_t assigned : engine.getTrail()) {
+            if (assigned == gate || circuit -> kinds[assigned] == CellKind::Output) continue;
+            necessary.emplace_back(circuit -> nodes[assigned], -1, engine.getValue(assigned), false);
+        }
+
+        bool success = true;
+        bool aborted = false;
+        std::pair<std::vector<std::pair<shared_ptr<Node>, int>> , std::vector<std::pair<shared_ptr<Node>, int>>> vector_error = generateOneVector(pair, tree, success, context, &necessary, limit, &aborted);
+        tree -> resetPortValue();
+        if (!success) {
+            if (!aborted) pair.first -> setFailure("co");
+            continue;
+        }
+
+        //the vector often detects the fault only for some values of its unspecified inputs: it is confirmed and kept with its 0-fill
+        std::fill(pattern.begin(), pattern.end(), 0);
+        for (size_t input = 0; input < vector_error.first.size(); ++input) {
+            if (vector_error.first[input].second != 1) vector_error.first[input].second = 0;
+            pattern[input * simulator.getBlockWords()] = vector_error.first[input].second;
+        }
+        std::vector<long> first_detection(1, -1);
+        simulator.simulateBlock(pattern.data(), 1, FaultSimulator::getStuckAtFaults(*circuit, {pair}), first_detection, 0);
+        if (first_detection[0] >= 0) {
+            //the outputs computed by the generation are unknown where they depend on the filled inputs
+            const LogicSimulator& good = simulator.getLogicSimulator();
+            for (size_t output = 0; output < vector_error.second.size(); ++output) {
+                vector_error.second[output].second = good.getValue(circuit -> outputs[output])[0] & 1;
+            }
+            pair.first -> clearFailure();
+            list_error_vect.push_back(vector_error);
+        }
+    }
+    engine.backtrack(0);
+
+    return list_error_vect;
+}
+
 } // namespace FaultAPI
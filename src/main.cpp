@@ -83,6 +83,23 @@ int main(int argc, char* argv[]) {
         ("coverage,c", po::value<std::string>(&top_level.cov_output_filename)->default_value("coverage"), strings["options"]["coverage"].get<std::string>().c_str())
         ("cov-type,C", po::value<std::string>(&top_level.cov_output_file_ext)->default_value("txt"), strings["options"]["cov_type"].get<std::string>().c_str())
         ("out-path,p", po::value<std::string>(&top_level.output_dir_path)->default_value("./out/"), strings["options"]["output_dir_path"].get<std::string>().c_str())
+        ("grade,g", po::value<std::string>(&top_level.grade_filename), strings["options"]["grade"].get<std::string>().c_str())
+        ("random-patterns", po::value<std::string>(&top_level.random_source)->default_value("random"), strings["options"]["random_patterns"].get<std::string>().c_str())
+        ("random-limit", po::value<size_t>(&top_level.random_pattern_limit)->default_value(8192), strings["options"]["random_limit"].get<std::string>().c_str())
+        ("random-gain", po::value<double>(&top_level.random_min_gain)->default_value(0.1), strings["options"]["random_gain"].get<std::string>().c_str())
+        ("static-learning", po::bool_switch(&top_level.static_learning), strings["options"]["static_learning"].get<std::string>().c_str())
+        ("dominators", po::value<bool>(&top_level.dominator_sensitization)->default_value(true), strings["options"]["dominators"].get<std::string>().c_str())
+        ("decision-limit", po::value<size_t>(&top_level.decision_limit)->default_value(1000), strings["options"]["decision_limit"].get<std::string>().c_str())
+        ("time-limit", po::value<double>(&top_level.time_limit)->default_value(1), strings["options"]["time_limit"].get<std::string>().c_str())
+        ("recursive-learning", po::value<size_t>(&top_level.recursive_learning_depth)->default_value(1), strings["options"]["recursive_learning"].get<std::string>().c_str())
+        ("dynamic-compaction", po::value<size_t>(&top_level.dynamic_compaction_limit)->default_value(0), strings["options"]["dynamic_compaction"].get<std::string>().c_str())
+        ("static-compaction", po::value<size_t>(&top_level.static_compaction_limit)->default_value(1024), strings["options"]["static_compaction"].get<std::string>().c_str())
+        ("reverse-order", po::bool_switch(&top_level.reverse_order_reduction), strings["options"]["reverse_order"].get<std::string>().c_str())
+        ("x-fill", po::value<std::string>(&top_level.x_fill)->default_value("none"), strings["options"]["x_fill"].get<std::string>().c_str())
+        ("testability", po::value<std::string>(&top_level.testability_filename), strings["options"]["testability"].get<std::string>().c_str())
+        ("fault-engine", po::value<std::string>(&top_level.fault_engine)->default_value("ppsfp"), strings["options"]["fault_engine"].get<std::string>().c_str())
+        ("sim-kernel", po::value<std::string>(&top_level.sim_kernel)->default_value("auto"), strings["options"]["sim_kernel"].get<std::string>().c_str())
+        ("threads", po::value<size_t>(&top_level.thread_count)->default_value(top_level.thread_count, strings["options"]["threads_default"].get<std::string>()), strings["options"]["threads"].get<std::string>().c_str())
     ;
 
     // To allow short './ATPG-Kernel <filename>' usage
@@ -135,20 +152,39 @@ int main(int argc, char* argv[]) {
     // Call the reader
     top_level.read();
 
+    if (!top_level.testability_filename.empty()) {
+        std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["testability_writing"].get<std::string>() << std::endl;
+        // Write the SCOAP measures of the nets
+        top_level.write_testability();
+        std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["testability_writing_success"].get<std::string>() << RESET_TEXT << std::endl;
+    }
+
     std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["tree_decoration"].get<std::string>() << std::endl;
     // Decorate the circuit model tree with the fault to test
     top_level.decorate();
     std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["tree_decoration_success"].get<std::string>() << RESET_TEXT << std::endl;
 
-    std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["vector_generation"].get<std::string>() << std::endl;
-    // Generate the test vectors
-    top_level.generate_vector();
-    std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["vector_generation_success"].get<std::string>() << RESET_TEXT << std::endl;
-
-    std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["vector_writing"].get<std::string>() << std::endl;
-    // Write the vector output file
-    top_level.write_vector();
-    std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["vector_writing_success"].get<std::string>() << RESET_TEXT << std::endl;
+    if (top_level.grade_filename.empty()) {
+        std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["vector_generation"].get<std::string>() << std::endl;
+        // Generate the test vectors
+        top_level.generate_vector();
+        std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["vector_generation_success"].get<std::string>() << RESET_TEXT << std::endl;
+
+        std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["vector_compaction"].get<std::string>() << std::endl;
+        // Merge the compatible test vectors
+        top_level.compact_vector();
+        std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["vector_compaction_success"].get<std::string>() << RESET_TEXT << std::endl;
+
+        std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["vector_writing"].get<std::string>() << std::endl;
+        // Write the vector output file
+        top_level.write_vector();
+        std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["vector_writing_success"].get<std::string>() << RESET_TEXT << std::endl;
+    } else {
+        std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["vector_grading"].get<std::string>() << std::endl;
+        // Fault simulate the given test vectors instead of generating them
+        top_level.grade_vector();
+        std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["vector_grading_success"].get<std::string>() << RESET_TEXT << std::endl;
+    }
 
     std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["cov_stat_generation"].get<std::string>() << std::endl;
     // Generate the coverage statistics
@@ -0,0 +1,49 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/parser/module_definition.hpp"
+
+#include <algorithm>
+
+ModuleDefinition::ModuleDefinition(const std::string& _name) : name(_name) {}
+
+uint ModuleDefinition::getBitCount() const {
+    uint max_bit = 0;
+
+    for (const Port& port : ports) {
+        for (const uint bit : port.bits) max_bit = std::max(max_bit, bit);
+    }
+    for (const Gate& cell : cells) {
+        max_bit = std::max(max_bit, cell.out);
+        for (const auto& input : cell.in) max_bit = std::max(max_bit, input.first);
+    }
+    for (const Instance& instance : instances) {
+        for (const auto& connection : instance.connections) {
+            for (const uint bit : connection.second) max_bit = std::max(max_bit, bit);
+        }
+    }
+    if (!nets.empty()) max_bit = std::max(max_bit, nets.rbegin()->first);
+
+    return max_bit + 1;
+}
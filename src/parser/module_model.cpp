@@ -0,0 +1,50 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/parser/module_model.hpp"
+#include "../../include/parser/yosys_gate_level_cells.hpp"
+
+#include <algorithm>
+
+using namespace YosysBasicGateLevelCells;
+
+ModelCell::ModelCell(const Gate& _gate) : gate(_gate) {
+    for (const auto& input : gate.in) inputs.push_back({input.second, input.first});
+    std::sort(inputs.begin(), inputs.end());
+
+    if (isMemoryCell(gate.name)) {
+        category = CellCategory::Memory;
+    } else if (unaryCells.find(gate.name) != unaryCells.end()) {
+        category = CellCategory::Unary;
+    } else if (binaryCells.find(gate.name) != binaryCells.end()) {
+        category = CellCategory::Binary;
+    } else {
+        category = CellCategory::Complex;
+    }
+}
+
+ModuleModel::ModuleModel(std::shared_ptr<const ModuleDefinition> _definition) : definition(_definition) {
+    for (const Gate& cell : definition->cells) cells.emplace_back(cell);
+    bit_count = definition->getBitCount();
+    gate_count = cells.size();
+}
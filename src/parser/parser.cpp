@@ -23,4 +23,249 @@
 
 #include "../../include/parser/parser.hpp"
 
-Parser::Parser(json _strings) : strings(_strings) {};
\ No newline at end of file
+#include <algorithm>
+#include <unordered_set>
+
+Parser::Parser(json _strings) : strings(_strings) {};
+namespace {
+    /**
+     * @brief Print an elaboration error and exit
+     */
+    [[noreturn]] void elaborationError(const std::string& message) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": " << message << std::endl;
+        exit(1);
+    }
+
+    /**
+     * @brief Add the input and output bits of a new gate to the port mappings, input ports being sorted by name
+     */
+    void addPortMapping(const Gate& gate, bool has_output, ParsedCircuit& netlist) {
+        std::vector<std::pair<std::string, uint>> inputs;
+        for (const auto& input : gate.in) inputs.push_back({input.second, input.first});
+        std::sort(inputs.begin(), inputs.end());
+
+        for (const auto& input : inputs) netlist.input_port_mapping.push_back({input.second, gate.id});
+        if (has_output) netlist.output_port_mapping.push_back({gate.out, gate.id});
+    }
+}
+
+ParsedCircuit Parser::elaborate(const std::map<std::string, std::shared_ptr<const ModuleDefinition>>& modules) {
+    ParsedCircuit parsedNetlist;
+    parsedNetlist.module_definitions = modules;
+
+    // One model per module definition, whatever the number of its instances
+    std::vector<std::string> stack;
+    for (const auto& module : modules) {
+        this->buildModel(module.first, parsedNetlist, stack);
+    }
+
+    // Looking for the top-level modules
+    std::vector<const ModuleDefinition*> tops;
+    for (const auto& module : modules) {
+        if (module.second->top) tops.push_back(module.second.get());
+    }
+    if (tops.empty()) {
+        std::unordered_set<std::string> instanciated;
+        for (const auto& module : modules) {
+            for (const Instance& instance : module.second->instances) instanciated.insert(instance.module);
+        }
+        for (const auto& module : modules) {
+            if (instanciated.find(module.first) == instanciated.end()) tops.push_back(module.second.get());
+        }
+    }
+
+    if (tops.empty()) {
+        elaborationError("no top-level module found (recursive module instanciation)");
+    } else if (tops.size() > 1) {
+        std::cout << ORANGE_TEXT << BOLD_TEXT << "Warning" << RESET_TEXT << " : " << this->strings["warnings"]["multi_module_def"].get<std::string>() << std::endl;
+    }
+
+    uint next_bit = 0;
+    uint gate_index = 0;
+
+    size_t gate_count = 0;
+    for (const ModuleDefinition* top : tops) gate_count += parsedNetlist.module_models.at(top->name)->gate_count;
+    parsedNetlist.output_port_mapping.reserve(gate_count);
+
+    for (const ModuleDefinition* top : tops) {
+        this->addTop(*top, parsedNetlist, next_bit, gate_index);
+    }
+    this->connect(parsedNetlist);
+
+    return parsedNetlist;
+}
+
+ParsedCircuit Parser::elaborateModule(const ParsedCircuit& netlist, const std::string& name) {
+    ParsedCircuit module;
+    module.module_definitions = netlist.module_definitions;
+    module.module_models = netlist.module_models;
+
+    uint next_bit = 0;
+    uint gate_index = 0;
+    this->addTop(*netlist.module_definitions.at(name), module, next_bit, gate_index);
+    this->connect(module);
+    return module;
+}
+
+void Parser::addTop(const ModuleDefinition& top, ParsedCircuit& netlist, uint& next_bit, uint& gate_index) {
+    // The ports of the top-level module are the inputs and outputs of the circuit
+    // Bits of the top-level module are offset by the index of the first free bit, see instantiate()
+    const uint base = next_bit;
+
+    for (const Port& port : top.ports) {
+        for (size_t i = 0; i < port.bits.size(); ++i) {
+            const uint bit = base + port.bits[i];
+            const std::string name = port.bits.size() == 1 ? port.name : port.name + "[" + std::to_string(i) + "]";
+
+            if (port.direction == "input") {
+                netlist.input_vector.push_back(bit);
+                gate_index++;
+                Gate input("Input "+name, gate_index, name);
+                input.out = bit;
+                netlist.full_gate_vector.insert({input.id, input});
+                addPortMapping(input, true, netlist);
+            } else {
+                netlist.output_vector.push_back(bit);
+                gate_index++;
+                Gate output("Output "+name, gate_index, name);
+                output.in.insert({bit, "A"});
+                netlist.full_gate_vector.insert({output.id, output});
+                addPortMapping(output, false, netlist);
+            }
+        }
+    }
+
+    const ModuleModel& model = *netlist.module_models.at(top.name);
+    std::vector<uint> bits(model.bit_count);
+    for (uint bit = 0; bit < model.bit_count; ++bit) bits[bit] = base + bit;
+    next_bit += model.bit_count;
+    this->instantiate(model, "", bits, netlist, next_bit, gate_index);
+}
+
+void Parser::connect(ParsedCircuit& netlist) {
+    // Filling the direct gate mapping vector
+    std::unordered_map<uint, std::vector<size_t>> drivers;
+    for (const auto& output : netlist.output_port_mapping) {
+        drivers[output.first].push_back(output.second);
+    }
+    // Number of ports already mapped for the bits connected to several ports of the same gate
+    std::map<std::pair<size_t, uint>, size_t> mapped_ports;
+    for (const auto& input : netlist.input_port_mapping) {
+        auto driver = drivers.find(input.first);
+        if (driver == drivers.end()) continue;
+
+        const Gate& gate = netlist.full_gate_vector.find(input.second)->second;
+        auto ports = gate.in.equal_range(input.first);
+        if (gate.in.count(input.first) > 1) {
+            std::advance(ports.first, mapped_ports[{input.second, input.first}]++);
+        }
+        const std::string& port = ports.first->second;
+        for (const size_t driver_id : driver->second) {
+            netlist.direct_port_pair_mapping.push_back({driver_id, input.second, input.first, port});
+        }
+    }
+
+    // for convinience
+    std::sort(netlist.input_vector.begin(), netlist.input_vector.end());
+    std::sort(netlist.output_vector.begin(), netlist.output_vector.end());
+    std::sort(netlist.wire_vector.begin(), netlist.wire_vector.end());
+    netlist.wire_vector.erase(std::unique(netlist.wire_vector.begin(), netlist.wire_vector.end()), netlist.wire_vector.end());
+}
+
+std::shared_ptr<const ModuleModel> Parser::buildModel(const std::string& name, ParsedCircuit& netlist, std::vector<std::string>& stack) {
+    auto built = netlist.module_models.find(name);
+    if (built != netlist.module_models.end()) return built->second;
+
+    if (std::find(stack.begin(), stack.end(), name) != stack.end()) {
+        elaborationError("module '" + name + "' instanciates itself");
+    }
+    stack.push_back(name);
+
+    const ModuleDefinition& module = *netlist.module_definitions.at(name);
+    std::shared_ptr<ModuleModel> model = std::make_shared<ModuleModel>(netlist.module_definitions.at(name));
+
+    for (const Instance& instance : module.instances) {
+        if (netlist.module_definitions.find(instance.module) == netlist.module_definitions.end()) {
+            elaborationError("unknown cell type '" + instance.module + "' (cell '" + instance.name + "' of module '" + module.name + "')");
+        }
+        ModelInstance model_instance;
+        model_instance.name = instance.name;
+        model_instance.model = this->buildModel(instance.module, netlist, stack);
+        const ModuleDefinition& child = *model_instance.model->definition;
+
+        // Bits of the instance connected to the bits of this module
+        std::unordered_map<uint, uint> child_bits;
+        for (const auto& connection : instance.connections) {
+            auto port = std::find_if(child.ports.begin(), child.ports.end(), [&connection](const Port& p) { return p.name == connection.first; });
+            if (port == child.ports.end()) {
+                elaborationError("module '" + child.name + "' has no port '" + connection.first + "' (instance '" + instance.name + "' of module '" + module.name + "')");
+            }
+            if (port->bits.size() != connection.second.size()) {
+                elaborationError("width mismatch on port '" + connection.first + "' of instance '" + instance.name + "' of module '" + module.name + "'");
+            }
+
+            for (size_t i = 0; i < port->bits.size(); ++i) {
+                auto inserted = child_bits.insert({port->bits[i], connection.second[i]});
+                if (!inserted.second && inserted.first->second != connection.second[i]) {
+                    elaborationError("ports of module '" + child.name + "' connected together inside the module are not supported (instance '" + instance.name + "')");
+                }
+                if (inserted.second) model_instance.bits.push_back({port->bits[i], connection.second[i]});
+            }
+        }
+
+        model->gate_count += model_instance.model->gate_count;
+        model->instances.push_back(std::move(model_instance));
+    }
+
+    stack.pop_back();
+    netlist.module_models.insert({name, model});
+    return model;
+}
+
+void Parser::instantiate(const ModuleModel& model, const std::string& path, const std::vector<uint>& bits, ParsedCircuit& netlist, uint& next_bit, uint& gate_index) {
+    const std::string prefix = path.empty() ? "" : path + ".";
+
+    for (const ModelCell& cell : model.cells) {
+        Gate gate(cell.gate.name, gate_index++, prefix + cell.gate.netlistName);
+        gate.input_length = cell.gate.input_length;
+        gate.out = bits[cell.gate.out];
+        for (const auto& input : cell.inputs) {
+            gate.in.insert({bits[input.second], input.first});
+            netlist.input_port_mapping.push_back({bits[input.second], gate.id});
+        }
+        netlist.output_port_mapping.push_back({gate.out, gate.id});
+
+        switch (cell.category) {
+            case CellCategory::Memory:
+                netlist.memory_gate_vector.push_back(gate);
+                break;
+            case CellCategory::Unary:
+                netlist.unary_gate_vector.push_back(gate);
+                break;
+            case CellCategory::Binary:
+                netlist.binary_gate_vector.push_back(gate);
+                break;
+            case CellCategory::Complex:
+                netlist.complex_gate_vector.push_back(gate);
+                break;
+        }
+        netlist.full_gate_vector.emplace_hint(netlist.full_gate_vector.end(), gate.id, std::move(gate));
+    }
+
+    for (const auto& net : model.definition->nets) {
+        netlist.wire_vector.push_back(bits[net.first]);
+    }
+
+    // The bits of an instance which are not connected to a port get new indexes
+    for (const ModelInstance& instance : model.instances) {
+        const ModuleModel& child = *instance.model;
+        std::vector<uint> child_bits(child.bit_count);
+        for (uint bit = 0; bit < child.bit_count; ++bit) child_bits[bit] = next_bit + bit;
+        next_bit += child.bit_count;
+        for (const auto& connection : instance.bits) child_bits[connection.first] = bits[connection.second];
+
+        const std::string child_path = prefix + instance.name;
+        netlist.instance_vector.push_back({child_path, instance.model});
+        this->instantiate(child, child_path, child_bits, netlist, next_bit, gate_index);
+    }
+}
@@ -0,0 +1,536 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/parser/verilog_parser.hpp"
+
+#include <cctype>
+#include <unordered_set>
+
+namespace {
+    /**
+     * @brief Yosys cell corresponding to each Verilog primitive, and the cell used to chain extra inputs
+     */
+    const std::unordered_map<std::string_view, std::pair<std::string, std::string>> primitiveCells = {
+        {"and",  {"$_AND_",  "$_AND_"}},
+        {"nand", {"$_NAND_", "$_AND_"}},
+        {"or",   {"$_OR_",   "$_OR_"}},
+        {"nor",  {"$_NOR_",  "$_OR_"}},
+        {"xor",  {"$_XOR_",  "$_XOR_"}},
+        {"xnor", {"$_XNOR_", "$_XOR_"}},
+        {"buf",  {"$_BUF_",  ""}},
+        {"not",  {"$_NOT_",  ""}}
+    };
+
+    /**
+     * @brief Keywords declaring nets without being ports
+     */
+    const std::unordered_set<std::string_view> netKeywords = {"wire", "reg", "tri", "wand", "wor"};
+}
+
+VerilogParser::VerilogParser(json _strings) : Parser(_strings) {};
+
+void VerilogParser::setInputFileContent(std::string _inputFileContent) {
+    this->inputFileContent = std::move(_inputFileContent);
+}
+
+void VerilogParser::error(const std::string& message) {
+    std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": ";
+    if (this->line != 0) std::cerr << "line " << this->line << ": ";
+    std::cerr << message << std::endl;
+    exit(1);
+}
+
+void VerilogParser::skipBlank() {
+    const std::string& s = this->inputFileContent;
+    const size_t size = s.size();
+    while (pos < size) {
+        const char c = s[pos];
+        if (c == '\n') {
+            line++;
+            pos++;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            pos++;
+        } else if (c == '/' && pos+1 < size && s[pos+1] == '/') {
+            while (pos < size && s[pos] != '\n') pos++;
+        } else if (c == '/' && pos+1 < size && s[pos+1] == '*') {
+            pos += 2;
+            while (pos+1 < size && !(s[pos] == '*' && s[pos+1] == '/')) {
+                if (s[pos] == '\n') line++;
+                pos++;
+            }
+            pos += 2;
+        } else if (c == '(' && pos+1 < size && s[pos+1] == '*') {
+            // Attributes are ignored
+            pos += 2;
+            while (pos+1 < size && !(s[pos] == '*' && s[pos+1] == ')')) {
+                if (s[pos] == '\n') line++;
+                pos++;
+            }
+            pos += 2;
+        } else {
+            break;
+        }
+    }
+}
+
+std::string_view VerilogParser::readIdentifier() {
+    skipBlank();
+    const std::string& s = this->inputFileContent;
+    const size_t start = pos;
+
+    // Escaped identifier : everything up to the next blank
+    if (pos < s.size() && s[pos] == '\\') {
+        pos++;
+        while (pos < s.size() && !std::isspace(static_cast<unsigned char>(s[pos]))) pos++;
+        return std::string_view(s).substr(start+1, pos-start-1);
+    }
+
+    while (pos < s.size() && (std::isalnum(static_cast<unsigned char>(s[pos])) || s[pos] == '_' || s[pos] == '$')) pos++;
+    return std::string_view(s).substr(start, pos-start);
+}
+
+void VerilogParser::expect(char c) {
+    skipBlank();
+    if (pos >= this->inputFileContent.size() || this->inputFileContent[pos] != c) {
+        error(std::string("'") + c + "' expected");
+    }
+    pos++;
+}
+
+bool VerilogParser::accept(char c) {
+    skipBlank();
+    if (pos < this->inputFileContent.size() && this->inputFileContent[pos] == c) {
+        pos++;
+        return true;
+    }
+    return false;
+}
+
+std::pair<int, int> VerilogParser::readRange() {
+    if (!accept('[')) return {-1, -1};
+
+    // Only constant bit indexes are supported, not parameters nor expressions
+    auto readIndex = [this]() {
+        std::string_view index = readIdentifier();
+        if (index.empty() || index.size() > 9) error("bit index expected");
+        for (char c : index) {
+            if (!std::isdigit(static_cast<unsigned char>(c))) error("bit index expected");
+        }
+        return std::stoi(std::string(index));
+    };
+
+    const int msb = readIndex();
+    const int lsb = accept(':') ? readIndex() : msb;
+    expect(']');
+
+    return {msb, lsb};
+}
+
+uint VerilogParser::getNet(const std::string& name) {
+    auto it = netIndex.find(name);
+    if (it != netIndex.end()) return it->second;
+
+    // Net indexes start at 2 as in Yosys (0 and 1 are the constant bits)
+    uint index = aliasParent.size() + 2;
+    netIndex.emplace(name, index);
+    aliasParent.push_back(index);
+    return index;
+}
+
+uint VerilogParser::findAlias(uint net) {
+    while (aliasParent[net-2] != net) {
+        aliasParent[net-2] = aliasParent[aliasParent[net-2]-2];
+        net = aliasParent[net-2];
+    }
+    return net;
+}
+
+std::vector<uint> VerilogParser::readNetBits() {
+    skipBlank();
+    const std::string& s = this->inputFileContent;
+    if (pos < s.size() && (std::isdigit(static_cast<unsigned char>(s[pos])) || s[pos] == '\'')) {
+        error("constant nets are not supported");
+    }
+    if (pos < s.size() && s[pos] == '{') {
+        error("concatenations are not supported");
+    }
+
+    std::string name(readIdentifier());
+    if (name.empty()) error("net name expected");
+
+    std::pair<int, int> range = readRange();
+    if (range.first == -1) {
+        auto vect = vectorRange.find(name);
+        if (vect == vectorRange.end()) return {getNet(name)};
+        range = vect->second;
+    }
+
+    // Least significant bit first
+    std::vector<uint> bits;
+    const int step = range.first >= range.second ? 1 : -1;
+    for (int i = range.second; ; i += step) {
+        bits.push_back(getNet(name + "[" + std::to_string(i) + "]"));
+        if (i == range.first) break;
+    }
+    return bits;
+}
+
+uint VerilogParser::readNet() {
+    std::vector<uint> bits = readNetBits();
+    if (bits.size() != 1) error("vector connected to a single bit port");
+    return bits[0];
+}
+
+void VerilogParser::parseDeclaration(std::string_view direction, bool ansi) {
+    // Optional net type and signedness
+    size_t save_pos = pos;
+    uint save_line = line;
+    std::string_view keyword = readIdentifier();
+    if (netKeywords.find(keyword) == netKeywords.end() && keyword != "signed") {
+        pos = save_pos;
+        line = save_line;
+    }
+
+    std::pair<int, int> range = readRange();
+
+    do {
+        // In ANSI headers, a new direction keyword ends the current declaration
+        if (ansi) {
+            save_pos = pos;
+            save_line = line;
+            std::string_view next = readIdentifier();
+            if (next == "input" || next == "output" || next == "inout") {
+                parseDeclaration(next, ansi);
+                return;
+            }
+            pos = save_pos;
+            line = save_line;
+        }
+
+        std::string name(readIdentifier());
+        if (name.empty()) error("net name expected in declaration");
+
+        // Bits of the net, least significant bit first
+        std::vector<uint> bits;
+        if (range.first == -1) {
+            bits.push_back(getNet(name));
+        } else {
+            vectorRange[name] = range;
+            const int step = range.first >= range.second ? 1 : -1;
+            for (int i = range.second; ; i += step) {
+                bits.push_back(getNet(name + "[" + std::to_string(i) + "]"));
+                if (i == range.first) break;
+            }
+        }
+
+        if (direction == "input" || direction == "output") {
+            module->ports.push_back({name, std::string(direction), bits});
+        } else if (direction == "inout") {
+            error("inout port '" + name + "' is not supported");
+        }
+    } while (accept(','));
+
+    if (!ansi) expect(';');
+}
+
+void VerilogParser::parsePrimitive(std::string_view type) {
+    const std::pair<std::string, std::string>& cells = primitiveCells.find(type)->second;
+
+    // Optional delay, ignored
+    if (accept('#')) {
+        if (accept('(')) {
+            while (!accept(')')) {
+                if (pos >= this->inputFileContent.size()) error("')' expected");
+                pos++;
+            }
+        } else {
+            readIdentifier();
+        }
+    }
+
+    do {
+        std::string instance_name(readIdentifier());
+        if (instance_name.empty()) instance_name = std::string(type) + "$" + std::to_string(primitive_index);
+        primitive_index++;
+
+        std::vector<uint> terminals;
+        expect('(');
+        do {
+            terminals.push_back(readNet());
+        } while (accept(','));
+        expect(')');
+
+        if (terminals.size() < 2) error("primitive '" + instance_name + "' needs at least two terminals");
+
+        // Gate indexes are given at elaboration
+        if (cells.second.empty()) {
+            // buf and not : several outputs, the last terminal is the input
+            for (size_t i = 0; i+1 < terminals.size(); ++i) {
+                Gate gate(cells.first, 0, instance_name);
+                gate.out = terminals[i];
+                gate.in.insert({terminals.back(), "A"});
+                gate.input_length = 1;
+                module->cells.push_back(gate);
+            }
+        } else {
+            if (terminals.size() < 3) error("primitive '" + instance_name + "' needs at least two inputs");
+
+            // Inputs beyond the second one are chained with two inputs cells
+            uint previous = terminals[1];
+            for (size_t i = 2; i < terminals.size(); ++i) {
+                const bool last = (i == terminals.size()-1);
+                Gate gate(last ? cells.first : cells.second, 0, instance_name);
+                gate.out = last ? terminals[0] : getNet("$" + instance_name + "$" + std::to_string(internal_net_index++));
+                gate.in.insert({previous, "A"});
+                gate.in.insert({terminals[i], "B"});
+                gate.input_length = 2;
+                module->cells.push_back(gate);
+                previous = gate.out;
+            }
+        }
+    } while (accept(','));
+
+    expect(';');
+}
+
+void VerilogParser::parseCellInstance(std::string_view type) {
+    // Optional parameters, ignored
+    if (accept('#')) {
+        expect('(');
+        int depth = 1;
+        while (depth > 0 && pos < this->inputFileContent.size()) {
+            if (this->inputFileContent[pos] == '(') depth++;
+            else if (this->inputFileContent[pos] == ')') depth--;
+            else if (this->inputFileContent[pos] == '\n') line++;
+            pos++;
+        }
+    }
+
+    std::string instance_name(readIdentifier());
+    if (instance_name.empty()) error("instance name expected for cell '" + std::string(type) + "'");
+
+    // Types which are not basic cells are modules of the netlist, resolved at elaboration
+    const bool basic = isBasicCell(std::string(type));
+    Gate gate(std::string(type), 0, instance_name);
+    Instance instance = {instance_name, std::string(type), {}};
+    bool has_output = false;
+
+    expect('(');
+    if (!accept(')')) {
+        do {
+            if (!accept('.')) error("only named port connections are supported (instance '" + instance_name + "')");
+            std::string port(readIdentifier());
+            expect('(');
+
+            if (!basic) {
+                // Unconnected ports are left out
+                if (!accept(')')) {
+                    instance.connections[port] = readNetBits();
+                    expect(')');
+                }
+                continue;
+            }
+
+            uint net = readNet();
+            expect(')');
+
+            if (port == "Y" || port == "Q") {
+                gate.out = net;
+                has_output = true;
+            } else {
+                gate.input_length++;
+                gate.in.insert({net, port});
+            }
+        } while (accept(','));
+        expect(')');
+    }
+    expect(';');
+
+    if (!basic) {
+        module->instances.push_back(instance);
+        return;
+    }
+
+    if (!has_output) error("cell '" + instance_name + "' has no output connection");
+    module->cells.push_back(gate);
+}
+
+void VerilogParser::endModule() {
+    // Resolving the aliases
+    for (Port& port : module->ports) {
+        for (uint& bit : port.bits) bit = findAlias(bit);
+    }
+    for (Gate& cell : module->cells) {
+        std::multimap<uint, std::string> resolved_in;
+        for (auto& input : cell.in) resolved_in.emplace(findAlias(input.first), std::move(input.second));
+        cell.in = std::move(resolved_in);
+        cell.out = findAlias(cell.out);
+    }
+    for (Instance& instance : module->instances) {
+        for (auto& connection : instance.connections) {
+            for (uint& bit : connection.second) bit = findAlias(bit);
+        }
+    }
+    for (const auto& net : netIndex) {
+        module->nets.insert({findAlias(net.second), net.first});
+    }
+
+    // Net indexes are local to each module
+    netIndex.clear();
+    vectorRange.clear();
+    aliasParent.clear();
+}
+
+void VerilogParser::checkDrivers(const ModuleDefinition& definition, const std::map<std::string, std::shared_ptr<const ModuleDefinition>>& modules) {
+    std::unordered_map<uint, uint> drivers;
+    std::vector<uint> loads;
+
+    for (const Port& port : definition.ports) {
+        for (const uint bit : port.bits) {
+            if (port.direction == "input") drivers[bit]++;
+            else loads.push_back(bit);
+        }
+    }
+    for (const Gate& cell : definition.cells) {
+        drivers[cell.out]++;
+        for (const auto& input : cell.in) loads.push_back(input.first);
+    }
+    for (const Instance& instance : definition.instances) {
+        // Unknown modules are reported at elaboration
+        auto child = modules.find(instance.module);
+        if (child == modules.end()) continue;
+
+        for (const Port& port : child->second->ports) {
+            auto connection = instance.connections.find(port.name);
+            if (connection == instance.connections.end()) continue;
+            for (const uint bit : connection->second) {
+                if (port.direction == "input") loads.push_back(bit);
+                else drivers[bit]++;
+            }
+        }
+    }
+
+    for (const auto& driver : drivers) {
+        if (driver.second > 1) {
+            error("net '" + definition.nets.at(driver.first) + "' of module '" + definition.name + "' is driven by several gates");
+        }
+    }
+    for (const uint bit : loads) {
+        if (drivers.find(bit) == drivers.end()) {
+            error("net '" + definition.nets.at(bit) + "' of module '" + definition.name + "' has no driver");
+        }
+    }
+}
+
+ParsedCircuit VerilogParser::parseCircuit() {
+    pos = 0;
+    line = 1;
+    primitive_index = 0;
+    internal_net_index = 0;
+    netIndex.clear();
+    vectorRange.clear();
+    aliasParent.clear();
+    // Rough estimate of the net count, to avoid rehashing on large netlists
+    netIndex.reserve(this->inputFileContent.size() / 64);
+
+    std::map<std::string, std::shared_ptr<const ModuleDefinition>> modules;
+
+    while (true) {
+        skipBlank();
+        if (pos >= this->inputFileContent.size()) break;
+
+        std::string_view keyword = readIdentifier();
+        if (keyword != "module") error("'module' expected");
+
+        std::string module_name(readIdentifier());
+        if (module_name.empty()) error("module name expected");
+        if (modules.find(module_name) != modules.end()) error("module '" + module_name + "' is defined twice");
+        module = std::make_shared<ModuleDefinition>(module_name);
+
+        // Module header : list of port names or ANSI port declarations
+        if (accept('(')) {
+            if (!accept(')')) {
+                size_t save_pos = pos;
+                uint save_line = line;
+                std::string_view first = readIdentifier();
+                if (first == "input" || first == "output" || first == "inout") {
+                    parseDeclaration(first, true);
+                } else {
+                    pos = save_pos;
+                    line = save_line;
+                    do {
+                        readIdentifier();
+                    } while (accept(','));
+                }
+                expect(')');
+            }
+        }
+        expect(';');
+
+        // Module items
+        while (true) {
+            skipBlank();
+            if (pos >= this->inputFileContent.size()) error("'endmodule' expected");
+
+            std::string_view item = readIdentifier();
+            if (item.empty()) error("unexpected character '" + std::string(1, this->inputFileContent[pos]) + "'");
+
+            if (item == "endmodule") {
+                break;
+            } else if (item == "input" || item == "output" || item == "inout") {
+                parseDeclaration(item, false);
+            } else if (netKeywords.find(item) != netKeywords.end()) {
+                parseDeclaration("wire", false);
+            } else if (item == "assign") {
+                do {
+                    uint lhs = readNet();
+                    expect('=');
+                    uint rhs = readNet();
+                    skipBlank();
+                    if (pos >= this->inputFileContent.size() || (this->inputFileContent[pos] != ';' && this->inputFileContent[pos] != ',')) {
+                        error("only net aliases are supported in 'assign' statements");
+                    }
+                    aliasParent[findAlias(lhs)-2] = findAlias(rhs);
+                } while (accept(','));
+                expect(';');
+            } else if (primitiveCells.find(item) != primitiveCells.end()) {
+                parsePrimitive(item);
+            } else {
+                parseCellInstance(item);
+            }
+        }
+
+        endModule();
+        modules.insert({module_name, module});
+    }
+
+    // Errors found from now on are not related to a specific line
+    line = 0;
+
+    for (const auto& definition : modules) {
+        checkDrivers(*definition.second, modules);
+    }
+
+    return this->elaborate(modules);
+}
@@ -29,45 +29,55 @@ void YosysJSONParser::setInputFileContent(std::string _inputFileContent) {
     this->inputFileContent = _inputFileContent;
 }
 
+namespace {
+    /**
+     * @brief Read the bits of a port or of a connection, exiting with an error on constant bits
+     */
+    std::vector<uint> readBits(const json& bits, const std::string& where) {
+        std::vector<uint> result;
+        for (const json& bit : bits) {
+            if (!bit.is_number_unsigned()) {
+                std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": constant connections are not supported (" << where << ")" << std::endl;
+                exit(1);
+            }
+            result.push_back(bit.get<uint>());
+        }
+        return result;
+    }
+
+    /**
+     * @brief Check if a module is marked as the top-level module with the 'top' attribute
+     */
+    bool isTopModule(const json& module) {
+        if (!module.contains("attributes") || !module["attributes"].contains("top")) return false;
+
+        // Depending on the version of Yosys, the attribute is a number or a binary string
+        const json& top = module["attributes"]["top"];
+        if (top.is_string()) return top.get<std::string>().find('1') != std::string::npos;
+        return top.is_number() && top.get<int>() != 0;
+    }
+}
+
 ParsedCircuit YosysJSONParser::parseCircuit() {
     // Parsing string
     const json &json_netlist = json::parse(this->inputFileContent);
 
-    ParsedCircuit parsedNetlist;
+    std::map<std::string, std::shared_ptr<const ModuleDefinition>> modules;
 
-    uint gate_index = 0;
-
-    if (json_netlist["modules"].size() > 1) {
-        std::cout << ORANGE_TEXT << BOLD_TEXT << "Warning" << RESET_TEXT << " : " << this->strings["warnings"]["multi_module_def"].get<std::string>() << std::endl;
-    }
-    
-    // Going through modules
-    for (const json &module : json_netlist["modules"]) {
+    // Going through modules, each one is parsed once whatever the number of its instances
+    for (auto module_json = json_netlist["modules"].begin(); module_json != json_netlist["modules"].end(); ++module_json) {
+        const json &module = module_json.value();
+        std::shared_ptr<ModuleDefinition> definition = std::make_shared<ModuleDefinition>(module_json.key());
+        definition->top = isTopModule(module);
 
         // Iterating through ports
         for (auto port = module["ports"].begin(); port != module["ports"].end(); ++port) {
             try {
-                const string &name = port.key();
                 const string &direction = port.value().find("direction").value();
-                const int &bit = port.value().find("bits").value()[0];
-
-                if (direction == "input") {
-                    parsedNetlist.input_vector.push_back(bit);
-                    gate_index++;
-                    Gate input("Input "+name, gate_index, name);
-                    input.out = bit;
-                    parsedNetlist.full_gate_vector.insert({input.id, input});
-                    parsedNetlist.output_port_mapping.push_back({bit, input.id});
-                } else if (direction == "output") {
-                    parsedNetlist.output_vector.push_back(bit);
-                    gate_index++;
-                    Gate output("Output "+name, gate_index, name);
-                    output.in.insert({bit, "A"});
-                    parsedNetlist.full_gate_vector.insert({output.id, output});
-                    parsedNetlist.input_port_mapping.push_back({bit, output.id});
-                } else {
+                if (direction != "input" && direction != "output") {
                     throw std::runtime_error("");
                 }
+                definition->ports.push_back({port.key(), direction, readBits(port.value().find("bits").value(), "port '" + port.key() + "'")});
             } catch (std::runtime_error e) {
                 std::cerr << "Port definition error" << std::endl;
                 exit(1);
@@ -75,77 +85,55 @@ ParsedCircuit YosysJSONParser::parseCircuit() {
         }
 
         // Iterating through wires
-        for (const json &wire : module["netnames"]) {
-            parsedNetlist.wire_vector.push_back(wire["bits"][0]);
+        for (auto wire = module["netnames"].begin(); wire != module["netnames"].end(); ++wire) {
+            const json &bits = wire.value()["bits"];
+            for (size_t i = 0; i < bits.size(); ++i) {
+                if (!bits[i].is_number_unsigned()) continue;
+                definition->nets.insert({bits[i].get<uint>(), bits.size() == 1 ? wire.key() : wire.key() + "[" + std::to_string(i) + "]"});
+            }
         }
 
         // Iterating through cells
         for (auto cell_json = module["cells"].begin(); cell_json != module["cells"].end(); ++cell_json) {
-            try {
-                // Define regex pattern for memory cells
-                std::regex memoryPattern("\\$\\_(S?DFF|DLATCH|SR).*_$", std::regex::icase);
-
-                // Creating new instance of gate
-                Gate cell = Gate(cell_json.value().find("type").value(), gate_index++, cell_json.key());
-
-                // Filling the input and output of the gate 
-                for (auto &port : cell_json.value().find("port_directions").value().items()) {
-                    if (port.value() == "output") {
-                        cell.out = cell_json.value().find("connections").value()[port.key()][0];
-                        parsedNetlist.output_port_mapping.push_back({cell_json.value().find("connections").value()[port.key()][0], cell.id});
-                    } else if (port.value() == "input") {
-                        cell.input_length ++;
-                        cell.in.insert({cell_json.value().find("connections").value()[port.key()][0], port.key()});
-                        parsedNetlist.input_port_mapping.push_back({cell_json.value().find("connections").value()[port.key()][0], cell.id});
-                    }
+            const string &type = cell_json.value().find("type").value();
+            const json &connections = cell_json.value().find("connections").value();
+            const string where = "cell '" + cell_json.key() + "' of module '" + definition->name + "'";
+
+            // Instance of another module of the netlist, resolved at elaboration
+            if (!isBasicCell(type)) {
+                Instance instance = {cell_json.key(), type, {}};
+                for (auto connection = connections.begin(); connection != connections.end(); ++connection) {
+                    instance.connections.insert({connection.key(), readBits(connection.value(), where)});
                 }
+                definition->instances.push_back(instance);
+                continue;
+            }
 
-                parsedNetlist.full_gate_vector.insert({cell.id, cell});
-                
-                // Check if cell is a memory cell
-                if (std::regex_match(cell.name, memoryPattern)) {
-                    parsedNetlist.memory_gate_vector.push_back(cell);
+            // Creating new instance of gate, the index is given at elaboration
+            Gate cell = Gate(type, 0, cell_json.key());
+            bool has_output = false;
+
+            // Filling the input and output of the gate 
+            for (auto &port : cell_json.value().find("port_directions").value().items()) {
+                if (port.value() == "output") {
+                    cell.out = readBits(connections[port.key()], where)[0];
+                    has_output = true;
+                } else if (port.value() == "input") {
+                    cell.input_length ++;
+                    cell.in.insert({readBits(connections[port.key()], where)[0], port.key()});
                 }
-                
-                // Check if cell is an unary gate
-                else if (unaryCells.find(cell.name) != unaryCells.end()) {
-                    parsedNetlist.unary_gate_vector.push_back(cell);
-                }
-                
-                // Check if cell is a binary gate
-                else if (binaryCells.find(cell.name) != binaryCells.end()) {
-                    parsedNetlist.binary_gate_vector.push_back(cell);
-                }
-                
-                // Check if cell is a complex gate
-                else if (complexCells.find(cell.name) != complexCells.end()) {
-                    parsedNetlist.complex_gate_vector.push_back(cell);
-                }
-                
-                // Default if gate type is unknown
-                else {
-                    throw std::runtime_error("");
-                }
-            } catch (std::runtime_error e) {
+            }
+
+            if (!has_output) {
                 std::cerr << "Gate definition error" << std::endl;
                 exit(1);
             }
-        }
-    }
 
-    // Filling the direct gate mapping vector
-    for (const auto& input : parsedNetlist.input_port_mapping) {
-        for (const auto& output : parsedNetlist.output_port_mapping) {
-            if (input.first == output.first) {
-                parsedNetlist.direct_port_pair_mapping.push_back({output.second, input.second, input.first, parsedNetlist.full_gate_vector.find(input.second)->second.in.find(input.first)->second});
-            }
+            definition->cells.push_back(cell);
         }
-    }
 
-    // for convinience
-    std::sort(parsedNetlist.input_vector.begin(), parsedNetlist.input_vector.end());
-    std::sort(parsedNetlist.output_vector.begin(), parsedNetlist.output_vector.end());
-    std::sort(parsedNetlist.wire_vector.begin(), parsedNetlist.wire_vector.end());
+        modules.insert({definition->name, definition});
+    }
 
-    return parsedNetlist;
-}
\ No newline at end of file
+    return this->elaborate(modules);
+}
@@ -0,0 +1,183 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/reader/pattern_reader.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <nlohmann/json.hpp>
+
+#include "../../include/utils/ANSI.hpp"
+#include "../../include/utils/compression.hpp"
+
+namespace {
+
+// Remove the blanks at both ends of a string
+std::string trim(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+} // namespace
+
+PatternReader::PatternReader(std::shared_ptr<const CompiledCircuit> circuit) : circuit(circuit), patterns(circuit->inputs.size(), 0) {
+    this->inputCount = circuit->inputs.size();
+    for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+        this->inputPositions[circuit->nodes[circuit->inputs[input]]->getName()] = input;
+    }
+    for (uint32_t output : circuit->outputs) {
+        this->outputNames.insert(circuit->nodes[output]->getName());
+    }
+}
+
+PatternReader::Format PatternReader::getFormat(const std::string& filename, const std::string& content) {
+    if (filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0) {
+        return Format::JSON;
+    }
+    return content.find("Vector nb.") != std::string::npos ? Format::Text : Format::BitMatrix;
+}
+
+void PatternReader::read(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": file '" + filename + "' does not exist" << std::endl;
+        exit(1);
+    }
+
+    std::string content;
+    try {
+        boost::iostreams::filtering_istream stream;
+        Compression::pushDecompressor(stream, Compression::getFormat(filename));
+        stream.push(file);
+        boost::iostreams::copy(stream, boost::iostreams::back_inserter(content));
+    } catch (const std::ios_base::failure& e) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": file '" + filename + "' can't be decompressed (" << e.what() << ")" << std::endl;
+        exit(1);
+    }
+
+    this->parse(content, getFormat(Compression::removeSuffix(filename), content));
+}
+
+void PatternReader::parse(const std::string& content, Format format) {
+    if (format == Format::JSON) {
+        nlohmann::json file = nlohmann::json::parse(content, nullptr, false);
+        if (file.is_discarded() || !file.contains("Vectors") || !file["Vectors"].is_object()) {
+            std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": the vector file has no \"Vectors\" object" << std::endl;
+            exit(1);
+        }
+
+        // The vectors are numbered from 1, their keys being sorted as strings by the JSON object
+        std::vector<std::pair<long, std::string>> vectors;
+        for (const auto& vector : file["Vectors"].items()) {
+            vectors.emplace_back(std::strtol(vector.key().c_str(), nullptr, 10), vector.key());
+        }
+        std::sort(vectors.begin(), vectors.end());
+
+        for (const std::pair<long, std::string>& vector : vectors) {
+            std::map<std::string, int> bits;
+            for (const auto& bit : file["Vectors"][vector.second]["Input_bits"].items()) {
+                bits[bit.key()] = bit.value().get<int>();
+            }
+            this->addPattern(bits, vector.second);
+        }
+    } else if (format == Format::Text) {
+        std::istringstream stream(content);
+        std::string line;
+        std::string vector;
+        std::map<std::string, int> bits;
+        bool in_vector = false;
+
+        // The bits of a vector are the "<name> : <value> ;" fields of the lines following its "Vector nb.<n>" line
+        while (std::getline(stream, line)) {
+            if (line.compare(0, 10, "Vector nb.") == 0) {
+                if (in_vector) this->addPattern(bits, vector);
+                in_vector = true;
+                vector = trim(line.substr(10));
+                bits.clear();
+            } else if (in_vector) {
+                std::istringstream fields(line);
+                std::string field;
+                while (std::getline(fields, field, ';')) {
+                    const size_t separator = field.rfind(':');
+                    if (separator == std::string::npos) continue;
+                    bits[trim(field.substr(0, separator))] = std::atoi(field.c_str() + separator + 1);
+                }
+            }
+        }
+        if (in_vector) this->addPattern(bits, vector);
+    } else {
+        std::istringstream stream(content);
+        std::string line;
+        size_t line_number = 0;
+        while (std::getline(stream, line)) {
+            line_number++;
+            line = trim(line);
+            if (line.empty() || line[0] == '#') continue;
+
+            const size_t pattern = this->patterns.addPattern();
+            size_t input = 0;
+            for (char bit : line) {
+                if (std::isspace(static_cast<unsigned char>(bit))) continue;
+                if (bit != '0' && bit != '1' && bit != 'X' && bit != 'x') {
+                    std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": line " << line_number << " of the vector file has an invalid value '" << bit << "'" << std::endl;
+                    exit(1);
+                }
+                if (input < this->inputCount && bit != 'X' && bit != 'x') {
+                    this->patterns.setInput(pattern, input, bit == '1');
+                }
+                input++;
+            }
+            if (input != this->inputCount) {
+                std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": line " << line_number << " of the vector file has " << input << " values for " << this->inputCount << " primary inputs" << std::endl;
+                exit(1);
+            }
+        }
+    }
+}
+
+void PatternReader::addPattern(const std::map<std::string, int>& bits, const std::string& vector) {
+    const size_t pattern = this->patterns.addPattern();
+
+    size_t input_bits = 0;
+    for (const std::pair<const std::string, int>& bit : bits) {
+        const auto position = this->inputPositions.find(bit.first);
+        if (position != this->inputPositions.end()) {
+            this->patterns.setInput(pattern, position->second, bit.second);
+            input_bits++;
+        } else if (this->outputNames.count(bit.first) == 0) {
+            std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": vector " + vector + " has a bit '" + bit.first + "' which is not a port of the circuit" << std::endl;
+            exit(1);
+        }
+    }
+    if (input_bits != this->inputCount) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": vector " + vector + " has " << input_bits << " input bits for " << this->inputCount << " primary inputs" << std::endl;
+        exit(1);
+    }
+}
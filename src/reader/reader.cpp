@@ -24,20 +24,28 @@
 #include "../../include/reader/reader.hpp"
 
 Reader::Reader(std::string filename, std::string extension) {
+    this->selectParser(extension);
+}
+
+void Reader::selectParser(std::string extension) {
     // This allow definition of other kind of parsers
     if (extension == "json") {
         this->parser = make_shared<YosysJSONParser>(strings);
+    } else if (extension == "v") {
+        this->parser = make_shared<VerilogParser>(strings);
     } else {
         this->parser = make_shared<YosysJSONParser>(strings);
     }
 }
 
 void Reader::read(std::string filename, std::string extension, std::shared_ptr<Tree> tree) {
-    
+    // The extension is only known once the command-line options have been processed
+    this->selectParser(extension);
+
     std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["parsing"].get<std::string>() << std::endl;
     
     // Open the file
-    std::ifstream file(filename);
+    std::ifstream file(filename, std::ios::binary);
 
     // Check if the file exists
     try {
@@ -49,8 +57,17 @@ void Reader::read(std::string filename, std::string extension, std::shared_ptr<T
         exit(1);
     }
 
-    // Read the json file and store it in a string
-    const std::string fileString((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    // Read the netlist file and store it in a string, decompressing it on the fly if needed
+    std::string fileString;
+    try {
+        boost::iostreams::filtering_istream stream;
+        Compression::pushDecompressor(stream, Compression::getFormat(filename));
+        stream.push(file);
+        boost::iostreams::copy(stream, boost::iostreams::back_inserter(fileString));
+    } catch (const std::ios_base::failure& e) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": file '" + filename + "' can't be decompressed (" << e.what() << ")" << std::endl;
+        exit(1);
+    }
 
     // Close the file
     file.close();
@@ -71,13 +88,41 @@ void Reader::read(std::string filename, std::string extension, std::shared_ptr<T
 
     std::cout << CYAN_TEXT << BOLD_TEXT << "\nInfo" << RESET_TEXT << ": " << strings["global"]["tree_building"].get<std::string>() << std::endl;
 
+    this->build(netlist, tree);
+
+    // Levels and topological order of the nodes, cached in the tree
+    if (!tree->levelize()) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": the circuit '" + filename + "' contains a combinational loop" << std::endl;
+        exit(1);
+    }
+
+    // One tree per module instanciated by the top-level module, shared by its instances (a module can't contain a loop the circuit hasn't)
+    for (const auto& instance : netlist.instance_vector) {
+        if (instance.first.find('.') != std::string::npos) continue;
+        const std::string& module = instance.second->definition->name;
+        tree->InstanceList.push_back({instance.first, module});
+        if (tree->ModuleTrees.find(module) != tree->ModuleTrees.end()) continue;
+
+        std::shared_ptr<Tree> module_tree = std::make_shared<Tree>(module);
+        this->build(parser->elaborateModule(netlist, module), module_tree);
+        module_tree->levelize();
+        tree->ModuleTrees.insert({module, module_tree});
+    }
+
+    // TODO: Supprimer les print en prod
+    // Getting infos from the circuit model tree
+    //print_nodes(tree);
+    std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["tree_building_success"].get<std::string>() << RESET_TEXT << std::endl;
+}
+
+void Reader::build(const ParsedCircuit& netlist, std::shared_ptr<Tree> tree) {
     // Create and add all the nodes to the circuit model
     for (auto gate = netlist.full_gate_vector.begin(); gate != netlist.full_gate_vector.end(); gate++) {
-            size_t id = gate->second.id;
-            std::string type = gate->second.name;
-            std::string netlistName = gate->second.netlistName;
-            createAndAddNodeToTree(tree, id, type, netlistName);
-        }
+        size_t id = gate->second.id;
+        std::string type = gate->second.name;
+        std::string netlistName = gate->second.netlistName;
+        createAndAddNodeToTree(tree, id, type, netlistName);
+    }
 
     // Binding all the node
     for (const auto& assoc : netlist.direct_port_pair_mapping) {
@@ -87,9 +132,4 @@ void Reader::read(std::string filename, std::string extension, std::shared_ptr<T
 
         bind_cell(id1, id2, port, tree);
     }
-
-    // TODO: Supprimer les print en prod
-    // Getting infos from the circuit model tree
-    //print_nodes(tree);
-    std::cout << GREEN_TEXT << BOLD_TEXT << strings["global"]["tree_building_success"].get<std::string>() << RESET_TEXT << std::endl;
-}
\ No newline at end of file
+}
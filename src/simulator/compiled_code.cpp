@@ -0,0 +1,274 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/compiled_code.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+namespace {
+
+// Number of gates per generated function: the compile time grows faster than the size of the functions
+const uint32_t gatesPerFunction = 256;
+
+// Maximum number of compilers run at once, each one holding a unit in memory
+const size_t maxCompilers = 8;
+
+// Flags of the compilation of the units
+const std::string compileFlags = "-O1 -fPIC";
+
+// FNV-1a hash, stable from one run to the other
+uint64_t hashSource(const std::string& source) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : source) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Argument of a shell command, single-quoted (a quote in the argument closes the quotes, is escaped and opens them again)
+std::string quote(const std::string& argument) {
+    std::string quoted = "'";
+    for (char c : argument) {
+        if (c == '\'') {
+            quoted += "'\\''";
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "'";
+}
+
+std::string word(uint32_t gate) {
+    return "g" + std::to_string(gate);
+}
+
+// Multiplexer of the count data inputs from data[0], selected by the inputs from select[0] (low bit first)
+std::string mux(const uint32_t* data, size_t count, const uint32_t* select) {
+    if (count == 1) {
+        return word(data[0]);
+    }
+    const size_t half = count / 2;
+    const std::string s = word(select[__builtin_ctzll(half)]);
+    return "((" + mux(data, half, select) + " & ~" + s + ") | (" + mux(data + half, half, select) + " & " + s + "))";
+}
+
+// Expression of the value of a gate
+std::string expression(CellKind kind, const uint32_t* in) {
+    auto a = [in](size_t i) { return word(in[i]); };
+    switch (kind) {
+        case CellKind::Output:
+        case CellKind::Buf:
+        case CellKind::Tbuf:
+            return a(0);
+        case CellKind::Not:
+            return "~" + a(0);
+        case CellKind::And:
+            return a(0) + " & " + a(1);
+        case CellKind::Nand:
+            return "~(" + a(0) + " & " + a(1) + ")";
+        case CellKind::Andnot:
+            return a(0) + " & ~" + a(1);
+        case CellKind::Or:
+            return a(0) + " | " + a(1);
+        case CellKind::Nor:
+            return "~(" + a(0) + " | " + a(1) + ")";
+        case CellKind::Ornot:
+            return a(0) + " | ~" + a(1);
+        case CellKind::Xor:
+            return a(0) + " ^ " + a(1);
+        case CellKind::Xnor:
+            return "~(" + a(0) + " ^ " + a(1) + ")";
+        case CellKind::Aoi3:
+            return "~((" + a(0) + " & " + a(1) + ") | " + a(2) + ")";
+        case CellKind::Oai3:
+            return "~((" + a(0) + " | " + a(1) + ") & " + a(2) + ")";
+        case CellKind::Aoi4:
+            return "~((" + a(0) + " & " + a(1) + ") | (" + a(2) + " & " + a(3) + "))";
+        case CellKind::Oai4:
+            return "~((" + a(0) + " | " + a(1) + ") & (" + a(2) + " | " + a(3) + "))";
+        case CellKind::Mux:
+            return mux(in, 2, in + 2);
+        case CellKind::Nmux:
+            return "~" + mux(in, 2, in + 2);
+        case CellKind::Mux4:
+            return mux(in, 4, in + 4);
+        case CellKind::Mux8:
+            return mux(in, 8, in + 8);
+        case CellKind::Mux16:
+            return mux(in, 16, in + 16);
+        default:
+            return "0";
+    }
+}
+
+} // namespace
+
+std::vector<std::string> CompiledCode::generate(const CompiledCircuit& circuit, size_t unit_count) {
+    const uint32_t gate_count = circuit.getGateCount();
+    const uint32_t first_gate = circuit.levelOffsets.size() > 1 ? circuit.levelOffsets[1] : gate_count;
+    const std::string header = "// Generated by ATPGK: simulation of a circuit of " + std::to_string(gate_count) + " gates\n#include <cstdint>\n\ntypedef uint64_t W;\n\n";
+
+    // One function per gatesPerFunction gates, so that the compiler never has to optimize a huge function
+    std::vector<std::string> functions;
+    std::vector<uint32_t> loaded(gate_count, gate_count);
+    for (uint32_t first = first_gate; first < gate_count; first += gatesPerFunction) {
+        const uint32_t last = std::min(gate_count, first + gatesPerFunction);
+        std::ostringstream function;
+        function << "void atpgk_part" << functions.size() << "(W* v) {\n";
+
+        // The values computed by the previous functions are all loaded before the first store, 
+        // the gates being kept in local constants, so that the compiler has no memory dependency to analyse
+        for (uint32_t fanin = circuit.faninOffsets[first]; fanin < circuit.faninOffsets[last]; ++fanin) {
+            const uint32_t input = circuit.fanins[fanin];
+            if (input < first && loaded[input] != first) {
+                loaded[input] = first;
+                function << "    const W " << word(input) << " = v[" << input << "];\n";
+            }
+        }
+        for (uint32_t gate = first; gate < last; ++gate) {
+            function << "    const W " << word(gate) << " = " << expression(circuit.kinds[gate], circuit.fanins.data() + circuit.faninOffsets[gate]) << ";\n";
+            function << "    v[" << gate << "] = " << word(gate) << ";\n";
+        }
+        function << "}\n\n";
+        functions.push_back(function.str());
+    }
+
+    // The gates are numbered level by level, so the functions are called in order
+    std::ostringstream main;
+    for (size_t function = 0; function < functions.size(); ++function) {
+        main << "void atpgk_part" << function << "(W* v);\n";
+    }
+    main << "\nextern \"C\" void atpgk_simulate(W* v) {\n";
+    for (size_t function = 0; function < functions.size(); ++function) {
+        main << "    atpgk_part" << function << "(v);\n";
+    }
+    main << "}\n";
+
+    // The functions are split evenly between the units, the first one also holding the entry point
+    unit_count = std::max<size_t>(1, std::min(unit_count, functions.size()));
+    std::vector<std::string> units(unit_count, header);
+    for (size_t function = 0; function < functions.size(); ++function) {
+        units[function * unit_count / functions.size()] += functions[function];
+    }
+    units[0] += main.str();
+    return units;
+}
+
+std::string CompiledCode::getCacheDirectory() {
+    if (const char* directory = std::getenv("ATPGK_CACHE_DIR")) {
+        return directory;
+    }
+    if (const char* directory = std::getenv("XDG_CACHE_HOME")) {
+        return std::string(directory) + "/atpgk";
+    }
+    if (const char* home = std::getenv("HOME")) {
+        return std::string(home) + "/.cache/atpgk";
+    }
+    return (std::filesystem::temp_directory_path() / "atpgk").string();
+}
+
+CompiledCode::CompiledCode(const CompiledCircuit& circuit) : handle(nullptr), function(nullptr), cached(true) {
+    // $CXX is not quoted, so that it can hold a command with its arguments (such as 'ccache g++')
+    const char* compiler_variable = std::getenv("CXX");
+    const std::string compiler = compiler_variable != nullptr ? compiler_variable : "c++";
+
+    // The name of the shared object depends on the compiler and its flags, but not on the number of units it is built from
+    std::ostringstream name;
+    name << "sim_" << std::hex << std::setw(16) << std::setfill('0') << hashSource(compiler + " " + compileFlags + "\n" + generate(circuit, 1)[0]);
+
+    const std::filesystem::path directory = getCacheDirectory();
+    const std::filesystem::path library = directory / (name.str() + ".so");
+    this->libraryPath = library.string();
+
+    if (!std::filesystem::exists(library)) {
+        this->cached = false;
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        // Built under a temporary name, then renamed, so that another process never loads a partial shared object
+        const std::string prefix = (directory / name.str()).string() + "." + std::to_string(getpid());
+        const std::filesystem::path temporary = prefix + ".so";
+
+        // The units are compiled in parallel, one compiler per core up to maxCompilers, then linked together
+        const std::vector<std::string> units = generate(circuit, std::min<size_t>(maxCompilers, std::max(1u, std::thread::hardware_concurrency())));
+        std::string compile_command = "(";
+        std::string link_command = compiler + " -shared -o " + quote(temporary.string());
+        for (size_t unit = 0; unit < units.size(); ++unit) {
+            const std::string unit_path = prefix + "_" + std::to_string(unit);
+            std::ofstream(unit_path + ".cpp") << units[unit];
+            compile_command += compiler + " " + compileFlags + " -c -o " + quote(unit_path + ".o") + " " + quote(unit_path + ".cpp") + " & ";
+            link_command += " " + quote(unit_path + ".o");
+        }
+        const std::string command = compile_command + "wait) && " + link_command;
+        const int status = std::system(command.c_str());
+
+        for (size_t unit = 0; unit < units.size(); ++unit) {
+            std::filesystem::remove(prefix + "_" + std::to_string(unit) + ".cpp", error);
+            std::filesystem::remove(prefix + "_" + std::to_string(unit) + ".o", error);
+        }
+        if (status != 0 || !std::filesystem::exists(temporary)) {
+            std::filesystem::remove(temporary, error);
+            std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": the simulation code can't be compiled with '" + compiler + "'" << std::endl;
+            exit(1);
+        }
+        std::filesystem::rename(temporary, library);
+    }
+
+    this->handle = dlopen(this->libraryPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (this->handle != nullptr) {
+        this->function = reinterpret_cast<SimulateFunction>(dlsym(this->handle, "atpgk_simulate"));
+    }
+    if (this->function == nullptr) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": the simulation code '" + this->libraryPath + "' can't be loaded (" << dlerror() << ")" << std::endl;
+        exit(1);
+    }
+}
+
+CompiledCode::~CompiledCode() {
+    if (this->handle != nullptr) {
+        dlclose(this->handle);
+    }
+}
+
+CompiledCode::SimulateFunction CompiledCode::getFunction() const {
+    return this->function;
+}
+
+const std::string& CompiledCode::getLibraryPath() const {
+    return this->libraryPath;
+}
+
+bool CompiledCode::isCached() const {
+    return this->cached;
+}
@@ -0,0 +1,98 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/concurrent_fault_simulator.hpp"
+
+ConcurrentFaultSimulator::ConcurrentFaultSimulator(std::shared_ptr<const CompiledCircuit> circuit) : circuit(circuit), lists(circuit) {
+    this->queue.assign(circuit->getGateCount(), 0);
+    this->queueSizes.assign(circuit->levelOffsets.size(), 0);
+    this->scheduled.assign(circuit->getGateCount(), false);
+}
+
+void ConcurrentFaultSimulator::scheduleFanouts(uint32_t gate) {
+    const CompiledCircuit& circuit = *this->circuit;
+    for (uint32_t fanout = circuit.fanoutOffsets[gate]; fanout < circuit.fanoutOffsets[gate + 1]; ++fanout) {
+        const uint32_t child = circuit.fanouts[fanout];
+        if (!this->scheduled[child]) {
+            this->scheduled[child] = true;
+            const int level = circuit.levels[child];
+            this->queue[circuit.levelOffsets[level] + this->queueSizes[level]++] = child;
+        }
+    }
+}
+
+size_t ConcurrentFaultSimulator::simulateBlock(const LogicSimulator& good, size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern) {
+    const CompiledCircuit& circuit = *this->circuit;
+    const size_t gate_count = circuit.getGateCount();
+    this->lists.setFaults(faults, first_detection);
+
+    // Whether the good value of a gate changed since the previous pattern
+    auto goodEvent = [&good](uint32_t gate, size_t pattern) {
+        const uint64_t* value = good.getValue(gate);
+        return bool(((value[pattern / 64] >> (pattern % 64)) ^ (value[(pattern - 1) / 64] >> ((pattern - 1) % 64))) & 1);
+    };
+
+    size_t detected = 0;
+    for (size_t pattern = 0; pattern < pattern_count; ++pattern) {
+        if (pattern == 0) {
+            // The lists of the previous block may refer to other faults: all the gates are evaluated
+            for (uint32_t gate = 0; gate < gate_count; ++gate) {
+                this->lists.compute(gate, good, pattern, this->lists[gate]);
+            }
+            for (uint32_t output : circuit.outputs) {
+                detected += this->lists.detect(output, first_detection, first_pattern + pattern);
+            }
+            continue;
+        }
+
+        // Events on the primary inputs, whose lists only hold their own stuck-at fault
+        for (uint32_t input : circuit.inputs) {
+            if (goodEvent(input, pattern)) {
+                this->lists.compute(input, good, pattern, this->lists[input]);
+                this->scheduleFanouts(input);
+            }
+        }
+
+        // The fanouts of a gate have a higher level, so a gate is evaluated once, after all its inputs
+        for (size_t level = 1; level < this->queueSizes.size(); ++level) {
+            const uint32_t* scheduled = this->queue.data() + circuit.levelOffsets[level];
+            for (uint32_t i = 0; i < this->queueSizes[level]; ++i) {
+                const uint32_t gate = scheduled[i];
+                this->scheduled[gate] = false;
+
+                this->lists.compute(gate, good, pattern, this->scratch);
+                if (goodEvent(gate, pattern) || this->scratch != this->lists[gate]) {
+                    this->lists[gate].swap(this->scratch);
+                    this->scheduleFanouts(gate);
+                    // The faults of an unchanged output list were detected by a previous pattern
+                    if (circuit.kinds[gate] == CellKind::Output) {
+                        detected += this->lists.detect(gate, first_detection, first_pattern + pattern);
+                    }
+                }
+            }
+            this->queueSizes[level] = 0;
+        }
+    }
+    return detected;
+}
@@ -0,0 +1,45 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/deductive_fault_simulator.hpp"
+
+DeductiveFaultSimulator::DeductiveFaultSimulator(std::shared_ptr<const CompiledCircuit> circuit) : circuit(circuit), lists(circuit) {}
+
+size_t DeductiveFaultSimulator::simulateBlock(const LogicSimulator& good, size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern) {
+    const size_t gate_count = this->circuit->getGateCount();
+    this->lists.setFaults(faults, first_detection);
+
+    size_t detected = 0;
+    for (size_t pattern = 0; pattern < pattern_count; ++pattern) {
+        // The gates are numbered level by level, so the lists of the inputs of a gate are computed before it
+        for (uint32_t gate = 0; gate < gate_count; ++gate) {
+            this->lists.compute(gate, good, pattern, this->lists[gate]);
+        }
+
+        for (uint32_t output : this->circuit->outputs) {
+            detected += this->lists.detect(output, first_detection, first_pattern + pattern);
+        }
+    }
+    return detected;
+}
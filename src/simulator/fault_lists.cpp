@@ -0,0 +1,148 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/fault_lists.hpp"
+#include "../../include/simulator/fault_simulator.hpp"
+
+#include <algorithm>
+#include <limits>
+
+FaultLists::FaultLists(std::shared_ptr<const CompiledCircuit> circuit) : circuit(circuit), firstDetection(nullptr) {
+    this->lists.resize(circuit->getGateCount());
+    this->localFaults.assign(2 * circuit->getGateCount(), -1);
+    this->cursors.assign(20, 0);  // Inputs of a $_MUX16_
+}
+
+void FaultLists::setFaults(const std::vector<StuckAtFault>& faults, const std::vector<long>& first_detection) {
+    std::fill(this->localFaults.begin(), this->localFaults.end(), -1);
+    this->copies.assign(faults.size(), -1);
+    // The first occurrence of a fault is the one in the lists, chained to its copies
+    for (size_t i = faults.size(); i-- > 0;) {
+        if (first_detection[i] < 0) {
+            long& local = this->localFaults[2 * faults[i].gate + faults[i].value];
+            this->copies[i] = local;
+            local = i;
+        }
+    }
+    this->firstDetection = &first_detection;
+}
+
+void FaultLists::compute(uint32_t gate, const LogicSimulator& good, size_t pattern, std::vector<uint32_t>& list) {
+    const CompiledCircuit& circuit = *this->circuit;
+    const std::vector<long>& first_detection = *this->firstDetection;
+    const uint64_t* values = good.getValues() + pattern / 64;
+    const size_t words = good.getBlockWords();
+    const size_t shift = pattern % 64;
+    auto goodValue = [values, words, shift](uint32_t g) { return bool((values[g * words] >> shift) & 1); };
+    // The faults detected since the lists of the inputs were computed are left in the lists, detect() ignores them
+    auto add = [&list](uint32_t fault) { list.push_back(fault); };
+
+    // The faults changing a gate which doesn't reach any primary output are never detected
+    if (!circuit.isObservable(gate)) {
+        list.clear();
+        return;
+    }
+
+    const bool good_gate = goodValue(gate);
+    const uint32_t* in = circuit.fanins.data() + circuit.faninOffsets[gate];
+    const size_t arity = circuit.faninOffsets[gate + 1] - circuit.faninOffsets[gate];
+
+    if (arity == 1) {
+        // Buffers and inverters propagate all the faults of their input
+        list = this->lists[in[0]];
+    } else if (arity == 2) {
+        // Whether the output flips when only A, only B or both inputs flip
+        const uint32_t good_inputs = uint32_t(goodValue(in[0])) | uint32_t(goodValue(in[1])) << 1;
+        bool flips[4];
+        for (uint32_t flipped = 1; flipped < 4; ++flipped) {
+            flips[flipped] = evaluateCell(circuit.kinds[gate], good_inputs ^ flipped) != good_gate;
+        }
+
+        const std::vector<uint32_t>& a = this->lists[in[0]];
+        const std::vector<uint32_t>& b = this->lists[in[1]];
+        list.clear();
+        size_t i = 0, j = 0;
+        while (i < a.size() || j < b.size()) {
+            if (j == b.size() || (i < a.size() && a[i] < b[j])) {
+                if (flips[1]) add(a[i]);
+                i++;
+            } else if (i == a.size() || b[j] < a[i]) {
+                if (flips[2]) add(b[j]);
+                j++;
+            } else {
+                if (flips[3]) add(a[i]);
+                i++;
+                j++;
+            }
+        }
+    } else {
+        list.clear();
+        uint32_t good_inputs = 0;
+        for (size_t k = 0; k < arity; ++k) {
+            good_inputs |= uint32_t(goodValue(in[k])) << k;
+            this->cursors[k] = 0;
+        }
+
+        // Merge of the lists of the inputs: a fault propagates if flipping the inputs it reaches flips the output
+        while (true) {
+            uint32_t fault = std::numeric_limits<uint32_t>::max();
+            for (size_t k = 0; k < arity; ++k) {
+                const std::vector<uint32_t>& input_list = this->lists[in[k]];
+                if (this->cursors[k] < input_list.size()) fault = std::min(fault, input_list[this->cursors[k]]);
+            }
+            if (fault == std::numeric_limits<uint32_t>::max()) break;
+
+            uint32_t flipped = 0;
+            for (size_t k = 0; k < arity; ++k) {
+                const std::vector<uint32_t>& input_list = this->lists[in[k]];
+                if (this->cursors[k] < input_list.size() && input_list[this->cursors[k]] == fault) {
+                    flipped |= uint32_t(1) << k;
+                    this->cursors[k]++;
+                }
+            }
+            if (evaluateCell(circuit.kinds[gate], good_inputs ^ flipped) != good_gate) {
+                add(fault);
+            }
+        }
+    }
+
+    // The stuck-at fault opposite to the good value is activated by the pattern
+    const long local = this->localFaults[2 * gate + !good_gate];
+    if (local >= 0 && first_detection[local] < 0) {
+        list.insert(std::lower_bound(list.begin(), list.end(), uint32_t(local)), uint32_t(local));
+    }
+}
+
+size_t FaultLists::detect(uint32_t output, std::vector<long>& first_detection, long pattern) const {
+    size_t detected = 0;
+    for (uint32_t fault : this->lists[output]) {
+        if (first_detection[fault] < 0) {
+            for (long copy = fault; copy >= 0; copy = this->copies[copy]) {
+                first_detection[copy] = pattern;
+                detected++;
+            }
+        }
+    }
+    return detected;
+}
@@ -0,0 +1,202 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/fault_simulator.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+
+FaultSimulator::FaultSimulator(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, FaultSimulationEngine engine, size_t thread_count) : logicSimulator(circuit, type), engine(engine) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    this->difference.assign(thread_count * this->logicSimulator.getBlockWords(), 0);
+    if (thread_count > 1 && engine == FaultSimulationEngine::PPSFP) {
+        for (size_t worker = 1; worker < thread_count; ++worker) {
+            this->workerKernels.push_back(SimulationKernel::create(circuit, this->logicSimulator.getKernel().getType()));
+        }
+        this->pool = std::make_unique<WorkerPool>(thread_count);
+    }
+    if (engine == FaultSimulationEngine::Deductive) {
+        this->deductive = std::make_unique<DeductiveFaultSimulator>(circuit);
+    } else if (engine == FaultSimulationEngine::Concurrent) {
+        this->concurrent = std::make_unique<ConcurrentFaultSimulator>(circuit);
+    } else if (engine == FaultSimulationEngine::CriticalPathTracing) {
+        this->critical.assign(circuit->getGateCount() * this->logicSimulator.getBlockWords(), 0);
+        this->analysedStems.assign(circuit->getGateCount(), 0);
+
+        // A gate whose fanouts all go to the same child belongs to the region of its child
+        this->regionRoots.resize(circuit->getGateCount());
+        for (uint32_t gate = circuit->getGateCount(); gate-- > 0;) {
+            const uint32_t first_fanout = circuit->fanoutOffsets[gate];
+            const uint32_t last_fanout = circuit->fanoutOffsets[gate + 1];
+            bool single_child = first_fanout != last_fanout && circuit->kinds[gate] != CellKind::Output;
+            for (uint32_t fanout = first_fanout + 1; fanout < last_fanout; ++fanout) {
+                single_child = single_child && circuit->fanouts[fanout] == circuit->fanouts[first_fanout];
+            }
+            this->regionRoots[gate] = single_child ? this->regionRoots[circuit->fanouts[first_fanout]] : gate;
+        }
+    }
+}
+
+bool FaultSimulator::getEngine(const std::string& name, FaultSimulationEngine& engine) {
+    static const std::unordered_map<std::string, FaultSimulationEngine> engines = {
+        {"ppsfp", FaultSimulationEngine::PPSFP},
+        {"deductive", FaultSimulationEngine::Deductive},
+        {"concurrent", FaultSimulationEngine::Concurrent},
+        {"cpt", FaultSimulationEngine::CriticalPathTracing}
+    };
+
+    auto found = engines.find(name);
+    if (found == engines.end()) {
+        return false;
+    }
+    engine = found->second;
+    return true;
+}
+
+std::vector<StuckAtFault> FaultSimulator::getStuckAtFaults(const CompiledCircuit& circuit, const std::vector<std::pair<std::shared_ptr<Fault>, std::shared_ptr<Node>>>& fault_list) {
+    std::vector<StuckAtFault> faults;
+    faults.reserve(fault_list.size());
+    for (const std::pair<std::shared_ptr<Fault>, std::shared_ptr<Node>>& fault : fault_list) {
+        faults.push_back({circuit.getIndex(fault.second->getIdentifier()), fault.first->getType() == FaultModelType::StuckAtOne});
+    }
+    return faults;
+}
+
+size_t FaultSimulator::getBlockSize() const {
+    return this->logicSimulator.getBlockSize();
+}
+
+size_t FaultSimulator::getBlockWords() const {
+    return this->logicSimulator.getBlockWords();
+}
+
+FaultSimulationEngine FaultSimulator::getEngine() const {
+    return this->engine;
+}
+
+size_t FaultSimulator::getThreadCount() const {
+    return this->pool ? this->pool->getSize() : 1;
+}
+
+size_t FaultSimulator::simulateBlock(const uint64_t* patterns, size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern) {
+    this->logicSimulator.simulate(patterns);
+
+    switch (this->engine) {
+        case FaultSimulationEngine::Deductive:
+            return this->deductive->simulateBlock(this->logicSimulator, pattern_count, faults, first_detection, first_pattern);
+        case FaultSimulationEngine::Concurrent:
+            return this->concurrent->simulateBlock(this->logicSimulator, pattern_count, faults, first_detection, first_pattern);
+        case FaultSimulationEngine::CriticalPathTracing:
+            return this->simulateCriticalPaths(pattern_count, faults, first_detection, first_pattern);
+        default:
+            return this->simulatePPSFP(pattern_count, faults, first_detection, first_pattern);
+    }
+}
+
+size_t FaultSimulator::simulatePPSFP(size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern) {
+    const size_t words = this->getBlockWords();
+    const size_t used_words = (pattern_count + 63) / 64;
+    // Mask of the patterns of the last used word
+    const uint64_t last_mask = pattern_count % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (pattern_count % 64)) - 1;
+    const uint64_t* good = this->logicSimulator.getValues();
+
+    // Propagates the faults from begin to end - 1 with a kernel
+    auto propagate = [&](SimulationKernel& kernel, uint64_t* difference, size_t begin, size_t end) {
+        size_t detected = 0;
+        for (size_t i = begin; i < end; ++i) {
+            if (first_detection[i] >= 0) continue;
+
+            kernel.propagateFault(good, faults[i].gate, faults[i].value, difference);
+            for (size_t word = 0; word < used_words && word < words; ++word) {
+                const uint64_t bits = difference[word] & (word + 1 == used_words ? last_mask : ~uint64_t(0));
+                if (bits != 0) {
+                    first_detection[i] = first_pattern + word * 64 + __builtin_ctzll(bits);
+                    detected++;
+                    break;
+                }
+            }
+        }
+        return detected;
+    };
+
+    if (!this->pool) {
+        return propagate(this->logicSimulator.getKernel(), this->difference.data(), 0, faults.size());
+    }
+
+    // Small chunks balance the load, the faults of a region of the circuit having similar costs
+    const size_t chunk = 64;
+    std::atomic<size_t> next_fault(0);
+    std::atomic<size_t> detected(0);
+    this->pool->run([&](size_t worker) {
+        SimulationKernel& kernel = worker == 0 ? this->logicSimulator.getKernel() : *this->workerKernels[worker - 1];
+        uint64_t* difference = this->difference.data() + worker * words;
+        size_t worker_detected = 0;
+        size_t begin;
+        while ((begin = next_fault.fetch_add(chunk)) < faults.size()) {
+            worker_detected += propagate(kernel, difference, begin, std::min(begin + chunk, faults.size()));
+        }
+        detected += worker_detected;
+    });
+    return detected;
+}
+
+size_t FaultSimulator::simulateCriticalPaths(size_t pattern_count, const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection, long first_pattern) {
+    const size_t words = this->getBlockWords();
+    const size_t used_words = (pattern_count + 63) / 64;
+    // Mask of the patterns of the last used word
+    const uint64_t last_mask = pattern_count % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (pattern_count % 64)) - 1;
+
+    // Only the stems whose region has faults not detected yet are analysed
+    std::fill(this->analysedStems.begin(), this->analysedStems.end(), 0);
+    for (size_t i = 0; i < faults.size(); ++i) {
+        if (first_detection[i] < 0) {
+            this->analysedStems[this->regionRoots[faults[i].gate]] = 1;
+        }
+    }
+    this->logicSimulator.getKernel().traceCritical(this->logicSimulator.getValues(), this->analysedStems.data(), this->critical.data());
+
+    size_t detected = 0;
+    for (size_t i = 0; i < faults.size(); ++i) {
+        if (first_detection[i] >= 0) continue;
+
+        // A stuck-at fault is detected where its gate is critical and its good value is the opposite of the stuck value
+        const uint64_t* critical = this->critical.data() + faults[i].gate * words;
+        const uint64_t* good = this->logicSimulator.getValue(faults[i].gate);
+        for (size_t word = 0; word < used_words && word < words; ++word) {
+            const uint64_t activated = faults[i].value ? ~good[word] : good[word];
+            const uint64_t bits = critical[word] & activated & (word + 1 == used_words ? last_mask : ~uint64_t(0));
+            if (bits != 0) {
+                first_detection[i] = first_pattern + word * 64 + __builtin_ctzll(bits);
+                detected++;
+                break;
+            }
+        }
+    }
+    return detected;
+}
+
+const LogicSimulator& FaultSimulator::getLogicSimulator() const {
+    return this->logicSimulator;
+}
@@ -0,0 +1,58 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+// This file is compiled with -mavx2, its kernel is only created if the CPU supports AVX2
+
+#include <immintrin.h>
+
+#include "../../include/simulator/word_kernel.hpp"
+
+namespace {
+
+/**
+ * @brief Operations on 256-bit AVX2 words.
+ */
+struct AVX2Ops {
+    using Word = __m256i;
+    static constexpr size_t words = 4;
+    static constexpr const char* name = "AVX2";
+
+    static Word load(const uint64_t* address) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(address)); }
+    static void store(uint64_t* address, Word word) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(address), word); }
+    static Word zero() { return _mm256_setzero_si256(); }
+    static Word ones() { return _mm256_set1_epi64x(-1); }
+    static Word bitAnd(Word a, Word b) { return _mm256_and_si256(a, b); }
+    static Word bitOr(Word a, Word b) { return _mm256_or_si256(a, b); }
+    static Word bitXor(Word a, Word b) { return _mm256_xor_si256(a, b); }
+    static Word bitNot(Word a) { return _mm256_xor_si256(a, ones()); }
+    static Word andNot(Word a, Word b) { return _mm256_andnot_si256(b, a); }
+    static Word select(Word s, Word a, Word b) { return _mm256_or_si256(_mm256_andnot_si256(s, a), _mm256_and_si256(s, b)); }
+    static bool any(Word a) { return !_mm256_testz_si256(a, a); }
+};
+
+} // namespace
+
+SimulationKernel* createAVX2Kernel(const std::shared_ptr<const CompiledCircuit>& circuit) {
+    return new WordKernel<AVX2Ops>(circuit);
+}
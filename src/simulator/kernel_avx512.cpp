@@ -0,0 +1,60 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+// This file is compiled with -mavx512f, its kernel is only created if the CPU supports AVX-512F
+
+#include <immintrin.h>
+
+#include "../../include/simulator/word_kernel.hpp"
+
+namespace {
+
+/**
+ * @brief Operations on 512-bit AVX-512 words.
+ */
+struct AVX512Ops {
+    using Word = __m512i;
+    static constexpr size_t words = 8;
+    static constexpr const char* name = "AVX-512";
+
+    static Word load(const uint64_t* address) { return _mm512_loadu_si512(address); }
+    static void store(uint64_t* address, Word word) { _mm512_storeu_si512(address, word); }
+    static Word zero() { return _mm512_setzero_si512(); }
+    static Word ones() { return _mm512_set1_epi64(-1); }
+    static Word bitAnd(Word a, Word b) { return _mm512_and_si512(a, b); }
+    static Word bitOr(Word a, Word b) { return _mm512_or_si512(a, b); }
+    static Word bitXor(Word a, Word b) { return _mm512_xor_si512(a, b); }
+    static Word bitNot(Word a) { return _mm512_ternarylogic_epi64(a, a, a, 0x55); }
+    // Truth table 0x30: a & ~b, _mm512_andnot_si512 passes an undefined source operand that GCC reports as uninitialized
+    static Word andNot(Word a, Word b) { return _mm512_ternarylogic_epi64(a, b, b, 0x30); }
+    // Truth table 0xCA: s ? b : a in a single instruction
+    static Word select(Word s, Word a, Word b) { return _mm512_ternarylogic_epi64(s, b, a, 0xCA); }
+    static bool any(Word a) { return _mm512_test_epi64_mask(a, a) != 0; }
+};
+
+} // namespace
+
+SimulationKernel* createAVX512Kernel(const std::shared_ptr<const CompiledCircuit>& circuit) {
+    return new WordKernel<AVX512Ops>(circuit);
+}
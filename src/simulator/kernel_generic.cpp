@@ -0,0 +1,84 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/word_kernel.hpp"
+
+#ifdef ATPGK_COMPILED_CODE
+#include "../../include/simulator/compiled_code.hpp"
+#endif
+
+namespace {
+
+/**
+ * @brief Portable operations on 64-bit words.
+ */
+struct GenericOps {
+    using Word = uint64_t;
+    static constexpr size_t words = 1;
+    static constexpr const char* name = "generic";
+
+    static Word load(const uint64_t* address) { return *address; }
+    static void store(uint64_t* address, Word word) { *address = word; }
+    static Word zero() { return 0; }
+    static Word ones() { return ~uint64_t(0); }
+    static Word bitAnd(Word a, Word b) { return a & b; }
+    static Word bitOr(Word a, Word b) { return a | b; }
+    static Word bitXor(Word a, Word b) { return a ^ b; }
+    static Word bitNot(Word a) { return ~a; }
+    static Word andNot(Word a, Word b) { return a & ~b; }
+    static Word select(Word s, Word a, Word b) { return (a & ~s) | (b & s); }
+    static bool any(Word a) { return a != 0; }
+};
+
+#ifdef ATPGK_COMPILED_CODE
+/**
+ * @class CompiledCodeKernel
+ * @brief Portable kernel simulating the good circuit with generated code, the other simulations being the ones of the portable kernel.
+ */
+class CompiledCodeKernel : public WordKernel<GenericOps> {
+public:
+    CompiledCodeKernel(const std::shared_ptr<const CompiledCircuit>& circuit) : WordKernel<GenericOps>(circuit), code(*circuit) {
+        this->name = "compiled";
+    }
+
+    void simulate(uint64_t* values) override {
+        this->code.getFunction()(values);
+    }
+
+private:
+    CompiledCode code;
+};
+#endif
+
+} // namespace
+
+SimulationKernel* createGenericKernel(const std::shared_ptr<const CompiledCircuit>& circuit) {
+    return new WordKernel<GenericOps>(circuit);
+}
+
+#ifdef ATPGK_COMPILED_CODE
+SimulationKernel* createCompiledCodeKernel(const std::shared_ptr<const CompiledCircuit>& circuit) {
+    return new CompiledCodeKernel(circuit);
+}
+#endif
@@ -0,0 +1,91 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/logic_simulator.hpp"
+
+#include <algorithm>
+
+LogicSimulator::LogicSimulator(std::shared_ptr<const CompiledCircuit> circuit, KernelType type) : circuit(circuit), simulated(false) {
+    this->kernel = SimulationKernel::create(circuit, type);
+    this->values.assign(circuit->getGateCount() * this->kernel->getBlockWords(), 0);
+}
+
+size_t LogicSimulator::getBlockSize() const {
+    return this->kernel->getBlockSize();
+}
+
+size_t LogicSimulator::getBlockWords() const {
+    return this->kernel->getBlockWords();
+}
+
+std::string LogicSimulator::getKernelName() const {
+    return this->kernel->getName();
+}
+
+void LogicSimulator::simulate(const uint64_t* patterns) {
+    const size_t words = this->getBlockWords();
+    for (size_t i = 0; i < this->circuit->inputs.size(); ++i) {
+        std::copy(patterns + i * words, patterns + (i + 1) * words, this->values.begin() + this->circuit->inputs[i] * words);
+    }
+    this->kernel->simulate(this->values.data());
+    this->changedInputs.clear();
+    this->simulated = true;
+}
+
+void LogicSimulator::setInput(size_t input, const uint64_t* value) {
+    const size_t words = this->getBlockWords();
+    const uint32_t gate = this->circuit->inputs[input];
+    uint64_t* current = this->values.data() + gate * words;
+    if (std::equal(value, value + words, current)) {
+        return;
+    }
+    std::copy(value, value + words, current);
+    this->changedInputs.push_back(gate);
+}
+
+size_t LogicSimulator::update() {
+    if (!this->simulated) {
+        this->kernel->simulate(this->values.data());
+        this->changedInputs.clear();
+        this->simulated = true;
+        return this->circuit->getGateCount() - this->circuit->inputs.size();
+    }
+
+    // An input changed several times is scheduled once by the kernel
+    const size_t evaluated = this->kernel->simulateEvents(this->values.data(), this->changedInputs.data(), this->changedInputs.size());
+    this->changedInputs.clear();
+    return evaluated;
+}
+
+const uint64_t* LogicSimulator::getValue(uint32_t gate) const {
+    return this->values.data() + gate * this->getBlockWords();
+}
+
+const uint64_t* LogicSimulator::getValues() const {
+    return this->values.data();
+}
+
+SimulationKernel& LogicSimulator::getKernel() {
+    return *this->kernel;
+}
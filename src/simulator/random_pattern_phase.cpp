@@ -0,0 +1,149 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/simulator/random_pattern_phase.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// Feedback of the maximal-length polynomial x^64 + x^63 + x^61 + x^60 + 1, for a right-shifting Galois LFSR
+const uint64_t lfsrTaps = 0xD800000000000000ull;
+
+} // namespace
+
+RandomPatternGenerator::RandomPatternGenerator(PatternSource source, uint64_t seed) : source(source), random(seed), lfsr(seed != 0 ? seed : 1) {}
+
+bool RandomPatternGenerator::getSource(const std::string& name, PatternSource& source) {
+    static const std::unordered_map<std::string, PatternSource> sources = {
+        {"random", PatternSource::Random},
+        {"lfsr", PatternSource::LFSR}
+    };
+
+    auto found = sources.find(name);
+    if (found == sources.end()) {
+        return false;
+    }
+    source = found->second;
+    return true;
+}
+
+void RandomPatternGenerator::generate(uint64_t* patterns, size_t input_count, size_t block_words) {
+    // The words are drawn 64 patterns at a time, input by input, so that the patterns don't depend on the number of words per block
+    if (this->source == PatternSource::Random) {
+        for (size_t word = 0; word < block_words; ++word) {
+            for (size_t input = 0; input < input_count; ++input) {
+                patterns[input * block_words + word] = this->random();
+            }
+        }
+        return;
+    }
+
+    std::fill(patterns, patterns + input_count * block_words, 0);
+    for (size_t pattern = 0; pattern < 64 * block_words; ++pattern) {
+        for (size_t input = 0; input < input_count; ++input) {
+            const uint64_t bit = this->lfsr & 1;
+            this->lfsr = (this->lfsr >> 1) ^ (-bit & lfsrTaps);
+            patterns[input * block_words + pattern / 64] |= bit << (pattern % 64);
+        }
+    }
+}
+
+RandomPatternPhase::RandomPatternPhase(std::shared_ptr<const CompiledCircuit> circuit, KernelType type, PatternSource source, size_t max_patterns, double min_gain, FaultSimulationEngine engine, size_t thread_count)
+    : circuit(circuit), simulator(circuit, type, engine, thread_count), generator(source), maxPatterns(max_patterns), minGain(min_gain), simulatedCount(0), 
+      patterns(circuit->inputs.size(), circuit->outputs.size()) {}
+
+size_t RandomPatternPhase::run(const std::vector<StuckAtFault>& faults, std::vector<long>& first_detection) {
+    const size_t input_count = this->circuit->inputs.size();
+    const size_t output_count = this->circuit->outputs.size();
+    const size_t block_size = this->simulator.getBlockSize();
+    const size_t block_words = this->simulator.getBlockWords();
+
+    // The faults not detected yet, the only ones whose first detection is set by the phase
+    std::vector<size_t> undetected;
+    for (size_t fault = 0; fault < faults.size(); ++fault) {
+        if (first_detection[fault] < 0) undetected.push_back(fault);
+    }
+
+    size_t detected = 0;
+    std::vector<uint64_t> block(input_count * block_words);
+    std::vector<long> kept(block_size);
+    std::vector<size_t> window_detected(block_words);
+
+    bool stop = false;
+    while (!stop && !undetected.empty() && this->simulatedCount < this->maxPatterns) {
+        const size_t pattern_count = std::min(block_size, this->maxPatterns - this->simulatedCount);
+        this->generator.generate(block.data(), input_count, block_words);
+        const long first_pattern = this->simulatedCount;
+        this->simulator.simulateBlock(block.data(), pattern_count, faults, first_detection, first_pattern);
+
+        // The gain is checked for each window of 64 patterns, as with the portable kernel: the detections after the first window
+        std::fill(window_detected.begin(), window_detected.end(), 0);
+        for (size_t fault : undetected) {
+            if (first_detection[fault] >= 0) window_detected[(first_detection[fault] - first_pattern) / 64]++;
+        }
+        // below the minimum gain, or detecting the last faults, are dropped, so that the phase doesn't depend on the width of the simulation kernel
+        size_t simulated = pattern_count;
+        size_t remaining = undetected.size();
+        for (size_t window = 0; window * 64 < pattern_count; ++window) {
+            const size_t window_size = std::min<size_t>(64, pattern_count - window * 64);
+            remaining -= window_detected[window];
+            if (remaining == 0 || 100.0 * window_detected[window] * 64 / (double(window_size) * faults.size()) < this->minGain) {
+                simulated = window * 64 + window_size;
+                stop = true;
+                break;
+            }
+        }
+        this->simulatedCount += simulated;
+
+        // Only the patterns detecting a fault first are kept, the detections being renumbered after them
+        std::fill(kept.begin(), kept.end(), -1);
+        for (size_t fault : undetected) {
+            if (first_detection[fault] >= 0 && size_t(first_detection[fault] - first_pattern) < simulated) kept[first_detection[fault] - first_pattern] = 0;
+        }
+        const LogicSimulator& good = this->simulator.getLogicSimulator();
+        for (size_t bit = 0; bit < simulated; ++bit) {
+            if (kept[bit] < 0) continue;
+            kept[bit] = this->patterns.addPattern();
+            for (size_t input = 0; input < input_count; ++input) {
+                this->patterns.setInput(kept[bit], input, (block[input * block_words + bit / 64] >> (bit % 64)) & 1);
+            }
+            for (size_t output = 0; output < output_count; ++output) {
+                this->patterns.setOutput(kept[bit], output, (good.getValue(this->circuit->outputs[output])[bit / 64] >> (bit % 64)) & 1);
+            }
+        }
+        size_t still_undetected = 0;
+        for (size_t fault : undetected) {
+            if (first_detection[fault] >= 0 && size_t(first_detection[fault] - first_pattern) < simulated) {
+                first_detection[fault] = kept[first_detection[fault] - first_pattern];
+                detected++;
+            } else {
+                first_detection[fault] = -1;
+                undetected[still_undetected++] = fault;
+            }
+        }
+        undetected.resize(still_undetected);
+    }
+    return detected;
+}
@@ -0,0 +1,169 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/simulation_kernel.hpp"
+#include "../../include/tree/CompiledCircuit.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+SimulationKernel::SimulationKernel(const std::shared_ptr<const CompiledCircuit>& circuit, size_t block_words, const char* name) : circuit(circuit), type(KernelType::Generic), stamp(0) {
+    this->name = name;
+    this->blockWords = block_words;
+    this->gateCount = circuit->getGateCount();
+    this->firstGate = circuit->levelOffsets.size() > 1 ? circuit->levelOffsets[1] : this->gateCount;
+
+    this->kinds = circuit->kinds.data();
+    this->levels = circuit->levels.data();
+    this->levelOffsets = circuit->levelOffsets.data();
+    this->faninOffsets = circuit->faninOffsets.data();
+    this->fanins = circuit->fanins.data();
+    this->fanoutOffsets = circuit->fanoutOffsets.data();
+    this->fanouts = circuit->fanouts.data();
+
+    this->faultyStorage.assign(this->gateCount * block_words, 0);
+    this->stampStorage.assign(2 * this->gateCount, 0);
+    this->queueStorage.assign(this->gateCount + circuit->levelOffsets.size(), 0);
+
+    this->observableStorage.resize(this->gateCount);
+    for (uint32_t gate = 0; gate < this->gateCount; ++gate) {
+        this->observableStorage[gate] = circuit->isObservable(gate);
+    }
+    this->observable = this->observableStorage.data();
+
+    this->faultyValues = this->faultyStorage.data();
+    this->faultyStamps = this->stampStorage.data();
+    this->scheduledStamps = this->stampStorage.data() + this->gateCount;
+    this->queue = this->queueStorage.data();
+    this->queueSizes = this->queueStorage.data() + this->gateCount;
+}
+
+SimulationKernel::~SimulationKernel() {}
+
+std::string SimulationKernel::getName() const {
+    return this->name;
+}
+
+uint32_t SimulationKernel::nextStamp() {
+    // The stamps of the previous propagations are cleared when the counter wraps around
+    if (++this->stamp == 0) {
+        std::fill(this->stampStorage.begin(), this->stampStorage.end(), 0);
+        this->stamp = 1;
+    }
+    return this->stamp;
+}
+
+bool SimulationKernel::isSupported(KernelType type) {
+    switch (type) {
+        case KernelType::Auto:
+        case KernelType::Generic:
+            return true;
+#ifdef ATPGK_COMPILED_CODE
+        case KernelType::Compiled:
+            return true;
+#endif
+#ifdef ATPGK_SIMD_KERNELS
+        case KernelType::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case KernelType::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+    }
+}
+
+bool SimulationKernel::getKernelType(const std::string& name, KernelType& type) {
+    static const std::unordered_map<std::string, KernelType> types = {
+        {"auto", KernelType::Auto},
+        {"generic", KernelType::Generic},
+        {"avx2", KernelType::AVX2},
+        {"avx512", KernelType::AVX512},
+        {"compiled", KernelType::Compiled}
+    };
+
+    auto found = types.find(name);
+    if (found == types.end()) {
+        return false;
+    }
+    type = found->second;
+    return true;
+}
+
+std::string SimulationKernel::getTypeName(KernelType type) {
+    switch (type) {
+        case KernelType::Generic:
+            return "generic";
+        case KernelType::AVX2:
+            return "avx2";
+        case KernelType::AVX512:
+            return "avx512";
+        case KernelType::Compiled:
+            return "compiled";
+        default:
+            return "auto";
+    }
+}
+
+std::unique_ptr<SimulationKernel> SimulationKernel::create(std::shared_ptr<const CompiledCircuit> circuit, KernelType type) {
+    type = resolve(type);
+
+    if (!isSupported(type)) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": the requested simulation kernel is not supported by this CPU" << std::endl;
+        exit(1);
+    }
+
+    std::unique_ptr<SimulationKernel> kernel;
+    switch (type) {
+#ifdef ATPGK_COMPILED_CODE
+        case KernelType::Compiled:
+            kernel.reset(createCompiledCodeKernel(circuit));
+            break;
+#endif
+#ifdef ATPGK_SIMD_KERNELS
+        case KernelType::AVX2:
+            kernel.reset(createAVX2Kernel(circuit));
+            break;
+        case KernelType::AVX512:
+            kernel.reset(createAVX512Kernel(circuit));
+            break;
+#endif
+        default:
+            kernel.reset(createGenericKernel(circuit));
+            type = KernelType::Generic;
+    }
+    kernel->type = type;
+    return kernel;
+}
+
+KernelType SimulationKernel::resolve(KernelType type) {
+    if (type != KernelType::Auto) {
+        return type;
+    }
+    // The widest instruction set supported by the CPU, the fastest on full blocks
+    for (KernelType candidate : {KernelType::AVX512, KernelType::AVX2}) {
+        if (isSupported(candidate)) return candidate;
+    }
+    return KernelType::Generic;
+}
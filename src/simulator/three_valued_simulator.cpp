@@ -0,0 +1,139 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/three_valued_simulator.hpp"
+
+#include <algorithm>
+
+ThreeValuedSimulator::ThreeValuedSimulator(std::shared_ptr<const CompiledCircuit> circuit, KernelType type) : circuit(circuit) {
+    this->kernel = SimulationKernel::create(circuit, type);
+    this->values.assign(2 * circuit->getGateCount() * this->kernel->getBlockWords(), 0);
+}
+
+size_t ThreeValuedSimulator::getBlockSize() const {
+    return this->kernel->getBlockSize();
+}
+
+size_t ThreeValuedSimulator::getBlockWords() const {
+    return this->kernel->getBlockWords();
+}
+
+std::string ThreeValuedSimulator::getKernelName() const {
+    return this->kernel->getName();
+}
+
+void ThreeValuedSimulator::clearInputs() {
+    const size_t words = this->getBlockWords();
+    for (uint32_t input : this->circuit->inputs) {
+        std::fill_n(this->values.begin() + 2 * input * words, 2 * words, 0);
+    }
+}
+
+void ThreeValuedSimulator::setInputValue(size_t input, size_t cube, int value) {
+    const size_t words = this->getBlockWords();
+    uint64_t* one = this->values.data() + 2 * this->circuit->inputs[input] * words + cube / 64;
+    uint64_t* zero = one + words;
+    const uint64_t bit = uint64_t(1) << (cube % 64);
+
+    *one &= ~bit;
+    *zero &= ~bit;
+    if (value == 1) {
+        *one |= bit;
+    } else if (value == 0) {
+        *zero |= bit;
+    }
+}
+
+void ThreeValuedSimulator::simulate() {
+    this->kernel->simulateThreeValued(this->values.data());
+}
+
+void ThreeValuedSimulator::simulate(const uint64_t* ones, const uint64_t* zeros) {
+    const size_t words = this->getBlockWords();
+    for (size_t i = 0; i < this->circuit->inputs.size(); ++i) {
+        uint64_t* value = this->values.data() + 2 * this->circuit->inputs[i] * words;
+        std::copy(ones + i * words, ones + (i + 1) * words, value);
+        std::copy(zeros + i * words, zeros + (i + 1) * words, value + words);
+    }
+    this->simulate();
+}
+
+void ThreeValuedSimulator::detect(const std::vector<int>& cube, const std::vector<StuckAtFault>& faults, std::vector<bool>& detected) {
+    const size_t words = this->getBlockWords();
+    const size_t faulty_count = this->getBlockSize() - 1;
+    detected.assign(faults.size(), false);
+
+    // Pattern 0 is the good circuit, pattern k the faulty circuit of the fault first + k - 1
+    std::vector<ForcedValue> forced;
+    std::vector<uint64_t> differences(words);
+    for (size_t first = 0; first < faults.size(); first += faulty_count) {
+        // The same cube in all the patterns of the block, the previous block having forced some inputs
+        for (size_t i = 0; i < this->circuit->inputs.size(); ++i) {
+            uint64_t* value = this->values.data() + 2 * this->circuit->inputs[i] * words;
+            std::fill_n(value, words, cube[i] == 1 ? ~uint64_t(0) : 0);
+            std::fill_n(value + words, words, cube[i] == 0 ? ~uint64_t(0) : 0);
+        }
+
+        const size_t count = std::min(faulty_count, faults.size() - first);
+        forced.clear();
+        for (size_t k = 0; k < count; ++k) {
+            forced.push_back({faults[first + k].gate, uint32_t(k + 1), faults[first + k].value});
+        }
+        std::stable_sort(forced.begin(), forced.end(), [](const ForcedValue& a, const ForcedValue& b) { return a.gate < b.gate; });
+        this->kernel->simulateThreeValued(this->values.data(), forced.data(), forced.size());
+
+        // The faulty circuits whose output is known and opposite to the known good value
+        std::fill(differences.begin(), differences.end(), 0);
+        for (uint32_t output : this->circuit->outputs) {
+            const int good = this->getValue(output, 0);
+            if (good < 0) continue;
+            const uint64_t* opposite = good == 1 ? this->getZeros(output) : this->getOnes(output);
+            for (size_t word = 0; word < words; ++word) {
+                differences[word] |= opposite[word];
+            }
+        }
+        for (size_t k = 0; k < count; ++k) {
+            detected[first + k] = (differences[(k + 1) / 64] >> ((k + 1) % 64)) & 1;
+        }
+    }
+}
+
+int ThreeValuedSimulator::getValue(uint32_t gate, size_t cube) const {
+    const uint64_t bit = uint64_t(1) << (cube % 64);
+    if (this->getOnes(gate)[cube / 64] & bit) {
+        return 1;
+    }
+    if (this->getZeros(gate)[cube / 64] & bit) {
+        return 0;
+    }
+    return -1;
+}
+
+const uint64_t* ThreeValuedSimulator::getOnes(uint32_t gate) const {
+    return this->values.data() + 2 * gate * this->getBlockWords();
+}
+
+const uint64_t* ThreeValuedSimulator::getZeros(uint32_t gate) const {
+    return this->getOnes(gate) + this->getBlockWords();
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/simulator/worker_pool.hpp"
+
+WorkerPool::WorkerPool(size_t worker_count) : job(nullptr), generation(0), running(0), stopping(false) {
+    for (size_t worker = 1; worker < worker_count; ++worker) {
+        this->threads.emplace_back(&WorkerPool::work, this, worker);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->started.notify_all();
+    for (std::thread& thread : this->threads) {
+        thread.join();
+    }
+}
+
+size_t WorkerPool::getSize() const {
+    return this->threads.size() + 1;
+}
+
+void WorkerPool::run(const std::function<void(size_t)>& job) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->job = &job;
+        this->running = this->threads.size();
+        this->generation++;
+    }
+    this->started.notify_all();
+
+    job(0);
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->finished.wait(lock, [this] { return this->running == 0; });
+    this->job = nullptr;
+}
+
+void WorkerPool::work(size_t worker) {
+    size_t seen_generation = 0;
+    while (true) {
+        const std::function<void(size_t)>* current_job;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->started.wait(lock, [this, seen_generation] { return this->stopping || this->generation != seen_generation; });
+            if (this->stopping) {
+                return;
+            }
+            seen_generation = this->generation;
+            current_job = this->job;
+        }
+
+        (*current_job)(worker);
+
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (--this->running == 0) {
+            this->finished.notify_one();
+        }
+    }
+}
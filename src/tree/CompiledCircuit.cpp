@@ -0,0 +1,339 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+
+#include "../../include/tree/CompiledCircuit.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+bool getCellKind(const std::string& type, CellKind& kind) {
+    static const std::unordered_map<std::string, CellKind> kinds = {
+        {"Input", CellKind::Input},
+        {"Output", CellKind::Output},
+        {"$_BUF_", CellKind::Buf},
+        {"$_NOT_", CellKind::Not},
+        {"$_AND_", CellKind::And},
+        {"$_NAND_", CellKind::Nand},
+        {"$_ANDNOT_", CellKind::Andnot},
+        {"$_OR_", CellKind::Or},
+        {"$_NOR_", CellKind::Nor},
+        {"$_ORNOT_", CellKind::Ornot},
+        {"$_XOR_", CellKind::Xor},
+        {"$_XNOR_", CellKind::Xnor},
+        {"$_AOI3_", CellKind::Aoi3},
+        {"$_OAI3_", CellKind::Oai3},
+        {"$_AOI4_", CellKind::Aoi4},
+        {"$_OAI4_", CellKind::Oai4},
+        {"$_MUX_", CellKind::Mux},
+        {"$_NMUX_", CellKind::Nmux},
+        {"$_MUX4_", CellKind::Mux4},
+        {"$_MUX8_", CellKind::Mux8},
+        {"$_MUX16_", CellKind::Mux16},
+        {"$_TBUF_", CellKind::Tbuf}
+    };
+
+    auto found = kinds.find(type);
+    if (found == kinds.end()) {
+        return false;
+    }
+    kind = found->second;
+    return true;
+}
+
+size_t getCellArity(CellKind kind) {
+    switch (kind) {
+        case CellKind::Input:
+            return 0;
+        case CellKind::Output:
+        case CellKind::Buf:
+        case CellKind::Not:
+            return 1;
+        case CellKind::Aoi3:
+        case CellKind::Oai3:
+        case CellKind::Mux:
+        case CellKind::Nmux:
+            return 3;
+        case CellKind::Aoi4:
+        case CellKind::Oai4:
+            return 4;
+        case CellKind::Mux4:
+            return 6;   // A, B, C, D, S, T
+        case CellKind::Mux8:
+            return 11;  // A to H, S, T, U
+        case CellKind::Mux16:
+            return 20;  // A to P, S, T, U, V
+        default:
+            return 2;   // Binary cells, and $_TBUF_ (A, EN)
+    }
+}
+
+bool evaluateCell(CellKind kind, uint32_t inputs) {
+    auto in = [inputs](size_t i) { return bool((inputs >> i) & 1); };
+    // Data input of a multiplexer with data_count data inputs, followed by its select inputs (low bit first)
+    auto mux = [inputs](size_t data_count, size_t select_count) {
+        return bool((inputs >> ((inputs >> data_count) & ((1u << select_count) - 1))) & 1);
+    };
+
+    switch (kind) {
+        case CellKind::Input:
+            return false;
+        case CellKind::Output:
+        case CellKind::Buf:
+        case CellKind::Tbuf:
+            return in(0);
+        case CellKind::Not:
+            return !in(0);
+        case CellKind::And:
+            return in(0) && in(1);
+        case CellKind::Nand:
+            return !(in(0) && in(1));
+        case CellKind::Andnot:
+            return in(0) && !in(1);
+        case CellKind::Or:
+            return in(0) || in(1);
+        case CellKind::Nor:
+            return !(in(0) || in(1));
+        case CellKind::Ornot:
+            return in(0) || !in(1);
+        case CellKind::Xor:
+            return in(0) != in(1);
+        case CellKind::Xnor:
+            return in(0) == in(1);
+        case CellKind::Aoi3:
+            return !((in(0) && in(1)) || in(2));
+        case CellKind::Oai3:
+            return !((in(0) || in(1)) && in(2));
+        case CellKind::Aoi4:
+            return !((in(0) && in(1)) || (in(2) && in(3)));
+        case CellKind::Oai4:
+            return !((in(0) || in(1)) && (in(2) || in(3)));
+        case CellKind::Mux:
+            return mux(2, 1);
+        case CellKind::Nmux:
+            return !mux(2, 1);
+        case CellKind::Mux4:
+            return mux(4, 2);
+        case CellKind::Mux8:
+            return mux(8, 3);
+        case CellKind::Mux16:
+            return mux(16, 4);
+    }
+    return false;
+}
+
+int getControllingValue(CellKind kind, size_t input) {
+    const size_t arity = getCellArity(kind);
+    // The wide multiplexers have no controlling value, and enumerating their inputs would be too long
+    if (arity < 2 || arity > 8 || input >= arity) return -1;
+
+    int controlling = -1;
+    for (uint32_t value = 0; value < 2; ++value) {
+        // The output must be the same for all the values of the other inputs
+        bool constant = true;
+        const bool output = evaluateCell(kind, value << input);
+        for (uint32_t inputs = 0; inputs < (1u << arity) && constant; ++inputs) {
+            if (((inputs >> input) & 1) != value) continue;
+            constant = evaluateCell(kind, inputs) == output;
+        }
+        if (!constant) continue;
+        // An input controlling the output with both values leaves no other input to sensitize
+        if (controlling != -1) return -1;
+        controlling = value;
+    }
+    return controlling;
+}
+
+CompiledCircuit::CompiledCircuit(std::shared_ptr<Tree> tree) {
+    const size_t gate_count = tree->OrderedNodeList.size();
+    if (gate_count != tree->NodeList.size()) {
+        std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": the circuit must be levelized before being compiled" << std::endl;
+        exit(1);
+    }
+
+    // Gates are numbered level by level
+    this->nodes.reserve(gate_count);
+    this->index.reserve(gate_count);
+    for (const std::vector<std::shared_ptr<Node>>& level : tree->LevelList) {
+        this->levelOffsets.push_back(this->nodes.size());
+        for (const std::shared_ptr<Node>& node : level) {
+            this->index.insert({node->getIdentifier(), this->nodes.size()});
+            this->nodes.push_back(node);
+        }
+    }
+    this->levelOffsets.push_back(this->nodes.size());
+
+    this->kinds.reserve(gate_count);
+    this->levels.reserve(gate_count);
+    this->faninOffsets.reserve(gate_count + 1);
+    this->fanoutOffsets.reserve(gate_count + 1);
+
+    std::vector<std::pair<int, uint32_t>> ports;
+    for (const std::shared_ptr<Node>& node : this->nodes) {
+        CellKind kind;
+        if (!getCellKind(node->type, kind)) {
+            std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": cell '" + node->netlistName + "' of type '" + node->type + "' is not supported" << std::endl;
+            exit(1);
+        }
+        if (node->parents.size() != getCellArity(kind)) {
+            std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": cell '" + node->netlistName + "' of type '" + node->type + "' has " << node->parents.size() << " connected inputs instead of " << getCellArity(kind) << std::endl;
+            exit(1);
+        }
+        this->kinds.push_back(kind);
+        this->levels.push_back(node->level);
+
+        // Inputs sorted by port number, so that their position gives their role in the cell
+        ports.clear();
+        for (const std::pair<std::shared_ptr<Node>, int>& parent : node->parents) {
+            ports.push_back({parent.second, this->getIndex(parent.first->getIdentifier())});
+        }
+        std::sort(ports.begin(), ports.end());
+        this->faninOffsets.push_back(this->fanins.size());
+        for (const std::pair<int, uint32_t>& port : ports) {
+            this->fanins.push_back(port.second);
+        }
+
+        this->fanoutOffsets.push_back(this->fanouts.size());
+        for (const std::pair<std::shared_ptr<Node>, int>& child : node->children) {
+            this->fanouts.push_back(this->getIndex(child.first->getIdentifier()));
+        }
+    }
+    this->faninOffsets.push_back(this->fanins.size());
+    this->fanoutOffsets.push_back(this->fanouts.size());
+
+    for (const std::shared_ptr<Node>& input : tree->InputList) {
+        this->inputs.push_back(this->getIndex(input->getIdentifier()));
+    }
+    for (const std::shared_ptr<Node>& output : tree->OutputList) {
+        this->outputs.push_back(this->getIndex(output->getIdentifier()));
+    }
+
+    this->computeCones();
+    this->computeDominators();
+}
+
+size_t CompiledCircuit::getGateCount() const {
+    return this->nodes.size();
+}
+
+uint32_t CompiledCircuit::getIndex(size_t identifier) const {
+    return this->index.at(identifier);
+}
+
+void CompiledCircuit::computeCones() {
+    const size_t gate_count = this->getGateCount();
+    this->outputWords = (this->outputs.size() + 63) / 64;
+    this->inputWords = (this->inputs.size() + 63) / 64;
+
+    // Outputs reached by each gate, from the outputs back to the inputs
+    this->outputReach.assign(gate_count * this->outputWords, 0);
+    for (size_t i = 0; i < this->outputs.size(); ++i) {
+        this->outputReach[this->outputs[i] * this->outputWords + i / 64] |= uint64_t(1) << (i % 64);
+    }
+    this->observable.assign(gate_count, false);
+    for (size_t gate = gate_count; gate-- > 0;) {
+        uint64_t* reach = &this->outputReach[gate * this->outputWords];
+        for (uint32_t fanout = this->fanoutOffsets[gate]; fanout < this->fanoutOffsets[gate + 1]; ++fanout) {
+            const uint64_t* child_reach = &this->outputReach[this->fanouts[fanout] * this->outputWords];
+            for (size_t word = 0; word < this->outputWords; ++word) {
+                reach[word] |= child_reach[word];
+            }
+        }
+        this->observable[gate] = std::any_of(reach, reach + this->outputWords, [](uint64_t word) { return word != 0; });
+    }
+
+    // The cone of each output is the transposition of the rows of the primary inputs
+    this->inputCones.assign(this->outputs.size() * this->inputWords, 0);
+    for (size_t i = 0; i < this->inputs.size(); ++i) {
+        const uint64_t* reach = this->getOutputReach(this->inputs[i]);
+        for (size_t word = 0; word < this->outputWords; ++word) {
+            for (uint64_t bits = reach[word]; bits != 0; bits &= bits - 1) {
+                const size_t output = word * 64 + __builtin_ctzll(bits);
+                this->inputCones[output * this->inputWords + i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+    }
+}
+
+void CompiledCircuit::computeDominators() {
+    const size_t gate_count = this->getGateCount();
+    // The primary outputs are all dominated by a virtual sink, whose index is above the ones of the gates
+    const uint32_t sink = gate_count;
+    std::vector<uint32_t> immediate(gate_count, sink);
+
+    // Common dominator of two gates, walking up the dominator tree from the gate with the lowest index
+    auto intersect = [&immediate](uint32_t a, uint32_t b) {
+        while (a != b) {
+            while (a < b) a = immediate[a];
+            while (b < a) b = immediate[b];
+        }
+        return a;
+    };
+
+    this->dominators.assign(gate_count, NoDominator);
+    for (size_t gate = gate_count; gate-- > 0;) {
+        if (!this->observable[gate] || this->kinds[gate] == CellKind::Output) continue;
+        uint32_t dominator = NoDominator;
+        for (uint32_t fanout = this->fanoutOffsets[gate]; fanout < this->fanoutOffsets[gate + 1]; ++fanout) {
+            const uint32_t child = this->fanouts[fanout];
+            if (!this->observable[child]) continue;
+            dominator = dominator == NoDominator ? child : intersect(dominator, child);
+        }
+        immediate[gate] = dominator;
+        if (dominator != sink) this->dominators[gate] = dominator;
+    }
+}
+
+void CompiledCircuit::getSideInputValues(uint32_t gate, std::vector<std::pair<uint32_t, bool>>& values) const {
+    values.clear();
+    uint32_t last = gate;
+    while (this->dominators[last] != NoDominator) last = this->dominators[last];
+    if (last == gate) return;
+
+    // Fanout cone of the gate, only up to its last dominator: the gates after it can't be an input of a dominator
+    std::vector<bool> reached(last + 1, false);
+    std::vector<uint32_t> stack = {gate};
+    reached[gate] = true;
+    while (!stack.empty()) {
+        const uint32_t current = stack.back();
+        stack.pop_back();
+        for (uint32_t fanout = this->fanoutOffsets[current]; fanout < this->fanoutOffsets[current + 1]; ++fanout) {
+            const uint32_t child = this->fanouts[fanout];
+            if (child > last || reached[child]) continue;
+            reached[child] = true;
+            stack.push_back(child);
+        }
+    }
+
+    for (uint32_t dominator = this->dominators[gate]; dominator != NoDominator; dominator = this->dominators[dominator]) {
+        for (uint32_t position = this->faninOffsets[dominator]; position < this->faninOffsets[dominator + 1]; ++position) {
+            const uint32_t input = this->fanins[position];
+            if (reached[input]) continue;
+            const int controlling = getControllingValue(this->kinds[dominator], position - this->faninOffsets[dominator]);
+            if (controlling == -1) continue;
+            // A gate driving side inputs which need opposite values appears with both, the fault being untestable
+            const std::pair<uint32_t, bool> side(input, controlling == 0);
+            if (std::find(values.begin(), values.end(), side) == values.end()) values.push_back(side);
+        }
+    }
+}
@@ -0,0 +1,152 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/tree/ImplicationEngine.hpp"
+#include "../../include/tree/LearnedImplications.hpp"
+
+ImplicationEngine::ImplicationEngine(std::shared_ptr<const CompiledCircuit> circuit, const LearnedImplications* learned) : circuit(circuit), learned(learned), next(0) {
+    this->values.assign(circuit->getGateCount(), -1);
+}
+
+bool ImplicationEngine::assign(uint32_t gate, bool value) {
+    if (!this->set(gate, value)) return false;
+
+    // The gates whose inputs or output have just been assigned are evaluated again
+    while (this->next < this->trail.size()) {
+        const uint32_t assigned = this->trail[this->next++];
+        if (!this->evaluate(assigned)) return false;
+        for (uint32_t i = this->circuit->fanoutOffsets[assigned]; i < this->circuit->fanoutOffsets[assigned + 1]; ++i) {
+            if (!this->evaluate(this->circuit->fanouts[i])) return false;
+        }
+        if (this->learned) {
+            for (const uint32_t* literal = this->learned->begin(assigned, this->values[assigned]); literal != this->learned->end(assigned, this->values[assigned]); ++literal) {
+                if (!this->set(*literal / 2, *literal & 1)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+void ImplicationEngine::backtrack(size_t trail_size) {
+    for (size_t i = trail_size; i < this->trail.size(); ++i) {
+        this->values[this->trail[i]] = -1;
+    }
+    this->trail.resize(trail_size);
+    this->next = trail_size;
+}
+
+bool ImplicationEngine::isJustified(uint32_t gate) const {
+    if (this->values[gate] == -1 || this->circuit->kinds[gate] == CellKind::Input) return true;
+
+    const uint32_t* inputs = &this->circuit->fanins[this->circuit->faninOffsets[gate]];
+    const size_t arity = this->circuit->faninOffsets[gate + 1] - this->circuit->faninOffsets[gate];
+    uint32_t known = 0;
+    std::vector<size_t> unknown;
+    for (size_t i = 0; i < arity; ++i) {
+        if (this->values[inputs[i]] == -1) unknown.push_back(i);
+        else if (this->values[inputs[i]] == 1) known |= 1u << i;
+    }
+    if (unknown.size() > 8) return false;
+
+    for (uint32_t completion = 0; completion < (1u << unknown.size()); ++completion) {
+        uint32_t bits = known;
+        for (size_t k = 0; k < unknown.size(); ++k) {
+            if ((completion >> k) & 1) bits |= 1u << unknown[k];
+        }
+        if (evaluateCell(this->circuit->kinds[gate], bits) != (this->values[gate] == 1)) return false;
+    }
+    return true;
+}
+
+bool ImplicationEngine::forcesInput(CellKind kind, bool value) {
+    const size_t arity = getCellArity(kind);
+    if (kind == CellKind::Input || arity > 8) return false;
+
+    // Inputs at 1 (at 0) in all the assignments giving the value
+    uint32_t ones = ~0u;
+    uint32_t zeros = ~0u;
+    bool possible = false;
+    for (uint32_t inputs = 0; inputs < (1u << arity); ++inputs) {
+        if (evaluateCell(kind, inputs) != value) continue;
+        possible = true;
+        ones &= inputs;
+        zeros &= ~inputs;
+    }
+    return !possible || ((ones | zeros) & ((1u << arity) - 1)) != 0;
+}
+
+bool ImplicationEngine::set(uint32_t gate, bool value) {
+    if (this->values[gate] != -1) return this->values[gate] == value;
+    this->values[gate] = value;
+    this->trail.push_back(gate);
+    return true;
+}
+
+bool ImplicationEngine::evaluate(uint32_t gate) {
+    const CellKind kind = this->circuit->kinds[gate];
+    if (kind == CellKind::Input) return true;
+
+    const uint32_t* inputs = &this->circuit->fanins[this->circuit->faninOffsets[gate]];
+    const size_t arity = this->circuit->faninOffsets[gate + 1] - this->circuit->faninOffsets[gate];
+    uint32_t known = 0;
+    size_t unknown[8];
+    size_t unknown_count = 0;
+    for (size_t i = 0; i < arity; ++i) {
+        const int value = this->values[inputs[i]];
+        if (value == -1) {
+            if (unknown_count == 8) return true;
+            unknown[unknown_count++] = i;
+        } else if (value == 1) {
+            known |= 1u << i;
+        }
+    }
+
+    // Possible outputs, and values of each unassigned input giving the assigned output
+    const int output = this->values[gate];
+    bool outputs[2] = {false, false};
+    uint32_t feasible[2] = {0, 0};
+    for (uint32_t completion = 0; completion < (1u << unknown_count); ++completion) {
+        uint32_t bits = known;
+        for (size_t k = 0; k < unknown_count; ++k) {
+            if ((completion >> k) & 1) bits |= 1u << unknown[k];
+        }
+        const bool result = evaluateCell(kind, bits);
+        outputs[result] = true;
+        if (output == -1 || result == (output == 1)) {
+            feasible[0] |= ~completion;
+            feasible[1] |= completion;
+        }
+    }
+
+    if (output == -1) {
+        if (outputs[0] != outputs[1]) return this->set(gate, outputs[1]);
+        return true;
+    }
+    if (!outputs[output]) return false;
+    for (size_t k = 0; k < unknown_count; ++k) {
+        const bool can_be_zero = (feasible[0] >> k) & 1;
+        const bool can_be_one = (feasible[1] >> k) & 1;
+        if (can_be_zero != can_be_one && !this->set(inputs[unknown[k]], can_be_one)) return false;
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/tree/LearnedImplications.hpp"
+#include "../../include/tree/ImplicationEngine.hpp"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+// Learn the implications of the values of the gates of a circuit, except the gates already learned, as (literal, implied literal)
+void learn(const std::shared_ptr<const CompiledCircuit>& circuit, const std::vector<bool>& learned, std::vector<std::pair<uint32_t, uint32_t>>& implications) {
+    ImplicationEngine engine(circuit);
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        if (circuit->kinds[gate] == CellKind::Output || learned[gate]) continue;
+        for (uint32_t value = 0; value < 2; ++value) {
+            if (!engine.assign(gate, value)) {
+                implications.push_back({2 * gate + value, 2 * gate + !value});
+            } else {
+                // The gates of higher level were reached forward: their opposite value can't be implied back to the gate
+                for (uint32_t implied : engine.getTrail()) {
+                    const CellKind kind = circuit->kinds[implied];
+                    if (kind == CellKind::Output || circuit->levels[implied] <= circuit->levels[gate]) continue;
+                    const bool implied_value = engine.getValue(implied);
+                    if (!ImplicationEngine::forcesInput(kind, !implied_value)) {
+                        implications.push_back({2 * implied + !implied_value, 2 * gate + !value});
+                    }
+                }
+            }
+            engine.backtrack(0);
+        }
+    }
+}
+
+} // namespace
+
+LearnedImplications::LearnedImplications(std::shared_ptr<const CompiledCircuit> circuit) : circuit(circuit) {
+    std::vector<std::pair<uint32_t, uint32_t>> implications;
+    learn(circuit, std::vector<bool>(circuit->getGateCount(), false), implications);
+    this->store(implications);
+}
+
+LearnedImplications::LearnedImplications(std::shared_ptr<const CompiledCircuit> circuit, const Tree& tree) : circuit(circuit) {
+    const size_t gate_count = circuit->getGateCount();
+    std::unordered_map<std::string, uint32_t> gates;
+    if (!tree.InstanceList.empty()) {
+        for (uint32_t gate = 0; gate < gate_count; ++gate) {
+            gates.insert({circuit->nodes[gate]->netlistName, gate});
+        }
+    }
+
+    // The implications between the cells of a module hold whatever the values of its ports: they are learned once per module
+    std::vector<std::pair<uint32_t, uint32_t>> implications;
+    std::vector<bool> learned(gate_count, false);
+    for (const auto& module : tree.ModuleTrees) {
+        std::shared_ptr<const CompiledCircuit> module_circuit = std::make_shared<const CompiledCircuit>(module.second);
+        std::vector<std::pair<uint32_t, uint32_t>> module_implications;
+        learn(module_circuit, std::vector<bool>(module_circuit->getGateCount(), false), module_implications);
+
+        for (const std::pair<std::string, std::string>& instance : tree.InstanceList) {
+            if (instance.second != module.first) continue;
+
+            // Gate of the instance of each cell of the module, the ports having no gate of their own in the circuit
+            std::vector<uint32_t> instance_gates(module_circuit->getGateCount(), gate_count);
+            for (uint32_t gate = 0; gate < module_circuit->getGateCount(); ++gate) {
+                const CellKind kind = module_circuit->kinds[gate];
+                if (kind == CellKind::Input || kind == CellKind::Output) continue;
+                auto found = gates.find(instance.first + "." + module_circuit->nodes[gate]->netlistName);
+                if (found == gates.end()) continue;
+                instance_gates[gate] = found->second;
+                learned[found->second] = true;
+            }
+            for (const std::pair<uint32_t, uint32_t>& implication : module_implications) {
+                const uint32_t gate = instance_gates[implication.first / 2];
+                const uint32_t implied = instance_gates[implication.second / 2];
+                if (gate == gate_count || implied == gate_count) continue;
+                implications.push_back({2 * gate + implication.first % 2, 2 * implied + implication.second % 2});
+            }
+        }
+    }
+
+    // The gates outside the instances are learned on the whole circuit
+    learn(circuit, learned, implications);
+    this->store(implications);
+}
+
+void LearnedImplications::store(std::vector<std::pair<uint32_t, uint32_t>>& implications) {
+    const size_t gate_count = this->circuit->getGateCount();
+    std::sort(implications.begin(), implications.end());
+    implications.erase(std::unique(implications.begin(), implications.end()), implications.end());
+
+    this->offsets.assign(2 * gate_count + 1, 0);
+    this->implied.reserve(implications.size());
+    for (const std::pair<uint32_t, uint32_t>& implication : implications) {
+        this->offsets[implication.first + 1]++;
+        this->implied.push_back(implication.second);
+    }
+    for (size_t literal = 0; literal < 2 * gate_count; ++literal) {
+        this->offsets[literal + 1] += this->offsets[literal];
+    }
+}
@@ -24,6 +24,8 @@
 #include "../../include/tree/Node.hpp"
 #include "../../include/tree/NodeVisitor.hpp"
 
+#include <unordered_set>
+
 Node::Node(size_t identifier, std::string netlistName) {
     this->Identifier = identifier;
     this->netlistName = netlistName;
@@ -57,14 +59,26 @@ std::shared_ptr<Node> Node::getParentFromInputNumber(int input_number){
 
 std::shared_ptr<Node> Node::getNodeById(size_t identifier){
     if (this -> Identifier == identifier) {
-        return (std::shared_ptr<Node>) this;
+        return shared_from_this();
     }
 
-    for (std::pair<std::shared_ptr<Node>, int> pair : children) {
-        std::shared_ptr<Node> child = pair.first;
-        std::shared_ptr<Node> result = child->getNodeById(identifier);
-        if (result != nullptr) {
-            return result;
+    // Depth-first search with an explicit stack, each node being visited once
+    std::vector<std::shared_ptr<Node>> stack;
+    std::unordered_set<Node*> visited;
+    for (auto child = children.rbegin(); child != children.rend(); ++child) {
+        stack.push_back(child->first);
+    }
+
+    while (!stack.empty()) {
+        std::shared_ptr<Node> node = stack.back();
+        stack.pop_back();
+        if (!visited.insert(node.get()).second) continue;
+
+        if (node -> Identifier == identifier) {
+            return node;
+        }
+        for (auto child = node -> children.rbegin(); child != node -> children.rend(); ++child) {
+            stack.push_back(child->first);
         }
     }
     return nullptr;
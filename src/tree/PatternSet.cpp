@@ -0,0 +1,123 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/tree/PatternSet.hpp"
+
+#include <algorithm>
+
+PatternSet::PatternSet(size_t input_count, size_t output_count) : inputCount(input_count), outputCount(output_count), patternCount(0) {
+    this->inputWords = (input_count + 63) / 64;
+    this->outputWords = (output_count + 63) / 64;
+}
+
+size_t PatternSet::addPattern() {
+    this->inputOnes.resize(this->inputOnes.size() + this->inputWords, 0);
+    this->inputZeros.resize(this->inputZeros.size() + this->inputWords, 0);
+    this->outputOnes.resize(this->outputOnes.size() + this->outputWords, 0);
+    this->outputZeros.resize(this->outputZeros.size() + this->outputWords, 0);
+    if (this->patternCount % 64 == 0) {
+        this->groupOnes.resize(this->groupOnes.size() + this->inputCount, 0);
+        this->groupZeros.resize(this->groupZeros.size() + this->inputCount, 0);
+    }
+    return this->patternCount++;
+}
+
+size_t PatternSet::addPattern(const uint64_t* ones, const uint64_t* zeros) {
+    // The rails may be the ones of a pattern of the set, moved by the append
+    const std::vector<uint64_t> one_rail(ones, ones + this->inputWords);
+    const std::vector<uint64_t> zero_rail(zeros, zeros + this->inputWords);
+
+    const size_t pattern = this->addPattern();
+    this->setPattern(pattern, one_rail.data(), zero_rail.data());
+    return pattern;
+}
+
+void PatternSet::setPattern(size_t pattern, const uint64_t* ones, const uint64_t* zeros) {
+    std::copy(ones, ones + this->inputWords, this->inputOnes.begin() + pattern * this->inputWords);
+    std::copy(zeros, zeros + this->inputWords, this->inputZeros.begin() + pattern * this->inputWords);
+
+    uint64_t* group_ones = this->groupOnes.data() + (pattern / 64) * this->inputCount;
+    uint64_t* group_zeros = this->groupZeros.data() + (pattern / 64) * this->inputCount;
+    const uint64_t bit = uint64_t(1) << (pattern % 64);
+    for (size_t input = 0; input < this->inputCount; ++input) {
+        group_ones[input] = ((ones[input / 64] >> (input % 64)) & 1) ? group_ones[input] | bit : group_ones[input] & ~bit;
+        group_zeros[input] = ((zeros[input / 64] >> (input % 64)) & 1) ? group_zeros[input] | bit : group_zeros[input] & ~bit;
+    }
+}
+
+void PatternSet::clear() {
+    this->patternCount = 0;
+    this->inputOnes.clear();
+    this->inputZeros.clear();
+    this->outputOnes.clear();
+    this->outputZeros.clear();
+    this->groupOnes.clear();
+    this->groupZeros.clear();
+}
+
+void PatternSet::setInput(size_t pattern, size_t input, int value) {
+    const size_t word = pattern * this->inputWords + input / 64;
+    const uint64_t mask = uint64_t(1) << (input % 64);
+    this->inputOnes[word] = (this->inputOnes[word] & ~mask) | (value == 1 ? mask : 0);
+    this->inputZeros[word] = (this->inputZeros[word] & ~mask) | (value == 0 ? mask : 0);
+
+    const size_t group = (pattern / 64) * this->inputCount + input;
+    const uint64_t bit = uint64_t(1) << (pattern % 64);
+    this->groupOnes[group] = (this->groupOnes[group] & ~bit) | (value == 1 ? bit : 0);
+    this->groupZeros[group] = (this->groupZeros[group] & ~bit) | (value == 0 ? bit : 0);
+}
+
+void PatternSet::setOutput(size_t pattern, size_t output, int value) {
+    const size_t word = pattern * this->outputWords + output / 64;
+    const uint64_t mask = uint64_t(1) << (output % 64);
+    this->outputOnes[word] = (this->outputOnes[word] & ~mask) | (value == 1 ? mask : 0);
+    this->outputZeros[word] = (this->outputZeros[word] & ~mask) | (value == 0 ? mask : 0);
+}
+
+void PatternSet::getBlock(size_t first_pattern, size_t block_words, uint64_t* patterns) const {
+    this->copyBlock(this->groupOnes, first_pattern, block_words, patterns);
+}
+
+void PatternSet::getBlock(size_t first_pattern, size_t block_words, uint64_t* ones, uint64_t* zeros) const {
+    this->copyBlock(this->groupOnes, first_pattern, block_words, ones);
+    this->copyBlock(this->groupZeros, first_pattern, block_words, zeros);
+}
+
+void PatternSet::copyBlock(const std::vector<uint64_t>& groups, size_t first_pattern, size_t block_words, uint64_t* rail) const {
+    const size_t group_count = (this->patternCount + 63) / 64;
+    const size_t shift = first_pattern % 64;
+
+    // The bits after the last pattern are always 0 in the groups
+    auto group_word = [&](size_t group, size_t input) -> uint64_t {
+        return group < group_count ? groups[group * this->inputCount + input] : 0;
+    };
+
+    for (size_t word = 0; word < block_words; ++word) {
+        const size_t group = first_pattern / 64 + word;
+        for (size_t input = 0; input < this->inputCount; ++input) {
+            uint64_t value = group_word(group, input) >> shift;
+            if (shift) value |= group_word(group + 1, input) << (64 - shift);
+            rail[input * block_words + word] = value;
+        }
+    }
+}
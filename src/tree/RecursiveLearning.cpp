@@ -0,0 +1,131 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/tree/RecursiveLearning.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+RecursiveLearning::RecursiveLearning(std::shared_ptr<const CompiledCircuit> circuit, size_t depth, const LearnedImplications* learned) : circuit(circuit), engine(circuit, learned), depth(std::max(depth, size_t(1))) {
+    this->justifications.resize(2 * (static_cast<size_t>(CellKind::Tbuf) + 1));
+    this->built.assign(this->justifications.size(), false);
+}
+
+bool RecursiveLearning::learn() {
+    return this->learn(this->depth, 0);
+}
+
+const std::vector<RecursiveLearning::Cube>& RecursiveLearning::getJustifications(CellKind kind, bool value) {
+    const size_t index = 2 * static_cast<size_t>(kind) + value;
+    if (this->built[index]) return this->justifications[index];
+    this->built[index] = true;
+
+    const size_t arity = getCellArity(kind);
+    if (kind == CellKind::Input || arity > 8) return this->justifications[index];
+
+    // The cubes whose completions all give the value, without a smaller one
+    const uint32_t full = (1u << arity) - 1;
+    std::vector<Cube> implicants;
+    for (uint32_t mask = 0; mask <= full; ++mask) {
+        const uint32_t free = full & ~mask;
+        uint32_t values = 0;
+        do {
+            bool implicant = true;
+            uint32_t completion = 0;
+            do {
+                implicant = evaluateCell(kind, values | completion) == value;
+                completion = (completion - free) & free;
+            } while (implicant && completion != 0);
+            if (implicant) implicants.push_back({mask, values});
+            values = (values - mask) & mask;
+        } while (values != 0);
+    }
+    for (const Cube& cube : implicants) {
+        bool contains = false;
+        for (const Cube& other : implicants) {
+            contains = contains || (other.mask != cube.mask && (other.mask & cube.mask) == other.mask && (cube.values & other.mask) == other.values);
+        }
+        if (!contains) this->justifications[index].push_back(cube);
+    }
+    return this->justifications[index];
+}
+
+bool RecursiveLearning::learn(size_t depth, size_t first) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        std::vector<uint32_t> unjustified;
+        for (size_t i = first; i < this->engine.getTrail().size(); ++i) {
+            const uint32_t gate = this->engine.getTrail()[i];
+            if (!this->engine.isJustified(gate)) unjustified.push_back(gate);
+        }
+
+        for (uint32_t gate : unjustified) {
+            if (this->engine.isJustified(gate)) continue;
+            const std::vector<Cube>& cubes = this->getJustifications(this->circuit->kinds[gate], this->engine.getValue(gate));
+            if (cubes.empty()) continue;
+
+            // Values implied by every consistent justification, sorted by gate
+            const uint32_t* inputs = &this->circuit->fanins[this->circuit->faninOffsets[gate]];
+            std::vector<std::pair<uint32_t, bool>> common;
+            bool consistent = false;
+            const size_t mark = this->engine.getTrail().size();
+            for (const Cube& cube : cubes) {
+                bool success = true;
+                for (uint32_t mask = cube.mask; success && mask != 0; mask &= mask - 1) {
+                    const size_t input = __builtin_ctz(mask);
+                    success = this->engine.assign(inputs[input], (cube.values >> input) & 1);
+                }
+                if (success && depth > 1) success = this->learn(depth - 1, mark);
+
+                if (success) {
+                    std::vector<std::pair<uint32_t, bool>> implied;
+                    for (size_t i = mark; i < this->engine.getTrail().size(); ++i) {
+                        const uint32_t assigned = this->engine.getTrail()[i];
+                        implied.push_back({assigned, this->engine.getValue(assigned) == 1});
+                    }
+                    std::sort(implied.begin(), implied.end());
+                    if (!consistent) {
+                        common = implied;
+                    } else {
+                        std::vector<std::pair<uint32_t, bool>> intersection;
+                        std::set_intersection(common.begin(), common.end(), implied.begin(), implied.end(), std::back_inserter(intersection));
+                        common = intersection;
+                    }
+                    consistent = true;
+                }
+                this->engine.backtrack(mark);
+            }
+
+            if (!consistent) return false;
+            for (const std::pair<uint32_t, bool>& necessary : common) {
+                if (this->engine.getValue(necessary.first) != -1) continue;
+                if (!this->engine.assign(necessary.first, necessary.second)) return false;
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,220 @@
+/******************************************************************************
+
+    ATPGK - An automated test pattern generator for integrated circuit
+
+    Copyright (C) 2023-2024 Hugo Brisset & Gabriel Levy
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or 
+    any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+    Contact: hugo.brisset@proton.me / gabriel.levy@skiff.com
+
+******************************************************************************/
+
+#include "../../include/tree/Testability.hpp"
+
+#include <algorithm>
+
+// Sum of two costs, Infinity if one of them is
+static uint32_t addCost(uint32_t a, uint32_t b) {
+    const uint64_t sum = static_cast<uint64_t>(a) + b;
+    return sum >= Testability::Infinity ? Testability::Infinity : static_cast<uint32_t>(sum);
+}
+
+Testability::Testability(std::shared_ptr<const CompiledCircuit> circuit) : circuit(circuit) {
+    const size_t gate_count = circuit->getGateCount();
+    this->cc0.assign(gate_count, Infinity);
+    this->cc1.assign(gate_count, Infinity);
+    this->co.assign(gate_count, Infinity);
+    this->inputCo.assign(circuit->fanins.size(), Infinity);
+    this->cubes.resize(static_cast<size_t>(CellKind::Tbuf) + 1);
+
+    // The inputs of a gate have a lower index than the gate
+    for (uint32_t gate = 0; gate < gate_count; ++gate) {
+        this->computeControllability(gate);
+    }
+
+    // The outputs of a gate have a higher index than the gate
+    for (uint32_t gate = gate_count; gate-- > 0;) {
+        if (circuit->kinds[gate] == CellKind::Output) {
+            this->co[gate] = 0;
+        } else {
+            for (uint32_t i = circuit->fanoutOffsets[gate]; i < circuit->fanoutOffsets[gate + 1]; ++i) {
+                const uint32_t fanout = circuit->fanouts[i];
+                for (uint32_t j = circuit->faninOffsets[fanout]; j < circuit->faninOffsets[fanout + 1]; ++j) {
+                    if (circuit->fanins[j] == gate) this->co[gate] = std::min(this->co[gate], this->inputCo[j]);
+                }
+            }
+        }
+        this->computeInputObservability(gate);
+    }
+}
+
+uint32_t Testability::getDetectionCost(uint32_t gate, bool value) const {
+    return addCost(this->getControllability(gate, value), this->co[gate]);
+}
+
+void Testability::write(std::ostream& stream) const {
+    auto cost = [](uint32_t value) {
+        return value == Infinity ? std::string("-") : std::to_string(value);
+    };
+
+    stream << "Net CC0 CC1 CO" << std::endl;
+    for (uint32_t gate = 0; gate < this->circuit->getGateCount(); ++gate) {
+        stream << this->circuit->nodes[gate]->netlistName << " " << cost(this->cc0[gate]) << " " << cost(this->cc1[gate]) << " " << cost(this->co[gate]) << std::endl;
+    }
+}
+
+void Testability::buildCubes(CellKind kind, CellCubes& cell_cubes) {
+    const size_t arity = getCellArity(kind);
+    const uint32_t full = (1u << arity) - 1;
+    cell_cubes.sensitizing.resize(arity);
+
+    // Every assignment of the inputs of the mask, checked against every completion of the other inputs
+    for (uint32_t mask = 0; mask <= full; ++mask) {
+        const uint32_t free = full & ~mask;
+        uint32_t values = 0;
+        do {
+            bool outputs[2] = {false, false};
+            uint32_t completion = 0;
+            do {
+                outputs[evaluateCell(kind, values | completion)] = true;
+                completion = (completion - free) & free;
+            } while (completion != 0);
+            if (outputs[0] != outputs[1]) cell_cubes.implicants[outputs[1]].push_back({mask, values});
+
+            for (size_t input = 0; input < arity; ++input) {
+                const uint32_t bit = 1u << input;
+                if (mask & bit) continue;
+                const uint32_t others = free & ~bit;
+                bool sensitive = true;
+                completion = 0;
+                do {
+                    sensitive = evaluateCell(kind, values | completion) != evaluateCell(kind, values | completion | bit);
+                    completion = (completion - others) & others;
+                } while (sensitive && completion != 0);
+                if (sensitive) cell_cubes.sensitizing[input].push_back({mask, values});
+            }
+
+            values = (values - mask) & mask;
+        } while (values != 0);
+    }
+
+    // A cube containing a smaller cube of the same list never costs less
+    auto minimize = [](std::vector<Cube>& list) {
+        std::vector<Cube> minimal;
+        for (const Cube& cube : list) {
+            bool contains = false;
+            for (const Cube& other : list) {
+                contains = contains || (other.mask != cube.mask && (other.mask & cube.mask) == other.mask && (cube.values & other.mask) == other.values);
+            }
+            if (!contains) minimal.push_back(cube);
+        }
+        list = minimal;
+    };
+    minimize(cell_cubes.implicants[0]);
+    minimize(cell_cubes.implicants[1]);
+    for (std::vector<Cube>& list : cell_cubes.sensitizing) minimize(list);
+    cell_cubes.built = true;
+}
+
+uint32_t Testability::getCubeCost(uint32_t gate, const Cube& cube) const {
+    const uint32_t* inputs = &this->circuit->fanins[this->circuit->faninOffsets[gate]];
+    uint32_t cost = 0;
+    for (uint32_t mask = cube.mask; mask != 0; mask &= mask - 1) {
+        const size_t input = __builtin_ctz(mask);
+        cost = addCost(cost, this->getControllability(inputs[input], (cube.values >> input) & 1));
+    }
+    return cost;
+}
+
+uint32_t Testability::getSelectCost(uint32_t gate, size_t data_count, size_t select_count, size_t data, size_t skipped) const {
+    const uint32_t* inputs = &this->circuit->fanins[this->circuit->faninOffsets[gate]];
+    uint32_t cost = 0;
+    for (size_t select = 0; select < select_count; ++select) {
+        if (select != skipped) cost = addCost(cost, this->getControllability(inputs[data_count + select], (data >> select) & 1));
+    }
+    return cost;
+}
+
+void Testability::computeControllability(uint32_t gate) {
+    const CellKind kind = this->circuit->kinds[gate];
+    const size_t arity = getCellArity(kind);
+    const uint32_t* inputs = &this->circuit->fanins[this->circuit->faninOffsets[gate]];
+
+    if (kind == CellKind::Input) {
+        this->cc0[gate] = 1;
+        this->cc1[gate] = 1;
+    } else if (kind == CellKind::Output) {
+        // A primary output is a wire
+        this->cc0[gate] = this->cc0[inputs[0]];
+        this->cc1[gate] = this->cc1[inputs[0]];
+    } else if (arity <= 6) {
+        CellCubes& cell_cubes = this->cubes[static_cast<size_t>(kind)];
+        if (!cell_cubes.built) buildCubes(kind, cell_cubes);
+        for (int value = 0; value < 2; ++value) {
+            uint32_t cost = Infinity;
+            for (const Cube& cube : cell_cubes.implicants[value]) cost = std::min(cost, this->getCubeCost(gate, cube));
+            (value ? this->cc1 : this->cc0)[gate] = addCost(cost, 1);
+        }
+    } else {
+        // Multiplexer: one data input routed by the select inputs
+        const size_t select_count = arity == 11 ? 3 : 4;
+        const size_t data_count = size_t(1) << select_count;
+        for (int value = 0; value < 2; ++value) {
+            uint32_t cost = Infinity;
+            for (size_t data = 0; data < data_count; ++data) {
+                cost = std::min(cost, addCost(this->getControllability(inputs[data], value), this->getSelectCost(gate, data_count, select_count, data, select_count)));
+            }
+            (value ? this->cc1 : this->cc0)[gate] = addCost(cost, 1);
+        }
+    }
+}
+
+void Testability::computeInputObservability(uint32_t gate) {
+    const CellKind kind = this->circuit->kinds[gate];
+    const size_t arity = getCellArity(kind);
+    const uint32_t offset = this->circuit->faninOffsets[gate];
+    const uint32_t* inputs = &this->circuit->fanins[offset];
+
+    if (kind == CellKind::Input) {
+        return;
+    } else if (kind == CellKind::Output) {
+        this->inputCo[offset] = this->co[gate];
+    } else if (arity <= 6) {
+        const CellCubes& cell_cubes = this->cubes[static_cast<size_t>(kind)];
+        for (size_t input = 0; input < arity; ++input) {
+            uint32_t cost = Infinity;
+            for (const Cube& cube : cell_cubes.sensitizing[input]) cost = std::min(cost, this->getCubeCost(gate, cube));
+            this->inputCo[offset + input] = addCost(addCost(this->co[gate], cost), 1);
+        }
+    } else {
+        const size_t select_count = arity == 11 ? 3 : 4;
+        const size_t data_count = size_t(1) << select_count;
+        for (size_t data = 0; data < data_count; ++data) {
+            this->inputCo[offset + data] = addCost(addCost(this->co[gate], this->getSelectCost(gate, data_count, select_count, data, select_count)), 1);
+        }
+        // A select input is observed through two data inputs with opposite values
+        for (size_t select = 0; select < select_count; ++select) {
+            uint32_t cost = Infinity;
+            for (size_t data = 0; data < data_count; ++data) {
+                if ((data >> select) & 1) continue;
+                const uint32_t low = inputs[data];
+                const uint32_t high = inputs[data | (size_t(1) << select)];
+                const uint32_t values = std::min(addCost(this->cc0[low], this->cc1[high]), addCost(this->cc1[low], this->cc0[high]));
+                cost = std::min(cost, addCost(values, this->getSelectCost(gate, data_count, select_count, data, select)));
+            }
+            this->inputCo[offset + data_count + select] = addCost(addCost(this->co[gate], cost), 1);
+        }
+    }
+}
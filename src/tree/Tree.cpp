@@ -23,6 +23,8 @@
 
 #include "../../include/tree/Tree.hpp"
 
+#include <algorithm>
+
 Tree::Tree(std::string name) {
     this->name = name;
     std::vector<std::shared_ptr<Node>> InputList;
@@ -41,6 +43,7 @@ void Tree::addOutput(std::shared_ptr<Node> input){
 
 void Tree::addNode(std::shared_ptr<Node> node){
     this->NodeList.push_back(node);
+    this->NodeIndex.insert({node->getIdentifier(), node});
 }
 
 void Tree::printInputId(){
@@ -64,10 +67,9 @@ void Tree::printTree(){
 };
 
 std::shared_ptr<Node> Tree::getNodeByIdentifier(size_t identifier){
-    for (std::shared_ptr<Node> node : NodeList){
-        if (node -> getIdentifier() == identifier){
-            return node;
-        }
+    auto node = this->NodeIndex.find(identifier);
+    if (node != this->NodeIndex.end()){
+        return node->second;
     }
     std::cerr << RED_TEXT << BOLD_TEXT << "Error" << RESET_TEXT << ": no node with this identifier, id = " << identifier << std::endl;
     return nullptr;
@@ -85,5 +87,40 @@ void Tree::resetPortValue(){
     }
 };
 
+bool Tree::levelize(){
+    this->OrderedNodeList.clear();
+    this->LevelList.clear();
 
+    // Number of parents not ordered yet, for each node
+    std::unordered_map<Node*, size_t> remainingParents;
+    remainingParents.reserve(this->NodeList.size());
 
+    for (std::shared_ptr<Node>& node : this->NodeList) {
+        node->level = -1;
+        remainingParents[node.get()] = node->parents.size();
+        if (node->parents.empty()) {
+            node->level = 0;
+            this->OrderedNodeList.push_back(node);
+        }
+    }
+
+    // The ordered list is used as the queue of Kahn's algorithm
+    for (size_t i = 0; i < this->OrderedNodeList.size(); ++i) {
+        std::shared_ptr<Node> node = this->OrderedNodeList[i];
+        for (std::pair<std::shared_ptr<Node>, int>& child : node->children) {
+            child.first->level = std::max(child.first->level, node->level + 1);
+            if (--remainingParents[child.first.get()] == 0) {
+                this->OrderedNodeList.push_back(child.first);
+            }
+        }
+    }
+
+    for (std::shared_ptr<Node>& node : this->OrderedNodeList) {
+        if (node->level >= static_cast<int>(this->LevelList.size())) {
+            this->LevelList.resize(node->level + 1);
+        }
+        this->LevelList[node->level].push_back(node);
+    }
+
+    return this->OrderedNodeList.size() == this->NodeList.size();
+};
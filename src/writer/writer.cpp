@@ -23,16 +23,19 @@
 
 #include "../../include/writer/writer.hpp"
 
-Writer::Writer(std::string _filename, std::string _filetype) {
+Writer::Writer(std::string _filename, std::string _filetype, Compression::Format _compression) {
     this->fileName = _filename;
     this->fileType = _filetype;
-    this->file.open((this->fileName+"."+this->fileType).c_str());
+    Compression::pushCompressor(this->file, _compression);
+    this->file.push(boost::iostreams::file_sink(this->fileName+"."+this->fileType+Compression::getSuffix(_compression), std::ios::binary));
 };
 
 void Writer::addLineToFile(std::string lineContent) {
-    this->file << lineContent << std::endl;
+    // No flush at each line, the stream is flushed when the writer is destroyed
+    this->file << lineContent << '\n';
 };
 
 Writer::~Writer() {
-    this->file.close();
+    // Flush the compressor and close the file
+    this->file.reset();
 };
\ No newline at end of file
@@ -23,7 +23,7 @@
 
 #include "../../include/writer/writer_json.hpp"
 
-WriterJSON::WriterJSON(std::string _filename, std::string _filetype) : Writer(_filename, _filetype) {};
+WriterJSON::WriterJSON(std::string _filename, std::string _filetype, Compression::Format _compression) : Writer(_filename, _filetype, _compression) {};
 
 void WriterJSON::formatFile(std::shared_ptr<Tree> tree) {
     addLineToFile("{\n\t\"Creator\": \"Generated by ATPGK v1.0\",\n");
@@ -58,34 +58,34 @@ void WriterJSON::writeIOPort(std::shared_ptr<Tree> tree) {
     addLineToFile(lineContent);
 };
 
-void WriterJSON::writeVectors(std::shared_ptr<std::vector<std::pair<std::vector<std::pair<std::shared_ptr<Node>, int>> , std::vector<std::pair<std::shared_ptr<Node>, int>>>>> vectors_test) {
+void WriterJSON::writeVectors(std::shared_ptr<Tree> tree, std::shared_ptr<PatternSet> vectors_test) {
     int a = 0;
     std::string vector_line = "\t\"Vectors\": {";
     
-    for (const auto& pair : *vectors_test) {
+    // The bits are written sorted by name
+    std::map<std::string, size_t> input_order;
+    std::map<std::string, size_t> output_order;
+    for (size_t input = 0; input < tree->InputList.size(); ++input) {
+        input_order[tree->InputList[input]->getName()] = input;
+    }
+    for (size_t output = 0; output < tree->OutputList.size(); ++output) {
+        output_order[tree->OutputList[output]->getName()] = output;
+    }
+
+    for (size_t pattern = 0; pattern < vectors_test->getPatternCount(); ++pattern) {
         a++;
-        std::map<std::string, int> input_vector;
-        std::map<std::string, int> output_vector;
         vector_line += "\n\t\t\"" + std::to_string(a) + "\": {\n";
 
-        for (const auto& input_bit : pair.first) {
-            input_vector[input_bit.first->getName()] = input_bit.second;
-        }
-
-        for (const auto& output_bit : pair.second) {
-            output_vector[output_bit.first->getName()] = output_bit.second;
-        }
-
         vector_line += "\t\t\t\"Input_bits\": {\n\t\t\t\t";
-        for (const auto& bit : input_vector) {
-            vector_line += "\"" + bit.first + "\": " + std::to_string(bit.second) + ",";
+        for (const auto& bit : input_order) {
+            vector_line += "\"" + bit.first + "\": " + std::to_string(vectors_test->getInput(pattern, bit.second)) + ",";
         }
         vector_line.pop_back();
         vector_line += "\n\t\t\t},";
 
         vector_line += "\n\t\t\t\"Output_bits\": {\n\t\t\t\t";
-        for (const auto& bit : output_vector) {
-            vector_line += "\"" + bit.first + "\": " + std::to_string(bit.second) + ",";
+        for (const auto& bit : output_order) {
+            vector_line += "\"" + bit.first + "\": " + std::to_string(vectors_test->getOutput(pattern, bit.second)) + ",";
         }
         vector_line.pop_back();
         vector_line += "\n\t\t\t}\n";
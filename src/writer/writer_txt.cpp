@@ -23,7 +23,7 @@
 
 #include "../../include/writer/writer_txt.hpp"
 
-WriterTXT::WriterTXT(std::string _filename, std::string _filetype) : Writer(_filename, _filetype) {};
+WriterTXT::WriterTXT(std::string _filename, std::string _filetype, Compression::Format _compression) : Writer(_filename, _filetype, _compression) {};
 
 void WriterTXT::formatFile(std::shared_ptr<Tree> tree) {
     addLineToFile("Generated by ATPGK v1.0\n");
@@ -47,37 +47,37 @@ void WriterTXT::writeIOPort(std::shared_ptr<Tree> tree) {
     }
 };
 
-void WriterTXT::writeVectors(std::shared_ptr<std::vector<std::pair<std::vector<std::pair<std::shared_ptr<Node>, int>> , std::vector<std::pair<std::shared_ptr<Node>, int>>>>> vectors_test) {
+void WriterTXT::writeVectors(std::shared_ptr<Tree> tree, std::shared_ptr<PatternSet> vectors_test) {
     int a = 0;
 
     addLineToFile("\n\n------------- Generated vectors -------------\n");
 
-    for (const auto& pair : *vectors_test) {
+    // The bits are written sorted by name
+    std::map<std::string, size_t> input_order;
+    std::map<std::string, size_t> output_order;
+    for (size_t input = 0; input < tree->InputList.size(); ++input) {
+        input_order[tree->InputList[input]->getName()] = input;
+    }
+    for (size_t output = 0; output < tree->OutputList.size(); ++output) {
+        output_order[tree->OutputList[output]->getName()] = output;
+    }
+
+    for (size_t pattern = 0; pattern < vectors_test->getPatternCount(); ++pattern) {
         a++;
-        std::map<std::string, int> input_vector;
-        std::map<std::string, int> output_vector;
         std::string vector_line = "Vector nb." + std::to_string(a);
         vector_line += "\n\t";
 
-        for (const auto& input_bit : pair.first) {
-            input_vector[input_bit.first->getName()] = input_bit.second;
-        }
-
-        for (const auto& output_bit : pair.second) {
-            output_vector[output_bit.first->getName()] = output_bit.second;
-        }
-
-        for (const auto& bit : input_vector) {
+        for (const auto& bit : input_order) {
             vector_line += bit.first;
             vector_line += " : ";
-            vector_line += std::to_string(bit.second);
+            vector_line += std::to_string(vectors_test->getInput(pattern, bit.second));
             vector_line += " ; ";
         }
 
-        for (const auto& bit : output_vector) {
+        for (const auto& bit : output_order) {
             vector_line += bit.first;
             vector_line += " : ";
-            vector_line += std::to_string(bit.second);
+            vector_line += std::to_string(vectors_test->getOutput(pattern, bit.second));
             vector_line += " ; ";
         }
 
@@ -0,0 +1,210 @@
+#include <vector>
+#include <memory>
+#include <random>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/compaction/static_compactor.hpp"
+#include "../include/compaction/x_fill.hpp"
+
+// Append a cube to a pattern set
+static void addCube(PatternSet& patterns, const std::vector<int>& values) {
+    const size_t pattern = patterns.addPattern();
+    for (size_t input = 0; input < values.size(); ++input) {
+        patterns.setInput(pattern, input, values[input]);
+    }
+}
+
+// Test fixture for the merge of compatible cubes
+TEST(Compaction, MergeTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(c17Netlist);
+
+    StaticCompactor compactor(circuit, KernelType::Generic);
+    PatternSet patterns(circuit->inputs.size(), circuit->outputs.size());
+    addCube(patterns, {1, 0, -1, -1, -1});
+    addCube(patterns, {-1, -1, 1, -1, -1});
+    addCube(patterns, {0, -1, -1, -1, 1});
+    addCube(patterns, {-1, 1, -1, 0, -1});
+
+    // 0 X X X 1 and X 1 X 0 X are compatible, X X 1 X X then goes into the last merged cube
+    ASSERT_EQ(compactor.merge(patterns), 2);
+    ASSERT_EQ(patterns.getPatternCount(), 2);
+    std::vector<std::vector<int>> cubes;
+    for (size_t cube = 0; cube < patterns.getPatternCount(); ++cube) {
+        std::vector<int> values;
+        for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+            values.push_back(patterns.getInput(cube, input));
+        }
+        cubes.push_back(values);
+    }
+    std::sort(cubes.begin(), cubes.end());
+    ASSERT_EQ(cubes[0], std::vector<int>({0, 1, 1, 0, 1}));
+    ASSERT_EQ(cubes[1], std::vector<int>({1, 0, -1, -1, -1}));
+
+    // A window of a single merged cube misses the compatible cubes which are not the last one
+    PatternSet windowed(circuit->inputs.size(), circuit->outputs.size());
+    addCube(windowed, {1, 1, -1, -1, -1});
+    addCube(windowed, {0, 0, -1, -1, -1});
+    addCube(windowed, {1, -1, -1, -1, -1});
+    ASSERT_EQ(compactor.merge(windowed, 1), 3);
+}
+
+// Test fixture for the compaction, which must keep the coverage of the cubes
+TEST(Compaction, CoverageTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(c17Netlist);
+
+    std::vector<StuckAtFault> faults;
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        faults.push_back({gate, false});
+        faults.push_back({gate, true});
+    }
+
+    // All the patterns of the circuit, with a few random inputs left unspecified
+    std::mt19937 generator(1);
+    StaticCompactor compactor(circuit, KernelType::Generic);
+    PatternSet patterns(circuit->inputs.size(), circuit->outputs.size());
+    for (int pattern = 0; pattern < 32; ++pattern) {
+        for (int copy = 0; copy < 4; ++copy) {
+            std::vector<int> values;
+            for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+                values.push_back(generator() % 3 == 0 ? -1 : (pattern >> input) & 1);
+            }
+            addCube(patterns, values);
+        }
+    }
+
+    std::vector<long> original_detection(faults.size(), -1);
+    const size_t detected = compactor.detect(patterns, faults, original_detection);
+    ASSERT_GT(detected, 0);
+
+    const size_t cube_count = compactor.compact(patterns, faults);
+    ASSERT_EQ(cube_count, patterns.getPatternCount());
+    ASSERT_LT(cube_count, 128);
+
+    std::vector<long> compacted_detection(faults.size(), -1);
+    ASSERT_EQ(compactor.detect(patterns, faults, compacted_detection), detected);
+    for (size_t fault = 0; fault < faults.size(); ++fault) {
+        ASSERT_EQ(original_detection[fault] >= 0, compacted_detection[fault] >= 0);
+    }
+
+    // The detections of the cubes hold whatever the values of their unspecified inputs
+    ThreeValuedSimulator simulator(circuit, KernelType::Generic);
+    for (size_t fault = 0; fault < faults.size(); ++fault) {
+        if (compacted_detection[fault] < 0) continue;
+        std::vector<int> cube;
+        for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+            cube.push_back(patterns.getInput(compacted_detection[fault], input));
+        }
+        std::vector<bool> cube_detected;
+        simulator.detect(cube, {faults[fault]}, cube_detected);
+        ASSERT_TRUE(cube_detected[0]) << "fault " << fault;
+    }
+
+    // A cube whose inputs are all unspecified detects no fault, unlike its 0-fill
+    PatternSet unspecified(circuit->inputs.size(), circuit->outputs.size());
+    addCube(unspecified, std::vector<int>(circuit->inputs.size(), -1));
+    std::vector<long> unspecified_detection(faults.size(), -1);
+    ASSERT_EQ(compactor.detect(unspecified, faults, unspecified_detection), 0);
+    PatternSet filled(circuit->inputs.size(), circuit->outputs.size());
+    addCube(filled, std::vector<int>(circuit->inputs.size(), 0));
+    std::vector<long> filled_detection(faults.size(), -1);
+    ASSERT_GT(compactor.detect(filled, faults, filled_detection), 0);
+}
+
+// Test fixture for the reverse order reduction, which must keep the coverage of the cubes
+TEST(Compaction, ReverseOrderTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(c17Netlist);
+
+    std::vector<StuckAtFault> faults;
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        faults.push_back({gate, false});
+        faults.push_back({gate, true});
+    }
+
+    // All the patterns of the circuit, twice: at most one copy of each pattern can be kept
+    StaticCompactor compactor(circuit, KernelType::Generic);
+    PatternSet patterns(circuit->inputs.size(), circuit->outputs.size());
+    for (int pattern = 0; pattern < 64; ++pattern) {
+        std::vector<int> values;
+        for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+            values.push_back((pattern >> input) & 1);
+        }
+        addCube(patterns, values);
+    }
+
+    std::vector<long> original_detection(faults.size(), -1);
+    const size_t detected = compactor.detect(patterns, faults, original_detection);
+
+    const size_t cube_count = compactor.reduce(patterns, faults);
+    ASSERT_EQ(cube_count, patterns.getPatternCount());
+    ASSERT_LE(cube_count, 32);
+    ASSERT_GT(cube_count, 0);
+
+    std::vector<long> reduced_detection(faults.size(), -1);
+    ASSERT_EQ(compactor.detect(patterns, faults, reduced_detection), detected);
+
+    // In reverse order, each kept cube detects a new fault
+    ASSERT_EQ(compactor.reduce(patterns, faults), cube_count);
+}
+
+// Test fixture for the X-fill modes, which keep the specified inputs
+TEST(Compaction, FillTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(c17Netlist);
+
+    std::vector<StuckAtFault> faults;
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        faults.push_back({gate, false});
+        faults.push_back({gate, true});
+    }
+
+    PatternSet cubes(circuit->inputs.size(), circuit->outputs.size());
+    addCube(cubes, {1, -1, -1, 0, -1});
+    addCube(cubes, {-1, -1, -1, -1, -1});
+    addCube(cubes, {-1, 0, 1, -1, -1});
+
+    XFill filler(circuit, KernelType::Generic);
+    std::vector<std::pair<FillMode, FillScore>> scores;
+    for (FillMode mode : {FillMode::Zero, FillMode::One, FillMode::Random, FillMode::Adjacent}) {
+        PatternSet filled = cubes;
+        filler.fill(filled, mode);
+        for (size_t pattern = 0; pattern < cubes.getPatternCount(); ++pattern) {
+            for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+                ASSERT_NE(filled.getInput(pattern, input), -1);
+                if (cubes.getInput(pattern, input) >= 0) {
+                    ASSERT_EQ(filled.getInput(pattern, input), cubes.getInput(pattern, input));
+                }
+            }
+        }
+        scores.push_back({mode, filler.score(filled, faults)});
+    }
+
+    // The adjacent fill gives 1 1 1 0 0, 0 0 0 0 0 and 0 0 1 1 1
+    PatternSet adjacent = cubes;
+    filler.fill(adjacent, FillMode::Adjacent);
+    ASSERT_EQ(adjacent.getInput(0, 2), 1);
+    ASSERT_EQ(adjacent.getInput(0, 4), 0);
+    ASSERT_EQ(adjacent.getInput(1, 3), 0);
+    ASSERT_EQ(adjacent.getInput(2, 0), 0);
+    ASSERT_EQ(adjacent.getInput(2, 4), 1);
+    ASSERT_EQ(XFill::countToggles(adjacent), 2);
+    for (const auto& score : scores) {
+        ASSERT_GE(score.second.toggles, XFill::countToggles(adjacent));
+    }
+
+    // The best fill detects the most faults
+    PatternSet best = cubes;
+    const FillMode best_mode = filler.fillBest(best, faults);
+    const FillScore best_score = filler.score(best, faults);
+    for (const auto& score : scores) {
+        ASSERT_GE(best_score.detected, score.second.detected);
+        if (score.first == best_mode) {
+            ASSERT_EQ(best_score.detected, score.second.detected);
+        }
+    }
+}
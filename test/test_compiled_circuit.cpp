@@ -0,0 +1,134 @@
+#include <vector>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/tree/CompiledCircuit.hpp"
+
+// Test fixture for the gate ordering and the connections of the compiled circuit
+TEST(CompiledCircuit, CompilationTest) {
+
+    std::shared_ptr<Tree> tree = buildTree(R"(
+    module comb (input a, b, s, output y);
+      wire w;
+      and g1 (w, a, b);
+      \$_MUX_ m (.A(w), .B(a), .S(s), .Y(y));
+    endmodule
+    )");
+
+    CompiledCircuit circuit(tree);
+
+    ASSERT_EQ(circuit.getGateCount(), 6);
+    ASSERT_EQ(circuit.inputs.size(), 3);
+    ASSERT_EQ(circuit.outputs.size(), 1);
+    // Levels 0 (inputs), 1 (and), 2 (mux) and 3 (output)
+    ASSERT_EQ(circuit.levelOffsets.size(), 5);
+
+    for (uint32_t gate = 0; gate < circuit.getGateCount(); ++gate) {
+        for (uint32_t fanin = circuit.faninOffsets[gate]; fanin < circuit.faninOffsets[gate + 1]; ++fanin) {
+            ASSERT_LT(circuit.fanins[fanin], gate);
+        }
+    }
+
+    // The inputs of the mux are sorted by port: A, B, S
+    const uint32_t mux = circuit.fanins[circuit.faninOffsets[circuit.outputs[0]]];
+    ASSERT_EQ(circuit.kinds[mux], CellKind::Mux);
+    ASSERT_EQ(circuit.kinds[circuit.fanins[circuit.faninOffsets[mux]]], CellKind::And);
+    ASSERT_EQ(circuit.fanins[circuit.faninOffsets[mux] + 1], circuit.inputs[find(circuit, circuit.inputs, "a")]);
+    ASSERT_EQ(circuit.fanins[circuit.faninOffsets[mux] + 2], circuit.inputs[find(circuit, circuit.inputs, "s")]);
+}
+
+// Test fixture for the output reach and input cone bitsets
+TEST(CompiledCircuit, ConeTest) {
+
+    std::shared_ptr<Tree> tree = buildTree(R"(
+    module comb (input a, b, c, output y, z);
+      wire w1, w2;
+      and g1 (y, a, b);
+      not g2 (z, b);
+      not g3 (w1, c);
+      and g4 (w2, w1, a);
+    endmodule
+    )");
+
+    CompiledCircuit circuit(tree);
+
+    const uint32_t a = find(circuit, circuit.inputs, "a");
+    const uint32_t b = find(circuit, circuit.inputs, "b");
+    const uint32_t c = find(circuit, circuit.inputs, "c");
+    const uint32_t y = find(circuit, circuit.outputs, "y");
+    const uint32_t z = find(circuit, circuit.outputs, "z");
+    const uint32_t g3 = circuit.fanouts[circuit.fanoutOffsets[circuit.inputs[c]]];
+
+    ASSERT_TRUE(circuit.isObservable(circuit.inputs[a]));
+    ASSERT_FALSE(circuit.isObservable(circuit.inputs[c]));
+    ASSERT_FALSE(circuit.isObservable(g3));
+
+    ASSERT_TRUE(circuit.reachesOutput(circuit.inputs[a], y));
+    ASSERT_FALSE(circuit.reachesOutput(circuit.inputs[a], z));
+
+    ASSERT_TRUE(circuit.isInCone(a, y));
+    ASSERT_TRUE(circuit.isInCone(b, y));
+    ASSERT_TRUE(circuit.isInCone(b, z));
+    ASSERT_FALSE(circuit.isInCone(a, z));
+    ASSERT_FALSE(circuit.isInCone(c, y));
+    ASSERT_FALSE(circuit.isInCone(c, z));
+}
+
+// Test fixture for the controlling values of the inputs of the cells
+TEST(CompiledCircuit, ControllingValueTest) {
+    ASSERT_EQ(getControllingValue(CellKind::And, 0), 0);
+    ASSERT_EQ(getControllingValue(CellKind::Nor, 1), 1);
+    ASSERT_EQ(getControllingValue(CellKind::Andnot, 1), 1);
+    ASSERT_EQ(getControllingValue(CellKind::Ornot, 1), 0);
+    ASSERT_EQ(getControllingValue(CellKind::Aoi3, 2), 1);
+    ASSERT_EQ(getControllingValue(CellKind::Aoi3, 0), -1);
+    ASSERT_EQ(getControllingValue(CellKind::Xor, 0), -1);
+    ASSERT_EQ(getControllingValue(CellKind::Mux, 2), -1);
+    ASSERT_EQ(getControllingValue(CellKind::Not, 0), -1);
+}
+
+// Test fixture for the fault propagation dominators and the values of their side inputs
+TEST(CompiledCircuit, DominatorTest) {
+
+    std::shared_ptr<Tree> tree = buildTree(R"(
+    module comb (input a, b, c, d, output y, z);
+      wire w1, w2, w3;
+      or g1 (w1, a, b);
+      and g2 (w2, a, c);
+      nand g3 (w3, w1, w2);
+      and g4 (y, w3, d);
+      not g5 (z, d);
+    endmodule
+    )");
+
+    CompiledCircuit circuit(tree);
+
+    const uint32_t a = getGate(circuit, "a");
+    const uint32_t b = getGate(circuit, "b");
+    const uint32_t d = getGate(circuit, "d");
+    const uint32_t g1 = getGate(circuit, "g1");
+    const uint32_t g2 = getGate(circuit, "g2");
+    const uint32_t g3 = getGate(circuit, "g3");
+    const uint32_t g4 = getGate(circuit, "g4");
+    const uint32_t y = getGate(circuit, "y");
+
+    // The two paths from a reconverge at g3
+    ASSERT_EQ(circuit.getDominator(a), g3);
+    ASSERT_EQ(circuit.getDominator(b), g1);
+    ASSERT_EQ(circuit.getDominator(g1), g3);
+    ASSERT_EQ(circuit.getDominator(g3), g4);
+    ASSERT_EQ(circuit.getDominator(g4), y);
+    ASSERT_EQ(circuit.getDominator(y), CompiledCircuit::NoDominator);
+    // The paths from d only meet at the primary outputs
+    ASSERT_EQ(circuit.getDominator(d), CompiledCircuit::NoDominator);
+
+    std::vector<std::pair<uint32_t, bool>> values;
+    circuit.getSideInputValues(a, values);
+    ASSERT_EQ(values, (std::vector<std::pair<uint32_t, bool>>{{d, true}}));
+    circuit.getSideInputValues(b, values);
+    ASSERT_EQ(values, (std::vector<std::pair<uint32_t, bool>>{{a, false}, {g2, true}, {d, true}}));
+    circuit.getSideInputValues(d, values);
+    ASSERT_TRUE(values.empty());
+}
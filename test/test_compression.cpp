@@ -0,0 +1,109 @@
+#include <vector>
+#include <memory>
+#include <string>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include <boost/iostreams/device/file.hpp>
+
+#include "test_utils.hpp"
+#include "../include/reader/reader.hpp"
+#include "../include/reader/pattern_reader.hpp"
+#include "../include/writer/writer_txt.hpp"
+
+// Messages of the Reader, defined by the main executable from the language file
+json strings;
+
+// Messages printed by the Reader
+static void setStrings() {
+    for (const std::string key : {"parsing", "parsing_success", "tree_building", "tree_building_success"}) {
+        strings["global"][key] = "";
+    }
+}
+
+// Write a string to a file, compressed in the format given by its suffix
+static void writeFile(const std::string& filename, const std::string& content) {
+    boost::iostreams::filtering_ostream stream;
+    Compression::pushCompressor(stream, Compression::getFormat(filename));
+    stream.push(boost::iostreams::file_sink(filename, std::ios::binary));
+    stream << content;
+}
+
+// Test fixture for the netlists and the vector files read and written through gzip and bzip2
+TEST(Compression, RoundTripTest) {
+
+    setStrings();
+    std::shared_ptr<Tree> expected = buildTree(c17Netlist);
+    std::shared_ptr<const CompiledCircuit> circuit = std::make_shared<const CompiledCircuit>(expected);
+
+    // 0-1 vectors, the input i of the pattern p being the bit i of p
+    std::shared_ptr<PatternSet> vectors = std::make_shared<PatternSet>(circuit->inputs.size(), circuit->outputs.size());
+    for (size_t pattern = 0; pattern < 32; ++pattern) {
+        vectors->addPattern();
+        for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+            vectors->setInput(pattern, input, (pattern >> input) & 1);
+        }
+    }
+
+    for (Compression::Format format : {Compression::Format::Gzip, Compression::Format::Bzip2}) {
+        const std::string suffix = Compression::getSuffix(format);
+
+        // The netlist is decompressed before it is parsed
+        const std::string netlist = testing::TempDir() + "c17.v" + suffix;
+        writeFile(netlist, c17Netlist);
+        std::ifstream file(netlist, std::ios::binary);
+        ASSERT_EQ(std::string(std::istreambuf_iterator<char>(file), {}).find("module c17"), std::string::npos);
+
+        std::shared_ptr<Tree> tree = std::make_shared<Tree>("tree");
+        Reader reader(netlist, "v");
+        reader.read(netlist, "v", tree);
+        ASSERT_EQ(tree->InputList.size(), expected->InputList.size());
+        ASSERT_EQ(tree->OutputList.size(), expected->OutputList.size());
+        ASSERT_EQ(tree->LevelList.size(), expected->LevelList.size());
+        ASSERT_EQ(tree->OrderedNodeList.size(), expected->OrderedNodeList.size());
+
+        // The vectors written compressed are read back, their format found without the compression suffix
+        const std::string name = testing::TempDir() + "vectors";
+        {
+            WriterTXT writer(name, "txt", format);
+            writer.writeIOPort(expected);
+            writer.writeVectors(expected, vectors);
+        }
+        PatternReader patterns(circuit);
+        patterns.read(name + ".txt" + suffix);
+        ASSERT_EQ(patterns.getPatternCount(), vectors->getPatternCount());
+        for (size_t pattern = 0; pattern < vectors->getPatternCount(); ++pattern) {
+            for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+                ASSERT_EQ(patterns.getValue(pattern, input), vectors->getInput(pattern, input) == 1);
+            }
+        }
+    }
+}
+
+// Test fixture for the error on the files whose content doesn't match their compression suffix
+TEST(Compression, CorruptedTest) {
+
+    setStrings();
+    std::shared_ptr<const CompiledCircuit> circuit = compile(c17Netlist);
+
+    for (const std::string suffix : {".gz", ".bz2"}) {
+        const std::string filename = testing::TempDir() + "corrupted" + suffix;
+        std::ofstream(filename, std::ios::binary) << c17Netlist;
+
+        std::shared_ptr<Tree> tree = std::make_shared<Tree>("tree");
+        Reader reader(filename, "v");
+        ASSERT_EXIT(
+            reader.read(filename, "v", tree),
+            testing::ExitedWithCode(1),
+            "can't be decompressed"
+        );
+
+        PatternReader patterns(circuit);
+        ASSERT_EXIT(
+            patterns.read(filename),
+            testing::ExitedWithCode(1),
+            "can't be decompressed"
+        );
+    }
+}
@@ -0,0 +1,72 @@
+#include <vector>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/fault_API/fault_API.hpp"
+#include "../include/tree/FaultDecorator.hpp"
+
+// Test fixture for the dynamic compaction, which must give fewer vectors detecting as many faults
+TEST(FaultAPI, DynamicCompactionTest) {
+
+    // Vectors generated with a compaction limit, and the number of faults they detect
+    auto run = [](size_t compaction_limit, size_t& detected) {
+        std::shared_ptr<Tree> tree = buildTree(c17Netlist);
+        std::shared_ptr<CompiledCircuit> circuit = std::make_shared<CompiledCircuit>(tree);
+        auto fault_list = std::make_shared<std::vector<std::pair<std::shared_ptr<Fault>, std::shared_ptr<Node>>>>();
+        FaultDecorator decorator;
+        tree->traverse(decorator, fault_list);
+
+        auto vectors = FaultAPI::generateVectorError(fault_list, tree, circuit, compaction_limit);
+
+        FaultSimulator simulator(circuit, KernelType::Generic);
+        std::vector<StuckAtFault> faults = FaultSimulator::getStuckAtFaults(*circuit, *fault_list);
+        std::vector<long> first_detection(faults.size(), -1);
+        std::vector<uint64_t> patterns(circuit->inputs.size(), 0);
+        for (size_t vector = 0; vector < vectors.size(); ++vector) {
+            for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+                patterns[input] |= uint64_t(vectors[vector].first[input].second == 1) << vector;
+            }
+        }
+        detected = simulator.simulateBlock(patterns.data(), vectors.size(), faults, first_detection, 0);
+        return vectors.size();
+    };
+
+    size_t detected, compacted_detected;
+    const size_t vector_count = run(0, detected);
+    const size_t compacted_count = run(64, compacted_detected);
+    ASSERT_GT(vector_count, 0);
+    ASSERT_LT(compacted_count, vector_count);
+    ASSERT_GE(compacted_detected, detected);
+}
+
+// Test fixture for the effort limit, the aborted faults being tested once targeted again without limit
+TEST(FaultAPI, EffortLimitTest) {
+
+    std::shared_ptr<Tree> tree = buildTree(c17Netlist);
+    std::shared_ptr<CompiledCircuit> circuit = std::make_shared<CompiledCircuit>(tree);
+    auto fault_list = std::make_shared<std::vector<std::pair<std::shared_ptr<Fault>, std::shared_ptr<Node>>>>();
+    FaultDecorator decorator;
+    tree->traverse(decorator, fault_list);
+
+    FaultAPI::EffortLimit limit;
+    limit.decisions = 1;
+    FaultAPI::generateVectorError(fault_list, tree, circuit, 0, nullptr, &limit);
+
+    auto aborted_faults = std::make_shared<std::vector<std::pair<std::shared_ptr<Fault>, std::shared_ptr<Node>>>>();
+    for (const auto& fault : *fault_list) {
+        if (fault.first->getFailure() && fault.first->getFailureReason() == "ab") {
+            fault.first->clearFailure();
+            aborted_faults->push_back(fault);
+        }
+    }
+    ASSERT_FALSE(aborted_faults->empty());
+
+    auto vectors = FaultAPI::generateVectorError(aborted_faults, tree, circuit);
+    ASSERT_FALSE(vectors.empty());
+    for (const auto& fault : *aborted_faults) {
+        ASSERT_NE(fault.first->getFailureReason(), "ab");
+    }
+}
@@ -0,0 +1,166 @@
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/tree/ImplicationEngine.hpp"
+#include "../include/tree/LearnedImplications.hpp"
+#include "../include/tree/RecursiveLearning.hpp"
+
+// a reaches h through two reconvergent paths: a = 1 implies h = 1, so h = 0 implies a = 0
+static const std::string reconvergentNetlist = R"(
+module reconvergent (input a, b, c, output y);
+  wire f1, f2;
+  or g1 (f1, a, b);
+  or g2 (f2, a, c);
+  and g3 (y, f1, f2);
+endmodule
+)";
+
+// Test fixture for the direct implications and the backtrack
+TEST(Implication, DirectTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(reconvergentNetlist);
+    const uint32_t a = getGate(*circuit, "a");
+    const uint32_t b = getGate(*circuit, "b");
+    const uint32_t g1 = getGate(*circuit, "g1");
+    const uint32_t g3 = getGate(*circuit, "g3");
+
+    ImplicationEngine engine(circuit);
+
+    // Backward: an AND at 1 has both inputs at 1, forward: an OR with an input at 1 is 1
+    ASSERT_TRUE(engine.assign(g3, true));
+    ASSERT_EQ(engine.getValue(g1), 1);
+    ASSERT_EQ(engine.getValue(a), -1);
+    ASSERT_FALSE(engine.isJustified(g1));
+    const size_t mark = engine.getTrail().size();
+    ASSERT_TRUE(engine.assign(b, false));
+    ASSERT_EQ(engine.getValue(a), 1);
+    ASSERT_TRUE(engine.isJustified(g1));
+
+    engine.backtrack(mark);
+    ASSERT_EQ(engine.getValue(a), -1);
+    ASSERT_EQ(engine.getValue(b), -1);
+    ASSERT_EQ(engine.getValue(g1), 1);
+
+    // An OR at 1 with both inputs at 0 is a conflict
+    engine.backtrack(0);
+    ASSERT_TRUE(engine.assign(a, false));
+    ASSERT_TRUE(engine.assign(b, false));
+    ASSERT_FALSE(engine.assign(g1, true));
+
+    ASSERT_TRUE(ImplicationEngine::forcesInput(CellKind::And, true));
+    ASSERT_FALSE(ImplicationEngine::forcesInput(CellKind::And, false));
+    ASSERT_FALSE(ImplicationEngine::forcesInput(CellKind::Xor, true));
+}
+
+// Test fixture for the static learning of an indirect implication
+TEST(Implication, LearningTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(reconvergentNetlist);
+    const uint32_t a = getGate(*circuit, "a");
+    const uint32_t g3 = getGate(*circuit, "g3");
+
+    LearnedImplications learned(circuit);
+    std::vector<uint32_t> implied(learned.begin(g3, false), learned.end(g3, false));
+    ASSERT_NE(std::find(implied.begin(), implied.end(), 2 * a), implied.end());
+
+    // The direct implications alone can't justify the 0 of the AND
+    ImplicationEngine direct(circuit);
+    ASSERT_TRUE(direct.assign(g3, false));
+    ASSERT_EQ(direct.getValue(a), -1);
+
+    ImplicationEngine engine(circuit, &learned);
+    ASSERT_TRUE(engine.assign(g3, false));
+    ASSERT_EQ(engine.getValue(a), 0);
+}
+
+// Test fixture for the static learning run once per module and copied to its instances
+TEST(Implication, ModuleLearningTest) {
+
+    // In each instance, y = 0 implies n = 0 through the two reconvergent paths
+    json strings;
+    VerilogParser parser(strings);
+    parser.setInputFileContent(R"(
+    module sub (input a, b, c, output y);
+      wire n, f1, f2;
+      not g0 (n, a);
+      or g1 (f1, n, b);
+      or g2 (f2, n, c);
+      and g3 (y, f1, f2);
+    endmodule
+    module top (input a, b, c, d, output z);
+      wire y1, y2;
+      sub u1 (.a(a), .b(b), .c(c), .y(y1));
+      sub u2 (.a(b), .b(c), .c(d), .y(y2));
+      or g4 (z, y1, y2);
+    endmodule
+    )");
+    ParsedCircuit netlist = parser.parseCircuit();
+
+    std::shared_ptr<Tree> tree = buildTree(netlist);
+    tree->ModuleTrees.insert({"sub", buildTree(parser.elaborateModule(netlist, "sub"))});
+    tree->InstanceList = {{"u1", "sub"}, {"u2", "sub"}};
+    std::shared_ptr<const CompiledCircuit> circuit = std::make_shared<const CompiledCircuit>(tree);
+
+    LearnedImplications learned(circuit, *tree);
+    for (const std::string instance : {"u1", "u2"}) {
+        const uint32_t g0 = getGate(*circuit, instance + ".g0");
+        const uint32_t g3 = getGate(*circuit, instance + ".g3");
+        std::vector<uint32_t> implied(learned.begin(g3, false), learned.end(g3, false));
+        ASSERT_NE(std::find(implied.begin(), implied.end(), 2 * g0), implied.end());
+    }
+
+    // The gates outside the instances are learned on the whole circuit
+    LearnedImplications flat(circuit);
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        if (circuit->nodes[gate]->netlistName.find('.') != std::string::npos) continue;
+        for (bool value : {false, true}) {
+            ASSERT_EQ(std::vector<uint32_t>(learned.begin(gate, value), learned.end(gate, value)), std::vector<uint32_t>(flat.begin(gate, value), flat.end(gate, value)));
+        }
+    }
+
+    // Every implication holds on every input vector
+    for (uint32_t vector = 0; vector < 16; ++vector) {
+        ImplicationEngine engine(circuit);
+        for (uint32_t input = 0; input < circuit->inputs.size(); ++input) {
+            ASSERT_TRUE(engine.assign(circuit->inputs[input], (vector >> input) & 1));
+        }
+        for (uint32_t literal = 0; literal < 2 * circuit->getGateCount(); ++literal) {
+            if (engine.getValue(literal / 2) != static_cast<int>(literal % 2)) continue;
+            for (auto it = learned.begin(literal / 2, literal % 2); it != learned.end(literal / 2, literal % 2); ++it) {
+                ASSERT_EQ(engine.getValue(*it / 2), static_cast<int>(*it % 2));
+            }
+        }
+    }
+}
+
+// Test fixture for the necessary values and the conflicts found by recursive learning
+TEST(Implication, RecursiveLearningTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(reconvergentNetlist);
+    const uint32_t a = getGate(*circuit, "a");
+
+    // Both justifications of the 0 of the AND need a = 0
+    RecursiveLearning learning(circuit, 1);
+    ASSERT_TRUE(learning.getEngine().assign(getGate(*circuit, "g3"), false));
+    ASSERT_EQ(learning.getEngine().getValue(a), -1);
+    ASSERT_TRUE(learning.learn());
+    ASSERT_EQ(learning.getEngine().getValue(a), 0);
+
+    // p and q can't be both 1, which the direct implications don't see
+    std::shared_ptr<const CompiledCircuit> xor_circuit = compile(R"(
+    module exclusive (input a, b, output y);
+      wire p, q;
+      xor g1 (p, a, b);
+      xnor g2 (q, a, b);
+      and g3 (y, p, q);
+    endmodule
+    )");
+    RecursiveLearning xor_learning(xor_circuit, 2);
+    ASSERT_TRUE(xor_learning.getEngine().assign(getGate(*xor_circuit, "g3"), true));
+    ASSERT_FALSE(xor_learning.learn());
+}
@@ -0,0 +1,99 @@
+#include <vector>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/reader/pattern_reader.hpp"
+
+static const std::string netlist = R"(
+module m (input a, b, c, output y);
+  and g1 (y, a, b, c);
+endmodule
+)";
+
+// Value of each input of each pattern, in the order of the inputs of the circuit
+static std::vector<std::vector<bool>> getValues(const PatternReader& reader, size_t input_count) {
+    std::vector<std::vector<bool>> values(reader.getPatternCount(), std::vector<bool>(input_count));
+    for (size_t pattern = 0; pattern < reader.getPatternCount(); ++pattern) {
+        for (size_t input = 0; input < input_count; ++input) {
+            values[pattern][input] = reader.getValue(pattern, input);
+        }
+    }
+    return values;
+}
+
+// Test fixture for the formats written by WriterTXT and WriterJSON, and the bit matrix
+TEST(PatternReader, FormatTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(netlist);
+    ASSERT_EQ(circuit->inputs.size(), 3);
+    std::vector<std::string> names;
+    for (uint32_t input : circuit->inputs) names.push_back(circuit->nodes[input]->getName());
+
+    std::string text = "Generated by ATPGK v1.0\n\nInput list :\n\tName : a ; Id : 2\n\n------------- Generated vectors -------------\n\n";
+    text += "Vector nb.1\n\t" + names[0] + " : 1 ; " + names[1] + " : 0 ; " + names[2] + " : -1 ; y : 0 ; \n\n";
+    text += "Vector nb.2\n\t" + names[0] + " : 0 ; " + names[1] + " : 1 ; " + names[2] + " : 1 ; y : 0 ; \n\n";
+
+    std::string json = "{\n\t\"Vectors\": {";
+    json += "\n\t\t\"1\": {\"Input_bits\": {\"" + names[0] + "\": 1,\"" + names[1] + "\": 0,\"" + names[2] + "\": -1}, \"Output_bits\": {\"y\": 0}},";
+    json += "\n\t\t\"2\": {\"Input_bits\": {\"" + names[0] + "\": 0,\"" + names[1] + "\": 1,\"" + names[2] + "\": 1}, \"Output_bits\": {\"y\": 0}}\n\t}\n}";
+
+    std::string matrix = "# a b c\n1 0 X\n\n011\n";
+
+    ASSERT_EQ(PatternReader::getFormat("vectors.txt", text), PatternReader::Format::Text);
+    ASSERT_EQ(PatternReader::getFormat("vectors.json", json), PatternReader::Format::JSON);
+    ASSERT_EQ(PatternReader::getFormat("vectors.txt", matrix), PatternReader::Format::BitMatrix);
+
+    // The unassigned inputs are set to 0
+    std::vector<std::vector<bool>> expected = {{true, false, false}, {false, true, true}};
+    for (const auto& file : {std::make_pair(text, PatternReader::Format::Text), std::make_pair(json, PatternReader::Format::JSON), std::make_pair(matrix, PatternReader::Format::BitMatrix)}) {
+        PatternReader reader(circuit);
+        reader.parse(file.first, file.second);
+        ASSERT_EQ(getValues(reader, 3), expected);
+    }
+}
+
+// Test fixture for the blocks given to the simulators, one word per input for 64 patterns
+TEST(PatternReader, BlockTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(netlist);
+
+    // 70 patterns, the input i being 1 for the patterns which are a multiple of i + 1
+    std::string matrix;
+    for (size_t pattern = 0; pattern < 70; ++pattern) {
+        for (size_t input = 0; input < 3; ++input) matrix += pattern % (input + 1) == 0 ? '1' : '0';
+        matrix += '\n';
+    }
+    PatternReader reader(circuit);
+    reader.parse(matrix, PatternReader::Format::BitMatrix);
+    ASSERT_EQ(reader.getPatternCount(), 70);
+
+    std::vector<uint64_t> block(3 * 2, ~uint64_t(0));
+    reader.getBlock(64, 2, block.data());
+    for (size_t input = 0; input < 3; ++input) {
+        for (size_t bit = 0; bit < 128; ++bit) {
+            const bool value = (block[input * 2 + bit / 64] >> (bit % 64)) & 1;
+            ASSERT_EQ(value, bit < 6 && (64 + bit) % (input + 1) == 0);
+        }
+    }
+}
+
+// Test fixture for a vector which doesn't match the inputs of the circuit
+TEST(PatternReader, MismatchErrorTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(netlist);
+
+    PatternReader reader(circuit);
+    ASSERT_EXIT(
+        reader.parse("0101\n", PatternReader::Format::BitMatrix),
+        testing::ExitedWithCode(1),
+        ""
+    );
+    ASSERT_EXIT(
+        reader.parse("Vector nb.1\n\tfoo : 1 ;\n", PatternReader::Format::Text),
+        testing::ExitedWithCode(1),
+        ""
+    );
+}
@@ -0,0 +1,76 @@
+#include <vector>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "../include/tree/PatternSet.hpp"
+
+// Test fixture for the values of the patterns, with more than 64 inputs
+TEST(PatternSet, ValueTest) {
+
+    PatternSet patterns(70, 3);
+    ASSERT_EQ(patterns.getInputWords(), 2);
+
+    const size_t pattern = patterns.addPattern();
+    ASSERT_EQ(patterns.getPatternCount(), 1);
+    ASSERT_EQ(patterns.getInput(pattern, 0), -1);
+    ASSERT_EQ(patterns.getOutput(pattern, 2), -1);
+
+    patterns.setInput(pattern, 0, 1);
+    patterns.setInput(pattern, 69, 0);
+    patterns.setOutput(pattern, 2, 1);
+    ASSERT_EQ(patterns.getInput(pattern, 0), 1);
+    ASSERT_EQ(patterns.getInput(pattern, 69), 0);
+    ASSERT_EQ(patterns.getInput(pattern, 68), -1);
+    ASSERT_EQ(patterns.getOutput(pattern, 2), 1);
+    ASSERT_EQ(patterns.getOnes(pattern)[0], 1);
+    ASSERT_EQ(patterns.getZeros(pattern)[1], uint64_t(1) << 5);
+
+    // A value set again replaces the previous one
+    patterns.setInput(pattern, 0, -1);
+    ASSERT_EQ(patterns.getInput(pattern, 0), -1);
+    patterns.setInput(pattern, 69, 1);
+    ASSERT_EQ(patterns.getInput(pattern, 69), 1);
+
+    const size_t copy = patterns.addPattern(patterns.getOnes(pattern), patterns.getZeros(pattern));
+    for (size_t input = 0; input < 70; ++input) {
+        ASSERT_EQ(patterns.getInput(copy, input), patterns.getInput(pattern, input));
+    }
+    ASSERT_EQ(patterns.getOutput(copy, 2), -1);
+
+    patterns.clear();
+    ASSERT_EQ(patterns.getPatternCount(), 0);
+}
+
+// Test fixture for the blocks given to the simulators, starting at any pattern
+TEST(PatternSet, BlockTest) {
+
+    std::mt19937 generator(1);
+    const size_t input_count = 5;
+    PatternSet patterns(input_count, 0);
+    for (size_t pattern = 0; pattern < 300; ++pattern) {
+        patterns.addPattern();
+        for (size_t input = 0; input < input_count; ++input) {
+            patterns.setInput(pattern, input, int(generator() % 3) - 1);
+        }
+    }
+
+    for (size_t first : {0, 1, 63, 64, 130, 299}) {
+        const size_t block_words = 4;
+        std::vector<uint64_t> values(input_count * block_words);
+        std::vector<uint64_t> ones(input_count * block_words);
+        std::vector<uint64_t> zeros(input_count * block_words);
+        patterns.getBlock(first, block_words, values.data());
+        patterns.getBlock(first, block_words, ones.data(), zeros.data());
+
+        for (size_t bit = 0; bit < 64 * block_words; ++bit) {
+            for (size_t input = 0; input < input_count; ++input) {
+                const size_t word = input * block_words + bit / 64;
+                const int value = first + bit < patterns.getPatternCount() ? patterns.getInput(first + bit, input) : -1;
+                ASSERT_EQ((values[word] >> (bit % 64)) & 1, value == 1);
+                ASSERT_EQ((ones[word] >> (bit % 64)) & 1, value == 1);
+                ASSERT_EQ((zeros[word] >> (bit % 64)) & 1, value == 0);
+            }
+        }
+    }
+}
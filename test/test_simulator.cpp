@@ -0,0 +1,583 @@
+#include <vector>
+#include <memory>
+#include <random>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/simulator/fault_simulator.hpp"
+#include "../include/simulator/three_valued_simulator.hpp"
+#include "../include/simulator/compiled_code.hpp"
+#include "../include/simulator/random_pattern_phase.hpp"
+
+// One instance of each supported cell, each one driving its own output
+static const std::string cellsNetlist = R"(
+module cells (input [19:0] x, output [20:0] y);
+  wire w1, w2;
+  \$_BUF_ c0 (.A(x[0]), .Y(y[0]));
+  \$_NOT_ c1 (.A(x[1]), .Y(y[1]));
+  \$_AND_ c2 (.A(x[0]), .B(x[1]), .Y(y[2]));
+  \$_NAND_ c3 (.A(x[0]), .B(x[1]), .Y(y[3]));
+  \$_ANDNOT_ c4 (.A(x[0]), .B(x[1]), .Y(y[4]));
+  \$_OR_ c5 (.A(x[0]), .B(x[1]), .Y(y[5]));
+  \$_NOR_ c6 (.A(x[0]), .B(x[1]), .Y(y[6]));
+  \$_ORNOT_ c7 (.A(x[0]), .B(x[1]), .Y(y[7]));
+  \$_XOR_ c8 (.A(x[0]), .B(x[1]), .Y(y[8]));
+  \$_XNOR_ c9 (.A(x[0]), .B(x[1]), .Y(y[9]));
+  \$_AOI3_ c10 (.A(x[0]), .B(x[1]), .C(x[2]), .Y(y[10]));
+  \$_OAI3_ c11 (.A(x[0]), .B(x[1]), .C(x[2]), .Y(y[11]));
+  \$_AOI4_ c12 (.A(x[0]), .B(x[1]), .C(x[2]), .D(x[3]), .Y(y[12]));
+  \$_OAI4_ c13 (.A(x[0]), .B(x[1]), .C(x[2]), .D(x[3]), .Y(y[13]));
+  \$_MUX_ c14 (.A(x[0]), .B(x[1]), .S(x[2]), .Y(y[14]));
+  \$_NMUX_ c15 (.A(x[0]), .B(x[1]), .S(x[2]), .Y(y[15]));
+  \$_MUX4_ c16 (.A(x[0]), .B(x[1]), .C(x[2]), .D(x[3]), .S(x[4]), .T(x[5]), .Y(y[16]));
+  \$_MUX8_ c17 (.A(x[0]), .B(x[1]), .C(x[2]), .D(x[3]), .E(x[4]), .F(x[5]), .G(x[6]), .H(x[7]), .S(x[8]), .T(x[9]), .U(x[10]), .Y(y[17]));
+  \$_MUX16_ c18 (.A(x[0]), .B(x[1]), .C(x[2]), .D(x[3]), .E(x[4]), .F(x[5]), .G(x[6]), .H(x[7]), .I(x[8]), .J(x[9]), .K(x[10]), .L(x[11]), .M(x[12]), .N(x[13]), .O(x[14]), .P(x[15]), .S(x[16]), .T(x[17]), .U(x[18]), .V(x[19]), .Y(y[18]));
+  \$_TBUF_ c19 (.A(x[0]), .EN(x[1]), .Y(y[19]));
+  \$_NOT_ c20 (.A(x[3]), .Y(w1));
+  \$_XOR_ c21 (.A(x[4]), .B(x[5]), .Y(w2));
+  \$_AND_ c22 (.A(w1), .B(w2), .Y(y[20]));
+endmodule
+)";
+
+// Expected value of each output of cellsNetlist
+static bool expected(size_t output, const std::vector<bool>& x) {
+    auto mux = [&x](size_t first, size_t select, size_t select_count) {
+        size_t index = 0;
+        for (size_t i = 0; i < select_count; ++i) index |= size_t(x[select + i]) << i;
+        return x[first + index];
+    };
+    switch (output) {
+        case 0: return x[0];
+        case 1: return !x[1];
+        case 2: return x[0] && x[1];
+        case 3: return !(x[0] && x[1]);
+        case 4: return x[0] && !x[1];
+        case 5: return x[0] || x[1];
+        case 6: return !(x[0] || x[1]);
+        case 7: return x[0] || !x[1];
+        case 8: return x[0] != x[1];
+        case 9: return x[0] == x[1];
+        case 10: return !((x[0] && x[1]) || x[2]);
+        case 11: return !((x[0] || x[1]) && x[2]);
+        case 12: return !((x[0] && x[1]) || (x[2] && x[3]));
+        case 13: return !((x[0] || x[1]) && (x[2] || x[3]));
+        case 14: return mux(0, 2, 1);
+        case 15: return !mux(0, 2, 1);
+        case 16: return mux(0, 4, 2);
+        case 17: return mux(0, 8, 3);
+        case 18: return mux(0, 16, 4);
+        case 19: return x[0];
+        default: return !x[3] && (x[4] != x[5]);
+    }
+}
+
+// Random patterns, words words per input
+static std::vector<uint64_t> randomPatterns(size_t input_count, size_t words) {
+    std::mt19937_64 generator(42);
+    std::vector<uint64_t> patterns(input_count * words);
+    for (uint64_t& word : patterns) word = generator();
+    return patterns;
+}
+
+// Test fixture for the function of each cell with the portable kernel
+TEST(Simulator, CellTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+    LogicSimulator simulator(circuit, KernelType::Generic);
+
+    ASSERT_EQ(simulator.getBlockSize(), 64);
+
+    std::vector<uint64_t> patterns = randomPatterns(circuit->inputs.size(), 1);
+    simulator.simulate(patterns.data());
+
+    for (size_t pattern = 0; pattern < 64; ++pattern) {
+        std::vector<bool> x(20);
+        for (size_t i = 0; i < 20; ++i) {
+            x[i] = (patterns[find(*circuit, circuit->inputs, "x[" + std::to_string(i) + "]")] >> pattern) & 1;
+        }
+        for (size_t output = 0; output <= 20; ++output) {
+            const uint32_t gate = circuit->outputs[find(*circuit, circuit->outputs, "y[" + std::to_string(output) + "]")];
+            ASSERT_EQ((*simulator.getValue(gate) >> pattern) & 1, expected(output, x)) << "output " << output << ", pattern " << pattern;
+        }
+    }
+}
+
+// Test fixture for the detection of a fault
+TEST(Simulator, FaultDetectionTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(R"(
+    module comb (input a, b, output y);
+      and g1 (y, a, b);
+    endmodule
+    )");
+    FaultSimulator simulator(circuit, KernelType::Generic);
+
+    // a stuck-at-0 and a stuck-at-1 are only detected by a = 1, b = 1 and a = 0, b = 1
+    std::vector<StuckAtFault> faults = {{circuit->inputs[find(*circuit, circuit->inputs, "a")], false}, {circuit->inputs[find(*circuit, circuit->inputs, "a")], true}};
+    std::vector<long> first_detection(faults.size(), -1);
+
+    // Patterns: (a, b) = (0, 0), (1, 0), (1, 1), (0, 1)
+    std::vector<uint64_t> patterns(2);
+    patterns[find(*circuit, circuit->inputs, "a")] = 0b0110;
+    patterns[find(*circuit, circuit->inputs, "b")] = 0b1100;
+
+    // The fourth pattern is out of the block
+    ASSERT_EQ(simulator.simulateBlock(patterns.data(), 3, faults, first_detection, 10), 1);
+    ASSERT_EQ(first_detection[0], 12);
+    ASSERT_EQ(first_detection[1], -1);
+
+    ASSERT_EQ(simulator.simulateBlock(patterns.data(), 4, faults, first_detection, 20), 1);
+    ASSERT_EQ(first_detection[0], 12);
+    ASSERT_EQ(first_detection[1], 23);
+}
+
+// Test fixture for the SIMD kernels, which must give the same results as the portable one
+TEST(Simulator, KernelTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+    const size_t pattern_count = 512;
+
+    std::vector<StuckAtFault> faults;
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        faults.push_back({gate, false});
+        faults.push_back({gate, true});
+    }
+
+    // Output values and first detections of all the patterns with a kernel
+    auto run = [&](KernelType type, std::vector<bool>& values, std::vector<long>& first_detection) {
+        FaultSimulator simulator(circuit, type);
+        const size_t words = simulator.getBlockWords();
+        std::vector<uint64_t> all_patterns = randomPatterns(circuit->inputs.size(), pattern_count / 64);
+        first_detection.assign(faults.size(), -1);
+        values.assign(circuit->outputs.size() * pattern_count, false);
+
+        for (size_t first = 0; first < pattern_count; first += simulator.getBlockSize()) {
+            std::vector<uint64_t> patterns(circuit->inputs.size() * words);
+            for (size_t i = 0; i < circuit->inputs.size(); ++i) {
+                for (size_t word = 0; word < words; ++word) {
+                    patterns[i * words + word] = all_patterns[i * (pattern_count / 64) + first / 64 + word];
+                }
+            }
+            simulator.simulateBlock(patterns.data(), simulator.getBlockSize(), faults, first_detection, first);
+            for (size_t output = 0; output < circuit->outputs.size(); ++output) {
+                const uint64_t* value = simulator.getLogicSimulator().getValue(circuit->outputs[output]);
+                for (size_t pattern = 0; pattern < simulator.getBlockSize(); ++pattern) {
+                    values[output * pattern_count + first + pattern] = (value[pattern / 64] >> (pattern % 64)) & 1;
+                }
+            }
+        }
+    };
+
+    std::vector<bool> generic_values;
+    std::vector<long> generic_detection;
+    run(KernelType::Generic, generic_values, generic_detection);
+
+    for (KernelType type : {KernelType::AVX2, KernelType::AVX512}) {
+        if (!SimulationKernel::isSupported(type)) continue;
+
+        std::vector<bool> values;
+        std::vector<long> first_detection;
+        run(type, values, first_detection);
+
+        ASSERT_EQ(values, generic_values);
+        ASSERT_EQ(first_detection, generic_detection);
+    }
+}
+
+// Test fixture for the three-valued simulation, which must be exact for each cell
+TEST(Simulator, ThreeValuedTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+    std::mt19937_64 generator(7);
+
+    // Random cubes, each input being X with a probability of 1/4
+    std::vector<std::vector<int>> cubes(256, std::vector<int>(20));
+    for (std::vector<int>& cube : cubes) {
+        for (int& value : cube) value = generator() % 4 == 0 ? -1 : int(generator() % 2);
+    }
+
+    // Expected value of an output: the value common to all the ways of replacing the X inputs, X otherwise
+    auto exact = [](size_t output, const std::vector<int>& cube) {
+        std::vector<size_t> unknowns;
+        for (size_t i = 0; i < cube.size(); ++i) {
+            if (cube[i] == -1) unknowns.push_back(i);
+        }
+        // A disabled $_TBUF_ is in high impedance
+        if (output == 19 && cube[1] != 1) return -1;
+
+        int value = -2;
+        for (size_t fill = 0; fill < (size_t(1) << unknowns.size()); ++fill) {
+            std::vector<bool> x(cube.begin(), cube.end());
+            for (size_t i = 0; i < unknowns.size(); ++i) x[unknowns[i]] = (fill >> i) & 1;
+            const int filled_value = expected(output, x);
+            if (value != -2 && value != filled_value) return -1;
+            value = filled_value;
+        }
+        return value;
+    };
+
+    for (KernelType type : {KernelType::Generic, KernelType::AVX2, KernelType::AVX512}) {
+        if (!SimulationKernel::isSupported(type)) continue;
+
+        ThreeValuedSimulator simulator(circuit, type);
+        for (size_t first = 0; first < cubes.size(); first += simulator.getBlockSize()) {
+            simulator.clearInputs();
+            for (size_t cube = first; cube < std::min(cubes.size(), first + simulator.getBlockSize()); ++cube) {
+                for (size_t i = 0; i < 20; ++i) {
+                    simulator.setInputValue(find(*circuit, circuit->inputs, "x[" + std::to_string(i) + "]"), cube - first, cubes[cube][i]);
+                }
+            }
+            simulator.simulate();
+
+            for (size_t cube = first; cube < std::min(cubes.size(), first + simulator.getBlockSize()); ++cube) {
+                for (size_t output = 0; output <= 20; ++output) {
+                    const uint32_t gate = circuit->outputs[find(*circuit, circuit->outputs, "y[" + std::to_string(output) + "]")];
+                    ASSERT_EQ(simulator.getValue(gate, cube - first), exact(output, cubes[cube])) << simulator.getKernelName() << ", output " << output << ", cube " << cube;
+                }
+            }
+        }
+    }
+}
+
+// Test fixture for the three-valued fault detection of a cube, which must hold for all the ways of replacing its X inputs
+TEST(Simulator, ThreeValuedFaultTest) {
+
+    for (const std::string& netlist : {c17Netlist, cellsNetlist}) {
+        std::shared_ptr<const CompiledCircuit> circuit = compile(netlist);
+        std::mt19937_64 generator(11);
+
+        // More faults than the faulty circuits of a block
+        std::vector<StuckAtFault> faults;
+        for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+            faults.push_back({gate, false});
+            faults.push_back({gate, true});
+        }
+
+        ThreeValuedSimulator simulator(circuit, KernelType::Generic);
+        FaultSimulator fault_simulator(circuit, KernelType::Generic);
+        size_t detected_with_unknowns = 0;
+        for (size_t trial = 0; trial < 50; ++trial) {
+            // A cube with at most 6 X inputs, the first trial having none
+            std::vector<int> cube(circuit->inputs.size());
+            std::vector<size_t> unknowns;
+            for (size_t i = 0; i < cube.size(); ++i) {
+                cube[i] = int(generator() % 2);
+                if (trial > 0 && unknowns.size() < 6 && generator() % 4 == 0) {
+                    cube[i] = -1;
+                    unknowns.push_back(i);
+                }
+            }
+            std::vector<bool> detected;
+            simulator.detect(cube, faults, detected);
+
+            // The faults detected by all the fills of the cube
+            std::vector<bool> always_detected(faults.size(), true);
+            for (size_t fill = 0; fill < (size_t(1) << unknowns.size()); ++fill) {
+                std::vector<uint64_t> pattern(cube.size());
+                for (size_t i = 0; i < cube.size(); ++i) pattern[i] = cube[i] == 1;
+                for (size_t k = 0; k < unknowns.size(); ++k) pattern[unknowns[k]] = (fill >> k) & 1;
+                std::vector<long> first_detection(faults.size(), -1);
+                fault_simulator.simulateBlock(pattern.data(), 1, faults, first_detection, 0);
+                for (size_t i = 0; i < faults.size(); ++i) {
+                    always_detected[i] = always_detected[i] && first_detection[i] >= 0;
+                }
+            }
+
+            for (size_t i = 0; i < faults.size(); ++i) {
+                // Exact for a binary cube, pessimistic otherwise
+                if (unknowns.empty()) {
+                    ASSERT_EQ(detected[i], always_detected[i]) << "trial " << trial << ", fault " << i;
+                } else {
+                    ASSERT_TRUE(!detected[i] || always_detected[i]) << "trial " << trial << ", fault " << i;
+                    detected_with_unknowns += detected[i];
+                }
+            }
+        }
+        ASSERT_GT(detected_with_unknowns, 0);
+    }
+}
+
+// Test fixture for the event-driven simulation, which must give the same values as a full simulation
+TEST(Simulator, EventTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+    std::mt19937_64 generator(3);
+
+    for (KernelType type : {KernelType::Generic, KernelType::AVX2, KernelType::AVX512}) {
+        if (!SimulationKernel::isSupported(type)) continue;
+
+        LogicSimulator incremental(circuit, type);
+        LogicSimulator full(circuit, type);
+        const size_t words = incremental.getBlockWords();
+        std::vector<uint64_t> patterns = randomPatterns(circuit->inputs.size(), words);
+        incremental.simulate(patterns.data());
+
+        // A few inputs changed at each step
+        for (size_t step = 0; step < 50; ++step) {
+            for (size_t change = 0; change < 3; ++change) {
+                const size_t input = generator() % circuit->inputs.size();
+                for (size_t word = 0; word < words; ++word) patterns[input * words + word] ^= generator();
+                incremental.setInput(input, patterns.data() + input * words);
+            }
+            incremental.update();
+            full.simulate(patterns.data());
+
+            for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+                for (size_t word = 0; word < words; ++word) {
+                    ASSERT_EQ(incremental.getValue(gate)[word], full.getValue(gate)[word]) << incremental.getKernelName() << ", gate " << gate << ", step " << step;
+                }
+            }
+        }
+
+        // x[19] only drives the $_MUX16_ and its output
+        const size_t input = find(*circuit, circuit->inputs, "x[19]");
+        for (size_t word = 0; word < words; ++word) patterns[input * words + word] = ~patterns[input * words + word];
+        incremental.setInput(input, patterns.data() + input * words);
+        ASSERT_LE(incremental.update(), 2);
+
+        // Nothing to evaluate without a change
+        incremental.setInput(input, patterns.data() + input * words);
+        ASSERT_EQ(incremental.update(), 0);
+    }
+}
+
+// Test fixture for the deductive, concurrent and critical path tracing engines, which must detect the faults with the same patterns as PPSFP
+TEST(Simulator, EngineTest) {
+
+    for (const std::string& netlist : {c17Netlist, cellsNetlist}) {
+        std::shared_ptr<const CompiledCircuit> circuit = compile(netlist);
+        const size_t pattern_count = 200;
+
+        // Each fault appears twice, as in the fault list of the tree where several nodes share a gate
+        std::vector<StuckAtFault> faults;
+        for (int copy = 0; copy < 2; ++copy) {
+            for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+                faults.push_back({gate, false});
+                faults.push_back({gate, true});
+            }
+        }
+
+        // First detections of all the faults with an engine, the last block being incomplete
+        auto run = [&](FaultSimulationEngine engine) {
+            FaultSimulator simulator(circuit, KernelType::Generic, engine);
+            std::vector<uint64_t> all_patterns = randomPatterns(circuit->inputs.size(), (pattern_count + 63) / 64);
+            std::vector<long> first_detection(faults.size(), -1);
+            for (size_t first = 0; first < pattern_count; first += 64) {
+                std::vector<uint64_t> patterns(circuit->inputs.size());
+                for (size_t i = 0; i < circuit->inputs.size(); ++i) patterns[i] = all_patterns[i * ((pattern_count + 63) / 64) + first / 64];
+                simulator.simulateBlock(patterns.data(), std::min<size_t>(64, pattern_count - first), faults, first_detection, first);
+            }
+            return first_detection;
+        };
+
+        std::vector<long> ppsfp_detection = run(FaultSimulationEngine::PPSFP);
+        ASSERT_EQ(run(FaultSimulationEngine::Deductive), ppsfp_detection);
+        ASSERT_EQ(run(FaultSimulationEngine::Concurrent), ppsfp_detection);
+        ASSERT_EQ(run(FaultSimulationEngine::CriticalPathTracing), ppsfp_detection);
+        ASSERT_NE(std::count(ppsfp_detection.begin(), ppsfp_detection.end(), -1), faults.size());
+    }
+
+    FaultSimulationEngine engine;
+    ASSERT_TRUE(FaultSimulator::getEngine("deductive", engine));
+    ASSERT_EQ(engine, FaultSimulationEngine::Deductive);
+    ASSERT_TRUE(FaultSimulator::getEngine("concurrent", engine));
+    ASSERT_EQ(engine, FaultSimulationEngine::Concurrent);
+    ASSERT_TRUE(FaultSimulator::getEngine("cpt", engine));
+    ASSERT_EQ(engine, FaultSimulationEngine::CriticalPathTracing);
+    ASSERT_FALSE(FaultSimulator::getEngine("serial", engine));
+}
+
+// Test fixture for the multi-threaded PPSFP engine, which must give the same detections as a single thread
+TEST(Simulator, ThreadTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+
+    // Every fault twice, so that the chunks of faults of the workers cover the whole circuit
+    std::vector<StuckAtFault> faults;
+    for (size_t copy = 0; copy < 2; ++copy) {
+        for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+            faults.push_back({gate, false});
+            faults.push_back({gate, true});
+        }
+    }
+
+    auto run = [&](size_t thread_count) {
+        FaultSimulator simulator(circuit, KernelType::Generic, FaultSimulationEngine::PPSFP, thread_count);
+        EXPECT_EQ(simulator.getThreadCount(), thread_count);
+        std::vector<uint64_t> all_patterns = randomPatterns(circuit->inputs.size(), 8);
+        std::vector<long> first_detection(faults.size(), -1);
+        size_t detected = 0;
+        for (size_t block = 0; block < 8; ++block) {
+            std::vector<uint64_t> patterns(circuit->inputs.size());
+            for (size_t i = 0; i < circuit->inputs.size(); ++i) patterns[i] = all_patterns[i * 8 + block];
+            detected += simulator.simulateBlock(patterns.data(), 64, faults, first_detection, block * 64);
+        }
+        EXPECT_EQ(detected, faults.size() - std::count(first_detection.begin(), first_detection.end(), -1));
+        return first_detection;
+    };
+
+    ASSERT_EQ(run(4), run(1));
+}
+
+// Test fixture for the compiled-code kernel, which must give the same values as the portable one
+TEST(Simulator, CompiledCodeTest) {
+
+    if (!SimulationKernel::isSupported(KernelType::Compiled)) GTEST_SKIP();
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+    std::vector<uint64_t> patterns = randomPatterns(circuit->inputs.size(), 1);
+
+    // The code is built in a cache of its own, whose path must be quoted for the shell
+    const std::string cache = testing::TempDir() + "atpgk_cache_'" + std::to_string(getpid());
+    setenv("ATPGK_CACHE_DIR", cache.c_str(), 1);
+    // A unit per function at most
+    std::vector<std::string> units = CompiledCode::generate(*circuit, 4);
+    ASSERT_EQ(units.size(), 1);
+    ASSERT_NE(units[0].find("atpgk_simulate"), std::string::npos);
+
+    LogicSimulator generic(circuit, KernelType::Generic);
+    generic.simulate(patterns.data());
+    for (size_t run = 0; run < 2; ++run) {
+        LogicSimulator compiled(circuit, KernelType::Compiled);
+        ASSERT_EQ(compiled.getKernelName(), "compiled");
+        compiled.simulate(patterns.data());
+        for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+            ASSERT_EQ(*compiled.getValue(gate), *generic.getValue(gate)) << "gate " << gate;
+        }
+    }
+    // The second kernel was loaded from the cache
+    const CompiledCode cached(*circuit);
+    ASSERT_TRUE(cached.isCached());
+
+    // Another compiler command builds another shared object
+    const bool compiler_set = std::getenv("CXX") != nullptr;
+    const std::string compiler = compiler_set ? std::getenv("CXX") : "c++";
+    setenv("CXX", (compiler + " -DATPGK_TEST").c_str(), 1);
+    CompiledCode other(*circuit);
+    ASSERT_FALSE(other.isCached());
+    ASSERT_NE(other.getLibraryPath(), cached.getLibraryPath());
+    if (compiler_set) {
+        setenv("CXX", compiler.c_str(), 1);
+    } else {
+        unsetenv("CXX");
+    }
+
+    std::filesystem::remove_all(cache);
+    unsetenv("ATPGK_CACHE_DIR");
+}
+
+// Test fixture for the random pattern phase, whose kept patterns must detect the faults as the whole random sequence does
+TEST(Simulator, RandomPhaseTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+
+    std::vector<StuckAtFault> faults;
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        faults.push_back({gate, false});
+        faults.push_back({gate, true});
+    }
+
+    for (PatternSource source : {PatternSource::Random, PatternSource::LFSR}) {
+        RandomPatternPhase phase(circuit, KernelType::Generic, source, 4096, 0.0);
+        std::vector<long> first_detection(faults.size(), -1);
+        const size_t detected = phase.run(faults, first_detection);
+        ASSERT_EQ(detected, faults.size() - std::count(first_detection.begin(), first_detection.end(), -1));
+        ASSERT_GT(detected, faults.size() / 2);
+        ASSERT_LE(phase.getPatternCount(), detected);
+
+        // The kept patterns are in the order of the random sequence, so they give the same first detections
+        FaultSimulator simulator(circuit, KernelType::Generic);
+        std::vector<long> kept_detection(faults.size(), -1);
+        for (size_t first = 0; first < phase.getPatternCount(); first += 64) {
+            const size_t pattern_count = std::min<size_t>(64, phase.getPatternCount() - first);
+            std::vector<uint64_t> patterns(circuit->inputs.size(), 0);
+            for (size_t bit = 0; bit < pattern_count; ++bit) {
+                for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+                    patterns[input] |= uint64_t(phase.getInput(first + bit, input)) << bit;
+                }
+            }
+            simulator.simulateBlock(patterns.data(), pattern_count, faults, kept_detection, first);
+            for (size_t bit = 0; bit < pattern_count; ++bit) {
+                for (size_t output = 0; output < circuit->outputs.size(); ++output) {
+                    const bool value = (simulator.getLogicSimulator().getValue(circuit->outputs[output])[0] >> bit) & 1;
+                    ASSERT_EQ(phase.getOutput(first + bit, output), value);
+                }
+            }
+        }
+        ASSERT_EQ(kept_detection, first_detection);
+    }
+
+    // A block detecting less than the minimum gain ends the phase
+    RandomPatternPhase phase(circuit, KernelType::Generic, PatternSource::LFSR, 4096, 100.0);
+    std::vector<long> first_detection(faults.size(), -1);
+    phase.run(faults, first_detection);
+    ASSERT_EQ(phase.getSimulatedCount(), 64);
+
+    // The same seed gives the same patterns
+    RandomPatternGenerator generator1(PatternSource::LFSR, 7), generator2(PatternSource::LFSR, 7);
+    std::vector<uint64_t> patterns1(3 * 2), patterns2(3 * 2);
+    generator1.generate(patterns1.data(), 3, 2);
+    generator2.generate(patterns2.data(), 3, 2);
+    ASSERT_EQ(patterns1, patterns2);
+    ASSERT_NE(std::count(patterns1.begin(), patterns1.end(), 0), patterns1.size());
+
+    PatternSource source;
+    ASSERT_TRUE(RandomPatternGenerator::getSource("lfsr", source));
+    ASSERT_EQ(source, PatternSource::LFSR);
+    ASSERT_FALSE(RandomPatternGenerator::getSource("none", source));
+}
+
+// Test fixture for the random pattern phase with the wide kernels, which must keep the patterns and give the detections of the portable kernel
+TEST(Simulator, RandomPhaseKernelTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(cellsNetlist);
+
+    std::vector<StuckAtFault> faults;
+    for (uint32_t gate = 0; gate < circuit->getGateCount(); ++gate) {
+        faults.push_back({gate, false});
+        faults.push_back({gate, true});
+    }
+
+    for (PatternSource source : {PatternSource::Random, PatternSource::LFSR}) {
+        // Without a minimum gain, and with one ending the phase in the middle of a wide block
+        for (double min_gain : {0.0, 0.5, 2.0}) {
+            RandomPatternPhase generic(circuit, KernelType::Generic, source, 1000, min_gain);
+            std::vector<long> generic_detection(faults.size(), -1);
+            const size_t generic_detected = generic.run(faults, generic_detection);
+
+            for (KernelType type : {KernelType::AVX2, KernelType::AVX512}) {
+                if (!SimulationKernel::isSupported(type)) continue;
+                RandomPatternPhase phase(circuit, type, source, 1000, min_gain);
+                std::vector<long> first_detection(faults.size(), -1);
+                ASSERT_EQ(phase.run(faults, first_detection), generic_detected);
+                ASSERT_EQ(first_detection, generic_detection);
+                ASSERT_EQ(phase.getSimulatedCount(), generic.getSimulatedCount());
+                ASSERT_EQ(phase.getPatternCount(), generic.getPatternCount());
+                for (size_t pattern = 0; pattern < phase.getPatternCount(); ++pattern) {
+                    for (size_t input = 0; input < circuit->inputs.size(); ++input) {
+                        ASSERT_EQ(phase.getInput(pattern, input), generic.getInput(pattern, input));
+                    }
+                    for (size_t output = 0; output < circuit->outputs.size(); ++output) {
+                        ASSERT_EQ(phase.getOutput(pattern, output), generic.getOutput(pattern, output));
+                    }
+                }
+            }
+        }
+    }
+
+    // The same seed gives the same patterns, whatever the number of words per block
+    RandomPatternGenerator generator1(PatternSource::Random, 7), generator2(PatternSource::Random, 7);
+    std::vector<uint64_t> patterns1(3 * 8), patterns2(3 * 1);
+    generator1.generate(patterns1.data(), 3, 8);
+    for (size_t word = 0; word < 8; ++word) {
+        generator2.generate(patterns2.data(), 3, 1);
+        for (size_t input = 0; input < 3; ++input) {
+            ASSERT_EQ(patterns1[input * 8 + word], patterns2[input]);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#include <vector>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/tree/Testability.hpp"
+
+// Test fixture for the SCOAP measures of ISCAS-85 c17, computed by hand
+TEST(Testability, C17Test) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(c17Netlist);
+
+    Testability testability(circuit);
+
+    // name, CC0, CC1, CO
+    const std::vector<std::tuple<std::string, uint32_t, uint32_t, uint32_t>> expected = {
+        {"N1", 1, 1, 5}, {"N2", 1, 1, 6}, {"N3", 1, 1, 5}, {"N6", 1, 1, 7}, {"N7", 1, 1, 6},
+        {"g1", 3, 2, 3}, {"g2", 3, 2, 5}, {"g3", 4, 2, 3}, {"g4", 4, 2, 3}, {"g5", 5, 4, 0}, {"g6", 5, 5, 0}
+    };
+    for (const auto& measures : expected) {
+        const uint32_t gate = getGate(*circuit, std::get<0>(measures));
+        ASSERT_LT(gate, circuit->getGateCount()) << std::get<0>(measures);
+        EXPECT_EQ(testability.getControllability(gate, false), std::get<1>(measures)) << std::get<0>(measures);
+        EXPECT_EQ(testability.getControllability(gate, true), std::get<2>(measures)) << std::get<0>(measures);
+        EXPECT_EQ(testability.getObservability(gate), std::get<3>(measures)) << std::get<0>(measures);
+    }
+
+    // N11 is observed through N16 (CC1(N2) = 1 to sensitize g3) and through N19 (CC1(N7) = 1 to sensitize g4)
+    const uint32_t g3 = getGate(*circuit, "g3");
+    ASSERT_EQ(testability.getInputObservability(g3, 1), 5);
+    // A stuck-at 0 on N16 needs a 1 (CC1 = 2) and its observation (CO = 3)
+    ASSERT_EQ(testability.getDetectionCost(g3, true), 5);
+}
+
+// Test fixture for the cells whose measures come from the enumeration of their cubes
+TEST(Testability, CellTest) {
+
+    std::shared_ptr<const CompiledCircuit> circuit = compile(R"(
+    module cells (input a, b, c, output y, z);
+      wire w;
+      xor g1 (w, a, b);
+      or g2 (y, w, c);
+      not g3 (z, a);
+    endmodule
+    )");
+
+    Testability testability(circuit);
+
+    // XOR: a 0 needs two equal inputs, a 1 two different ones
+    const uint32_t g1 = getGate(*circuit, "g1");
+    ASSERT_EQ(testability.getControllability(g1, false), 3);
+    ASSERT_EQ(testability.getControllability(g1, true), 3);
+    // OR: a 0 needs both inputs at 0, a 1 only one of them, and w is observed when c is 0
+    const uint32_t g2 = getGate(*circuit, "g2");
+    ASSERT_EQ(testability.getControllability(g2, false), 5);
+    ASSERT_EQ(testability.getControllability(g2, true), 2);
+    ASSERT_EQ(testability.getObservability(g1), 2);
+    // a is observed at best through the inverter
+    ASSERT_EQ(testability.getObservability(getGate(*circuit, "a")), 1);
+}
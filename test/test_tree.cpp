@@ -0,0 +1,108 @@
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_set>
+
+#include <gtest/gtest.h>
+
+#include "test_utils.hpp"
+#include "../include/tree/Tree.hpp"
+
+// Node of the tree with a netlist name, nullptr if there is none
+static std::shared_ptr<Node> getNode(const Tree& tree, const std::string& name) {
+    for (const std::shared_ptr<Node>& node : tree.NodeList) {
+        if (node->netlistName == name) return node;
+    }
+    return nullptr;
+}
+
+// Check that each node comes after all its parents, and that the levels match LevelList
+static void checkOrder(const Tree& tree) {
+    std::unordered_set<Node*> ordered;
+    for (const std::shared_ptr<Node>& node : tree.OrderedNodeList) {
+        int level = 0;
+        for (const auto& parent : node->parents) {
+            ASSERT_TRUE(ordered.count(parent.first.get()));
+            level = std::max(level, parent.first->level + 1);
+        }
+        ASSERT_EQ(node->level, level);
+        ordered.insert(node.get());
+    }
+
+    size_t count = 0;
+    for (size_t level = 0; level < tree.LevelList.size(); ++level) {
+        ASSERT_FALSE(tree.LevelList[level].empty());
+        for (const std::shared_ptr<Node>& node : tree.LevelList[level]) {
+            ASSERT_EQ(node->level, static_cast<int>(level));
+        }
+        count += tree.LevelList[level].size();
+    }
+    ASSERT_EQ(count, tree.OrderedNodeList.size());
+}
+
+// Test fixture for the levels of the reconvergent paths
+TEST(Tree, LevelizeTest) {
+
+    std::shared_ptr<Tree> tree = buildTree(c17Netlist);
+    ASSERT_TRUE(tree->levelize());
+    ASSERT_EQ(tree->OrderedNodeList.size(), tree->NodeList.size());
+    checkOrder(*tree);
+
+    // g5 is reached from N1 in 2 levels and from N3 in 3 levels, through g2 and g3
+    ASSERT_EQ(getNode(*tree, "g1")->level, 1);
+    ASSERT_EQ(getNode(*tree, "g3")->level, 2);
+    ASSERT_EQ(getNode(*tree, "g5")->level, 3);
+    ASSERT_EQ(getNode(*tree, "g6")->level, 3);
+    ASSERT_EQ(tree->LevelList.size(), 5);
+    ASSERT_EQ(tree->LevelList[0].size(), 5);
+    ASSERT_EQ(tree->LevelList[4].size(), 2);
+}
+
+// Test fixture for the levels of a deep chain, levelized without recursion
+TEST(Tree, DeepChainTest) {
+
+    const size_t depth = 20000;
+    std::string netlist = "module chain (input a, output y);\n";
+    for (size_t gate = 0; gate < depth; ++gate) {
+        netlist += "  wire n" + std::to_string(gate) + ";\n";
+    }
+    netlist += "  buf b0 (n0, a);\n";
+    for (size_t gate = 1; gate < depth; ++gate) {
+        netlist += "  not g" + std::to_string(gate) + " (n" + std::to_string(gate) + ", n" + std::to_string(gate - 1) + ");\n";
+    }
+    netlist += "  buf b1 (y, n" + std::to_string(depth - 1) + ");\nendmodule\n";
+
+    std::shared_ptr<Tree> tree = buildTree(netlist);
+    ASSERT_TRUE(tree->levelize());
+    checkOrder(*tree);
+
+    // The input, the chain, the last buffer and the output
+    ASSERT_EQ(tree->LevelList.size(), depth + 3);
+    ASSERT_EQ(getNode(*tree, "g" + std::to_string(depth - 1))->level, static_cast<int>(depth));
+}
+
+// Test fixture for the rejection of the combinational loops
+TEST(Tree, LoopTest) {
+
+    // A latch of two NANDs: p and q depend on each other
+    std::shared_ptr<Tree> tree = buildTree(R"(
+    module latch (input s, r, c, output y, z);
+      wire p, q;
+      nand g1 (p, s, q);
+      nand g2 (q, r, p);
+      and g3 (y, p, c);
+      not g4 (z, c);
+    endmodule
+    )");
+    ASSERT_FALSE(tree->levelize());
+
+    // The nodes of the loop and the nodes they reach are left out of the order, the others are levelized
+    checkOrder(*tree);
+    std::unordered_set<Node*> ordered;
+    for (const std::shared_ptr<Node>& node : tree->OrderedNodeList) ordered.insert(node.get());
+    for (const std::string name : {"g1", "g2", "g3"}) {
+        ASSERT_FALSE(ordered.count(getNode(*tree, name).get()));
+    }
+    ASSERT_TRUE(ordered.count(getNode(*tree, "g4").get()));
+    ASSERT_EQ(getNode(*tree, "g4")->level, 1);
+}
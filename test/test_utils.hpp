@@ -0,0 +1,70 @@
+// Helpers and netlists shared by the tests
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "../include/parser/verilog_parser.hpp"
+#include "../include/builder_API/builder_API.hpp"
+#include "../include/tree/CompiledCircuit.hpp"
+
+// Build the levelized circuit model tree of a parsed netlist, as the Reader does
+inline std::shared_ptr<Tree> buildTree(const ParsedCircuit& netlist) {
+
+    std::shared_ptr<Tree> tree = std::make_shared<Tree>("tree");
+    for (const auto& gate : netlist.full_gate_vector) {
+        BuilderAPI::createAndAddNodeToTree(tree, gate.second.id, gate.second.name, gate.second.netlistName);
+    }
+    for (const auto& assoc : netlist.direct_port_pair_mapping) {
+        BuilderAPI::bind_cell(std::get<0>(assoc), std::get<1>(assoc), std::get<3>(assoc), tree);
+    }
+    tree->levelize();
+
+    return tree;
+}
+
+// Build the levelized circuit model tree of a netlist, as the Reader does
+inline std::shared_ptr<Tree> buildTree(const std::string& fileString) {
+
+    json strings;
+
+    VerilogParser parser(strings);
+    parser.setInputFileContent(fileString);
+
+    return buildTree(parser.parseCircuit());
+}
+
+// Compile a netlist into the flat view of its circuit model tree
+inline std::shared_ptr<const CompiledCircuit> compile(const std::string& fileString) {
+    return std::make_shared<const CompiledCircuit>(buildTree(fileString));
+}
+
+// Index of the gate with a netlist name, the gate count if there is none
+inline uint32_t getGate(const CompiledCircuit& circuit, const std::string& name) {
+    for (uint32_t gate = 0; gate < circuit.getGateCount(); ++gate) {
+        if (circuit.nodes[gate]->netlistName == name) return gate;
+    }
+    return circuit.getGateCount();
+}
+
+// Position of the gate of a net in a list of gate indexes
+inline uint32_t find(const CompiledCircuit& circuit, const std::vector<uint32_t>& gates, const std::string& name) {
+    for (uint32_t i = 0; i < gates.size(); ++i) {
+        if (circuit.nodes[gates[i]]->netlistName == name) return i;
+    }
+    return gates.size();
+}
+
+// ISCAS-85 c17, with reconvergent fanouts
+inline const std::string c17Netlist = R"(
+module c17 (input N1, N2, N3, N6, N7, output N22, N23);
+  wire N10, N11, N16, N19;
+  nand g1 (N10, N1, N3);
+  nand g2 (N11, N3, N6);
+  nand g3 (N16, N2, N11);
+  nand g4 (N19, N11, N7);
+  nand g5 (N22, N10, N16);
+  nand g6 (N23, N16, N19);
+endmodule
+)";
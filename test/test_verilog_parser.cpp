@@ -0,0 +1,178 @@
+#include <vector>
+#include <map>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+#include "../include/parser/verilog_parser.hpp"
+
+// Test fixture for parsing a netlist written by Yosys 'write_verilog -noattr'
+TEST(VerilogParser, ParsingTest) {
+
+    json strings;
+
+    std::string fileString = R"(
+    /* Generated by Yosys */
+    module comb(a, b, c);
+      input a;
+      wire a;
+      input b;
+      wire b;
+      output c;
+      wire c;
+      wire _0_;
+      \$_AND_  _1_ (
+        .A(b),
+        .B(a),
+        .Y(_0_)
+      );
+      assign c = _0_;
+    endmodule
+    )";
+
+    std::vector<uint> expected_input_vector = {2,3};
+    std::vector<uint> expected_output_vector = {5};
+
+    VerilogParser parser(strings);
+    parser.setInputFileContent(fileString);
+
+    ParsedCircuit netlist = parser.parseCircuit();
+
+    ASSERT_EQ(netlist.input_vector, expected_input_vector);
+    ASSERT_EQ(netlist.output_vector, expected_output_vector);
+    ASSERT_EQ(netlist.binary_gate_vector.size(), 1);
+    ASSERT_EQ(netlist.full_gate_vector.size(), 4);
+    // a -> AND, b -> AND, AND -> c
+    ASSERT_EQ(netlist.direct_port_pair_mapping.size(), 3);
+}
+
+// Test fixture for primitives with more than two inputs
+TEST(VerilogParser, PrimitiveTest) {
+
+    json strings;
+
+    std::string fileString = R"(
+    module prim (input a, b, c, output [1:0] y);
+      nand g1 (y[0], a, b, c);
+      not (y[1], a);
+    endmodule
+    )";
+
+    VerilogParser parser(strings);
+    parser.setInputFileContent(fileString);
+
+    ParsedCircuit netlist = parser.parseCircuit();
+
+    ASSERT_EQ(netlist.input_vector.size(), 3);
+    ASSERT_EQ(netlist.output_vector.size(), 2);
+    // nand with three inputs is split into an $_AND_ and a $_NAND_
+    ASSERT_EQ(netlist.binary_gate_vector.size(), 2);
+    ASSERT_EQ(netlist.unary_gate_vector.size(), 1);
+}
+
+// Test fixture for behavioral code, which is not a gate-level netlist
+TEST(VerilogParser, BehavioralErrorTest) {
+
+    json strings;
+
+    std::string fileString = R"(
+    module comb (input a, b, output c);
+      assign c = a & b;
+    endmodule
+    )";
+
+    VerilogParser parser(strings);
+    parser.setInputFileContent(fileString);
+
+    ASSERT_EXIT(
+        parser.parseCircuit(),
+        testing::ExitedWithCode(1),
+        ""
+    );
+}
+
+// Test fixture for hierarchical netlists with vector ports
+TEST(VerilogParser, HierarchyTest) {
+
+    json strings;
+
+    std::string fileString = R"(
+    module inv2 (input [1:0] a, output [1:0] y);
+      not (y[0], a[0]);
+      not (y[1], a[1]);
+    endmodule
+
+    module top (input [1:0] i, output [1:0] o);
+      wire [1:0] w;
+      inv2 u1 (.a(i), .y(w));
+      inv2 u2 (.a(w), .y(o));
+    endmodule
+    )";
+
+    VerilogParser parser(strings);
+    parser.setInputFileContent(fileString);
+
+    ParsedCircuit netlist = parser.parseCircuit();
+
+    ASSERT_EQ(netlist.input_vector.size(), 2);
+    ASSERT_EQ(netlist.output_vector.size(), 2);
+    ASSERT_EQ(netlist.instance_vector.size(), 2);
+    ASSERT_EQ(netlist.unary_gate_vector.size(), 4);
+    // i -> u1, u1 -> u2 and u2 -> o for each bit
+    ASSERT_EQ(netlist.direct_port_pair_mapping.size(), 6);
+
+    // Both instances refer to the same model of inv2
+    ASSERT_EQ(netlist.module_models.size(), 2);
+    ASSERT_EQ(netlist.instance_vector[0].second, netlist.module_models.at("inv2"));
+    ASSERT_EQ(netlist.instance_vector[1].second, netlist.module_models.at("inv2"));
+    ASSERT_EQ(netlist.module_models.at("inv2")->gate_count, 2);
+    ASSERT_EQ(netlist.module_models.at("top")->gate_count, 4);
+}
+
+// Test fixture for a net connected to several ports of the same cell
+TEST(VerilogParser, SharedNetTest) {
+
+    json strings;
+
+    std::string fileString = R"(
+    module shared (input a, output y);
+      and g1 (y, a, a);
+    endmodule
+    )";
+
+    VerilogParser parser(strings);
+    parser.setInputFileContent(fileString);
+
+    ParsedCircuit netlist = parser.parseCircuit();
+
+    // a -> AND port A, a -> AND port B, AND -> y (port A of the output)
+    ASSERT_EQ(netlist.direct_port_pair_mapping.size(), 3);
+    size_t port_b_count = 0;
+    for (const auto& assoc : netlist.direct_port_pair_mapping) {
+        if (std::get<3>(assoc) == "B") port_b_count++;
+    }
+    ASSERT_EQ(port_b_count, 1);
+}
+
+// Test fixture for malformed netlists, which must be rejected with an error instead of crashing or hanging
+TEST(VerilogParser, MalformedErrorTest) {
+
+    json strings;
+
+    const std::vector<std::string> fileStrings = {
+        "module comb (input [N-1:0] a, output y);\nendmodule\n",
+        "module comb (input [1:] a, output y);\nendmodule\n",
+        "module comb (input a, output y);\n  not #(1"
+    };
+
+    for (const std::string& fileString : fileStrings) {
+        VerilogParser parser(strings);
+        parser.setInputFileContent(fileString);
+
+        ASSERT_EXIT(
+            parser.parseCircuit(),
+            testing::ExitedWithCode(1),
+            ""
+        ) << fileString;
+    }
+}
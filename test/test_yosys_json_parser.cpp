@@ -238,4 +238,95 @@ TEST(YosysJSONParser, ParsingTest) {
     ASSERT_EQ(netlist.input_vector, expected_input_vector);
     ASSERT_EQ(netlist.output_vector, expected_output_vector);
     ASSERT_EQ(netlist.wire_vector, expected_wire_vector);
-}
\ No newline at end of file
+}
+// Test fixture for hierarchical netlists
+TEST(YosysJSONParser, HierarchyTest) {
+
+    json strings;
+
+    std::string fileString = R"(
+    {
+        "modules": {
+            "inv": {
+                "ports": {
+                    "a": {
+                        "direction": "input",
+                        "bits": [ 2 ]
+                    },
+                    "y": {
+                        "direction": "output",
+                        "bits": [ 3 ]
+                    }
+                },
+                "cells": {
+                    "NOT": {
+                        "type": "$_NOT_",
+                        "port_directions": {
+                            "A": "input",
+                            "Y": "output"
+                        },
+                        "connections": {
+                            "A": [ 2 ],
+                            "Y": [ 3 ]
+                        }
+                    }
+                },
+                "netnames": {
+                }
+            },
+            "top": {
+                "attributes": {
+                    "top": "00000000000000000000000000000001"
+                },
+                "ports": {
+                    "x": {
+                        "direction": "input",
+                        "bits": [ 2 ]
+                    },
+                    "z": {
+                        "direction": "output",
+                        "bits": [ 3 ]
+                    }
+                },
+                "cells": {
+                    "u1": {
+                        "type": "inv",
+                        "connections": {
+                            "a": [ 2 ],
+                            "y": [ 4 ]
+                        }
+                    },
+                    "u2": {
+                        "type": "inv",
+                        "connections": {
+                            "a": [ 4 ],
+                            "y": [ 3 ]
+                        }
+                    }
+                },
+                "netnames": {
+                    "w": {
+                        "bits": [ 4 ]
+                    }
+                }
+            }
+        }
+    })";
+
+    std::vector<uint> expected_input_vector = {2};
+    std::vector<uint> expected_output_vector = {3};
+
+    YosysJSONParser parser(strings);
+    parser.setInputFileContent(fileString);
+
+    ParsedCircuit netlist = parser.parseCircuit();
+
+    ASSERT_EQ(netlist.input_vector, expected_input_vector);
+    ASSERT_EQ(netlist.output_vector, expected_output_vector);
+    // The module is defined once and instanciated twice
+    ASSERT_EQ(netlist.module_definitions.size(), 2);
+    ASSERT_EQ(netlist.instance_vector.size(), 2);
+    ASSERT_EQ(netlist.unary_gate_vector.size(), 2);
+    // x -> u1.NOT -> u2.NOT -> z
+    ASSERT_EQ(netlist.direct_port_pair_mapping.size(), 3);
+}